@@ -6,6 +6,9 @@ in vec2 texcoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform sampler2DArray atlas;
+uniform float atlas_layer; // < 0 when the texture is not in the atlas
+uniform vec4 uv_bounds;
 uniform vec4 fill_color;
 uniform vec3 fcolor;
 
@@ -13,9 +16,18 @@ uniform vec3 fcolor;
 // Output color
 layout(location = 0) out  vec4 color;
 
+vec4 sample_sprite(vec2 uv)
+{
+	if (atlas_layer < 0.0) {
+		return texture(sampler0, uv);
+	}
+	vec2 half_texel = 0.5 / vec2(textureSize(atlas, 0).xy);
+	return texture(atlas, vec3(clamp(uv, uv_bounds.xy + half_texel, uv_bounds.zw - half_texel), atlas_layer));
+}
+
 void main()
 {
-	vec4 sampled_color = vec4(fcolor, 1.0) * texture(sampler0, vec2(texcoord.x, texcoord.y));
+	vec4 sampled_color = vec4(fcolor, 1.0) * sample_sprite(vec2(texcoord.x, texcoord.y));
 	
 	color = vec4(fill_color.rgb, sampled_color.a * fill_color.a);
 }
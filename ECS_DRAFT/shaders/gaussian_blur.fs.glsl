@@ -36,6 +36,28 @@ void main()
 			in_color.rgb += (sampled_color.a * sampled_color.rgb * weight);
 			in_color.a += (sampled_color.a * weight);
 		}
+	} else if (blur_mode == 3) {
+		// Dual filter downsample: centre plus four diagonal half-texel taps
+		vec2 half_texel = 0.5 * stride / tex_size;
+		vec2 offsets[5] = vec2[](vec2(0.0), vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+		float weights[5] = float[](0.5, 0.125, 0.125, 0.125, 0.125);
+		for (int i = 0; i < 5; i++) {
+			vec4 sampled_color = texture(screen_texture, texcoord + offsets[i] * half_texel);
+			in_color.rgb += (sampled_color.a * sampled_color.rgb * weights[i]);
+			in_color.a += (sampled_color.a * weights[i]);
+		}
+	} else if (blur_mode == 4) {
+		// Dual filter upsample: four edge taps and four diagonal taps (weighted twice)
+		vec2 half_texel = 0.5 * stride / tex_size;
+		vec2 offsets[8] = vec2[](
+			vec2(-2.0, 0.0), vec2(2.0, 0.0), vec2(0.0, -2.0), vec2(0.0, 2.0),
+			vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+		for (int i = 0; i < 8; i++) {
+			vec4 sampled_color = texture(screen_texture, texcoord + offsets[i] * half_texel);
+			float weight = (i < 4) ? (1.0 / 12.0) : (2.0 / 12.0);
+			in_color.rgb += (sampled_color.a * sampled_color.rgb * weight);
+			in_color.a += (sampled_color.a * weight);
+		}
 	} else {
 		// Vertical Blur
 		for (int j = -3; j <= 3; j++) {
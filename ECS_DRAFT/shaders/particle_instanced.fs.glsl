@@ -5,22 +5,12 @@ in vec2 texcoord;
 
 // (x, y, z, a)
 // if a > 0, xyza = rgba
-// if a < 0, [x, y] = tex_u_range, z = alpha, -a = texture_id
+// if a < 0, [x, y] = atlas u range, z = alpha, -a = particle id
 in vec4 color_info;
+flat in float atlas_layer;
 
-// Texture data:
-// Currently we are loading all data and switching to them based on texture id
-// It is an ugly table mapping method, but should be enough for the project
-uniform sampler2D texture1; // sample texture
-uniform sampler2D texture2; // Breakable platform fragments
-uniform sampler2D texture3; // Coyote particles
-uniform sampler2D texture4; // Screw fragments
-uniform sampler2D texture5; // Hex fragments
-uniform sampler2D texture6; // Radial Cracking
-uniform sampler2D texture7; // Downward Cracking
-uniform sampler2D texture8; // Exhale
-uniform sampler2D texture9; // Broken Parts
-uniform sampler2D texture10; // Cross Star
+// Every particle sprite sheet is packed into the shared texture atlas
+uniform sampler2DArray atlas;
 
 // Output color
 layout(location = 0) out  vec4 color;
@@ -32,44 +22,7 @@ void main()
         color = color_info;
     } else {
         float alpha = color_info.z;
-        int texture_id = int(-color_info.a);
-
-        switch (texture_id) {
-            case 1:
-                color = texture(texture1, texcoord);
-                break;
-            case 2:
-                color = texture(texture2, texcoord);
-                break;
-            case 3:
-                color = texture(texture3, texcoord);
-                break;
-            case 4:
-                color = texture(texture4, texcoord);
-                break;
-            case 5:
-                color = texture(texture5, texcoord);
-                break;
-            case 6:
-                color = texture(texture6, texcoord);
-                break;
-            case 7:
-                color = texture(texture7, texcoord);
-                break;
-            case 8:
-                color = texture(texture8, texcoord);
-                break;
-            case 9:
-                color = texture(texture9, texcoord);
-                break;
-            case 10:
-                color = texture(texture10, texcoord);
-                break;
-            default:
-                color = vec4(0.0, 0.0, 0.0, 1.0);
-                break;
-        }
-
+        color = texture(atlas, vec3(texcoord, atlas_layer));
         color.a = color.a * alpha;
     }
 }
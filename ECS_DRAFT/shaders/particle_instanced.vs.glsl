@@ -13,9 +13,13 @@ layout(location = 4) in vec2 scale;
 // if a < 0, [x, y] = tex_u_range, z = alpha, -a = texture_id
 layout(location = 5) in vec4 in_color_info;
 
+// atlas placement of textured particles: (v_min, v_max, layer, unused)
+layout(location = 6) in vec4 in_atlas_info;
+
 // Passed to fragment shader
 out vec2 texcoord;
 out vec4 color_info;
+flat out float atlas_layer;
 
 // Application data
 uniform mat3 projection;
@@ -25,7 +29,8 @@ void main()
 {
 	texcoord = vec2(
 			in_color_info.x + in_texcoord.x * (in_color_info.y - in_color_info.x),
-			in_texcoord.y);
+			in_atlas_info.x + in_texcoord.y * (in_atlas_info.y - in_atlas_info.x));
+	atlas_layer = in_atlas_info.z;
 
 
 	color_info = in_color_info;
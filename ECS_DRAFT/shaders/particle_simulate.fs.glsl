@@ -0,0 +1,9 @@
+#version 330
+
+// Never runs: the simulation pass draws with GL_RASTERIZER_DISCARD enabled
+layout(location = 0) out vec4 color;
+
+void main()
+{
+	color = vec4(0.0);
+}
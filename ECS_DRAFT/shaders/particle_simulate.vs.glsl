@@ -0,0 +1,143 @@
+#version 330
+
+// One particle per vertex; mirrors step_particle in particle_kernel.cpp and the instance setup
+// of RenderSystem::instancedRenderParticles. Captured through transform feedback, so the output
+// doubles as next frame's input and as the per-instance attributes of particle_instanced.
+
+// Particle state (GpuParticleState)
+layout(location = 0) in vec4 in_motion;		// position.xy, velocity.xy
+layout(location = 1) in vec4 in_spin;		// angle, angular velocity, scale.xy
+layout(location = 2) in vec4 in_lifetime;	// life, timer, alpha, velocity decay
+layout(location = 3) in vec4 in_envelope;	// fade in, fade out, shrink in, shrink out
+layout(location = 4) in vec4 in_influence;	// wind, gravity, turbulence, cull distance squared
+layout(location = 5) in vec4 in_animation;	// timer, limit, frame count, ms per frame
+layout(location = 6) in vec4 in_appearance;	// color.rgb, particle id
+
+out vec4 out_motion;
+out vec4 out_spin;
+out vec4 out_lifetime;
+out vec4 out_envelope;
+out vec4 out_influence;
+out vec4 out_animation;
+out vec4 out_appearance;
+
+// Instance attributes (ParticleInstancedNode)
+out vec2 global_pos;
+out float rotation;
+out vec2 scale;
+out vec4 color_info;
+out vec4 atlas_info;
+
+// Step parameters
+uniform float time_change_s;
+uniform float animation_elapsed_ms;
+uniform bool cull_by_camera;
+uniform vec2 camera_position;
+uniform vec2 wind_field;
+uniform vec2 gravity_field;
+
+// Turbulence flow field, one direction component per texture
+uniform bool turbulence_enabled;
+uniform float turbulence_strength;
+uniform float field_cells_per_pixel;
+uniform sampler2D field_x;
+uniform sampler2D field_y;
+
+// Per type row of atlas placements, two texels per frame: (u_min, u_max, layer, -), (v_min, v_max, -, -)
+uniform sampler2D frame_table;
+
+const float PI = 3.14159265359;
+
+void main()
+{
+	vec2 position = in_motion.xy;
+	vec2 velocity = in_motion.zw;
+	float angle = in_spin.x;
+	float life = in_lifetime.x;
+	float timer = in_lifetime.y + time_change_s * 1000.0;
+	float animation_timer = in_animation.x;
+
+	vec2 to_camera = position - camera_position;
+	float distance_sq = cull_by_camera ? dot(to_camera, to_camera) : 0.0;
+	// a negative life keeps a culled particle dead
+	bool dead = timer > life || distance_sq > in_influence.w;
+	if (dead) {
+		life = -1.0;
+	}
+	else {
+		// Update motion
+		position += time_change_s * velocity;
+		angle += time_change_s * in_spin.y;
+		angle -= 360.0 * floor(angle / 360.0);
+
+		if (abs(in_influence.x) > 1e-4) {
+			position += time_change_s * wind_field * in_influence.x;
+		}
+
+		if (abs(in_influence.y) > 1e-4) {
+			velocity += time_change_s * gravity_field * in_influence.y;
+		}
+
+		if (turbulence_enabled && abs(in_influence.z) > 1e-4) {
+			vec2 field_uv = (position * field_cells_per_pixel + 0.5) / vec2(textureSize(field_x, 0));
+			vec2 direction = vec2(texture(field_x, field_uv).r, texture(field_y, field_uv).r);
+			velocity += time_change_s * turbulence_strength * direction;
+		}
+
+		velocity *= in_lifetime.w;
+
+		float next_animation_timer = animation_timer + animation_elapsed_ms;
+		if (next_animation_timer <= in_animation.y) {
+			animation_timer = next_animation_timer;
+		}
+	}
+
+	out_motion = vec4(position, velocity);
+	out_spin = vec4(angle, in_spin.yzw);
+	out_lifetime = vec4(life, timer, in_lifetime.zw);
+	out_envelope = in_envelope;
+	out_influence = in_influence;
+	out_animation = vec4(animation_timer, in_animation.yzw);
+	out_appearance = in_appearance;
+
+	// Fade in/out
+	float fade_factor = 1.0;
+	if (in_envelope.x > 1e-4 && timer <= in_envelope.x) {
+		fade_factor = timer / in_envelope.x;
+	}
+	else if (in_envelope.y > 1e-4 && (life - timer) <= in_envelope.y) {
+		fade_factor = (life - timer) / in_envelope.y;
+	}
+
+	// Shrink in/out
+	float shrink_factor = 1.0;
+	if (in_envelope.z > 1e-4 && timer <= in_envelope.z) {
+		shrink_factor = timer / in_envelope.z;
+	}
+	else if (in_envelope.w > 1e-4 && (life - timer) <= in_envelope.w) {
+		shrink_factor = (life - timer) / in_envelope.w;
+	}
+
+	global_pos = position;
+	rotation = angle * PI / 180.0;
+	// dead particles stay in the buffer until their slot is reused; collapse them
+	scale = dead ? vec2(0.0) : in_spin.zw * shrink_factor;
+
+	// same curve as cubic_interpolation(0, alpha, fade_factor)
+	float alpha = in_lifetime.z * fade_factor * fade_factor * (3.0 - 2.0 * fade_factor);
+
+	int particle_id = int(in_appearance.w);
+	if (particle_id == 0) {
+		color_info = vec4(in_appearance.rgb, alpha);
+		atlas_info = vec4(0.0);
+	}
+	else {
+		// an unbounded limit marks a cycling clip
+		int frame = int(animation_timer / in_animation.w);
+		frame = isinf(in_animation.y) ? frame % int(in_animation.z) : min(frame, int(in_animation.z) - 1);
+		vec4 u_info = texelFetch(frame_table, ivec2(2 * frame, particle_id), 0);
+		vec4 v_info = texelFetch(frame_table, ivec2(2 * frame + 1, particle_id), 0);
+		color_info = vec4(u_info.xy, alpha, -float(particle_id));
+		atlas_info = vec4(v_info.xy, u_info.z, 0.0);
+	}
+}
@@ -6,6 +6,9 @@ in vec2 texcoord;
 
 // Application data
 uniform sampler2D sampler0;
+uniform sampler2DArray atlas;
+uniform float atlas_layer; // < 0 when the texture is not in the atlas
+uniform vec4 uv_bounds;
 uniform vec3 fcolor;
 
 uniform vec4 silhouette_color;
@@ -14,22 +17,32 @@ uniform vec4 silhouette_color;
 // Output color
 layout(location = 0) out  vec4 color;
 
+vec4 sample_sprite(vec2 uv)
+{
+	if (atlas_layer < 0.0) {
+		return texture(sampler0, uv);
+	}
+	// stay inside the packed region so neighbours never bleed in
+	vec2 half_texel = 0.5 / vec2(textureSize(atlas, 0).xy);
+	return texture(atlas, vec3(clamp(uv, uv_bounds.xy + half_texel, uv_bounds.zw - half_texel), atlas_layer));
+}
+
 void main()
 {
-	vec4 sampled_color = vec4(fcolor, 1.0) * texture(sampler0, vec2(texcoord.x, texcoord.y));
+	vec4 sampled_color = vec4(fcolor, 1.0) * sample_sprite(vec2(texcoord.x, texcoord.y));
 	color = sampled_color;
 
 
 	if (silhouette_color.a > 0.0) {
 		// number of pixels
 		float thickness = 0.5;
-		vec2 texture_scale = textureSize(sampler0, 0);
+		vec2 texture_scale = (atlas_layer < 0.0) ? vec2(textureSize(sampler0, 0)) : vec2(textureSize(atlas, 0).xy);
 
 		// Test Boundary: if this pixel opaque & close to transparent pixel
 		if (sampled_color.a > 0.95) {
 			float dist_to_edge = min(
-				min(texcoord.x, 1.0 - texcoord.x) * texture_scale.x, 
-				min(texcoord.y, 1.0 - texcoord.y) * texture_scale.y
+				min(texcoord.x - uv_bounds.x, uv_bounds.z - texcoord.x) * texture_scale.x, 
+				min(texcoord.y - uv_bounds.y, uv_bounds.w - texcoord.y) * texture_scale.y
 			);
 
 			if (dist_to_edge <= thickness) {
@@ -41,7 +54,7 @@ void main()
 						if (i == 0 && j == 0) {
 							continue;
 						}
-						vec4 neighbor_color = texture(sampler0, 
+						vec4 neighbor_color = sample_sprite(
 							vec2(texcoord.x + i * thickness / texture_scale.x, texcoord.y + j * thickness / texture_scale.y));
 
 						if (neighbor_color.a < 0.05) {
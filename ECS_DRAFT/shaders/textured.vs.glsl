@@ -15,13 +15,14 @@ uniform mat3 transform;
 uniform mat3 projection;
 uniform float depth;
 uniform vec2 tex_u_range;
+uniform vec2 tex_v_range;
 
 void main()
 {
 	// Map texcoord into given range
 	texcoord = vec2(
 		tex_u_range[0] + in_texcoord.x * (tex_u_range[1] - tex_u_range[0]),
-		in_texcoord.y);
+		tex_v_range[0] + in_texcoord.y * (tex_v_range[1] - tex_v_range[0]));
 	vec3 pos = projection * transform * vec3(in_position.xy, 1.0);
 	gl_Position = vec4(pos.xy, in_position.z, depth);
 }
\ No newline at end of file
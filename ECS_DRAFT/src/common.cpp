@@ -1,5 +1,9 @@
 #include "common.hpp"
 
+#include <atomic>
+#include <functional>
+#include <thread>
+
 // Note, we could also use the functions from GLM but we write the transformations here to show the uderlying math
 void Transform::scale(vec2 scale)
 {
@@ -21,6 +25,38 @@ void Transform::translate(vec2 offset)
 	mat = mat * T;
 }
 
+std::string cooked_path(const std::string& name)
+{
+	static const std::string cache_directory = []() {
+#ifdef _WIN32
+		const char* local_app_data = getenv("LOCALAPPDATA");
+		if (local_app_data != nullptr && *local_app_data != '\0') {
+			return std::string(local_app_data) + "/timelock/cooked";
+		}
+#else
+		const char* xdg_cache_home = getenv("XDG_CACHE_HOME");
+		if (xdg_cache_home != nullptr && *xdg_cache_home != '\0') {
+			return std::string(xdg_cache_home) + "/timelock/cooked";
+		}
+		const char* home = getenv("HOME");
+		if (home != nullptr && *home != '\0') {
+			return std::string(home) + "/.cache/timelock/cooked";
+		}
+#endif
+		// no user directory to speak of; data/cooked is ignored by git
+		return data_path() + "/cooked";
+	}();
+	return cache_directory + "/" + name;
+}
+
+std::string temporary_path(const std::string& path)
+{
+	// the level watcher and the prefetcher may cook the same file at once
+	static std::atomic<uint32_t> next_writer{ 0 };
+	const size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+	return path + "." + std::to_string(thread) + "." + std::to_string(next_writer++) + ".tmp";
+}
+
 // M1 Interpolation implementation (lerp formula)
 float lerpToTarget(float current, float target, float time) {
 	return current * (1.0f - time) + target * time;
@@ -29,8 +29,13 @@ inline std::string data_path() { return std::string(PROJECT_SOURCE_DIR) + "data"
 inline std::string shader_path(const std::string& name) {return std::string(PROJECT_SOURCE_DIR) + "/shaders/" + name;};
 inline std::string textures_path(const std::string& name) {return data_path() + "/textures/" + std::string(name);};
 inline std::string level_ground_path(const std::string& folder_name) {return PROJECT_SOURCE_DIR + std::string("../LDtk/") + folder_name + std::string("/Ground.png");}
+inline std::string level_data_path(const std::string& folder_name) {return PROJECT_SOURCE_DIR + std::string("../LDtk/") + folder_name + std::string("/data.json");}
 inline std::string audio_path(const std::string& name) {return data_path() + "/audio/" + std::string(name);};
 inline std::string mesh_path(const std::string& name) {return data_path() + "/meshes/" + std::string(name);};
+// Cooked assets go to a per-user cache directory rather than the source tree
+std::string cooked_path(const std::string& name);
+// A name next to path that no other writer of this process uses, to write a file before renaming it
+std::string temporary_path(const std::string& path);
 
 
 #ifndef M_PI
@@ -282,16 +287,38 @@ const float SCREW_LIFE_MS = SCREW_FLIGHT_LENGTH / SCREW_SPEED * 1000.0f;
 const vec2 DOOR_SIZE = vec2 { 2.0f * TILE_TO_PIXELS, 3.0f * TILE_TO_PIXELS };
 const float LOAD_LEVEL_COUNTDOWN = DEAD_REVIVE_TIME_MS + 10.0f;
 
+// Entity pools: parked entities kept per kind, the rest are destroyed
+const int ENTITY_POOL_CAPACITY = 64;
+
 // Parsing constants
 const float PARSING_CANNON_Y_POS_DIFF = (0.5f * TILE_TO_PIXELS) - (CANNON_TOWER_SIZE.y / 2);
 const float PARSING_CHECKPOINT_Y_POS_DIFF = (0.5f * TILE_TO_PIXELS) - (SPAWNPOINT_SCALE.y / 2);
 
+// Level streaming: static tiles are grouped into square chunks and only exist near the view
+const int LEVEL_CHUNK_TILES = 32;
+const float LEVEL_CHUNK_SIZE_PX = (float)(LEVEL_CHUNK_TILES * TILE_TO_PIXELS);
+const float LEVEL_STREAM_MARGIN = LEVEL_CHUNK_SIZE_PX;	// chunks this close to the view are activated, twice this far retired
+const int LEVEL_STREAM_BUDGET = 512;	// entities created or removed per frame while streaming
+const int LEVEL_BATCH_RECORDS = 32;	// records a worker builds the components of in one batch on load
+
 // Particles
-const int PARTICLE_COUNT_LIMIT = 1000;
+const int PARTICLE_COUNT_LIMIT = 100000;
+const int PARTICLE_HANDLE_INDEX_BITS = 20;
+const int PARTICLE_INSTANCE_RING_SEGMENTS = 3;	// frames of particle instance data the GPU may still be reading
+const int GPU_PARTICLE_CAPACITY = 1 << 16;		// ring size of the transform feedback backend
+const int PARTICLE_UPDATE_CHUNK = 4096;			// slots per parallel update job, a multiple of 8
+const int PARTICLE_WORKER_LIMIT = 4;			// threads stepping particles, including the main thread
+const float PARTICLE_LOD_NEAR_DISTANCE = WINDOW_WIDTH_PX * 0.75f;	// thinnable effects spawn in full inside this
+const float PARTICLE_LOD_FAR_RATE = 0.25f;		// spawn rate of thinnable effects at MAX_CAMERA_DISTANCE
+const float PARTICLE_LOD_PRESSURE_START = 0.75f;	// pool fill at which thinnable effects start backing off
+const int PARTICLE_EVICTION_BATCH = 256;		// low priority particles culled at once when the pool is full
+const float PARTICLE_TELEMETRY_INTERVAL_MS = 5000.0f;
 const float MAX_CAMERA_DISTANCE = 2000.0;
 const float TURBULENCE_GRID_SIZE = MAX_CAMERA_DISTANCE / 32.0f;
 const float TURBULENCE_EVOLUTION_SPEED = 1e-12f;
-const int TURBULENCE_OCTAVES = 1;
+const int TURBULENCE_OCTAVES = 1;	// the field's noise period, 64, has to stay whole for every octave
+const int TURBULENCE_FIELD_RESOLUTION = 128;	// power of two
+const float TURBULENCE_FIELD_CELLS_PER_NOISE = 2.0f;
 
 const float COYOTE_PARTICLES_DURATION = 500.0f;
 
@@ -302,6 +329,8 @@ const float BACKGROUND_HEIGHT = 1080.0f;
 
 const vec2 ROLLING_PLATFORM_SIZE = vec2{ 23.0f, 15.0f };
 const int ROLLING_PLATFORM_FRAMES_ALIVE = 35;
+// live platforms per rolling thing; the sequence never has more than 47 spawns in any 35 frames
+const int ROLLING_PLATFORM_RING_SIZE = 64;
 const float ROLLING_PLATFORM_SPEED = 4.0f; // px moving down per frame
 
 // UI
@@ -328,6 +357,29 @@ const float BLUR_FACTOR = 2.0f;
 const float HALO_LERP_FACTOR = 0.9f;
 const float HALO_LERP_TOLERANCE = 0.01f;
 
+// Dual filter blur: each level halves the previous one, starting from the blur buffers
+const int HALO_BLUR_LEVELS = 4;
+const int FOREGROUND_BLUR_LEVELS = 1;
+const float KAWASE_BLUR_OFFSET = 1.0f;
+
+// Texture atlas: only small sprites are packed, backgrounds and cutscenes keep their own texture
+const int ATLAS_LAYER_SIZE = 2048;
+const int ATLAS_MAX_LAYERS = 64;
+const int ATLAS_MEMORY_BUDGET_BYTES = 64 * 1024 * 1024;
+const int ATLAS_MAX_SPRITE_SIZE = 256;		// per frame, in texels
+const int ATLAS_PADDING = 1;
+
+// Texture loading
+const int TEXTURE_UPLOADS_PER_FRAME = 4;
+
+// Culling
+const float RENDER_GRID_CELL_SIZE = 8.0f * TILE_TO_PIXELS;
+const float RENDER_CULLING_MARGIN = 1.0f * TILE_TO_PIXELS;
+
+// Frame arena
+const size_t FRAME_ARENA_INITIAL_BYTES = 256 * 1024;
+const float FRAME_STATS_INTERVAL_MS = 5000.0f;
+
 const vec4 PLAYER_ALIVE_HALO = vec4(1.5f, 1.5f, 1.5f, 1.0f);
 const vec4 PLAYER_DEAD_HALO = vec4(0.1f, 0.1f, 0.1f, 1.0f);
 
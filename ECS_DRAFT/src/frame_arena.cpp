@@ -0,0 +1,94 @@
+#include "frame_arena.hpp"
+#include "common.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+FrameArena frame_arena(FRAME_ARENA_INITIAL_BYTES);
+
+namespace {
+#ifdef TIMELOCK_FRAME_STATS
+	std::atomic<size_t> heap_allocations{ 0 };
+#endif
+
+	uintptr_t align_up(uintptr_t address, size_t alignment) {
+		return (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+	}
+}
+
+FrameArena::FrameArena(size_t initial_bytes)
+	: block(new char[initial_bytes]), block_size(initial_bytes)
+{
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+	const uintptr_t base = (uintptr_t)block.get();
+	const uintptr_t start = align_up(base + offset, alignment);
+	if (start + bytes <= base + block_size) {
+		offset = start + bytes - base;
+		peak_offset = std::max(peak_offset, offset);
+		return (void*)start;
+	}
+
+	// Out of room; spill for the rest of the frame
+	spills.emplace_back(new char[bytes + alignment]);
+	spill_bytes += bytes + alignment;
+	return (void*)align_up((uintptr_t)spills.back().get(), alignment);
+}
+
+void FrameArena::deallocate(void* ptr, size_t bytes)
+{
+	char* top = block.get() + offset;
+	if ((char*)ptr + bytes == top) {
+		offset = (char*)ptr - block.get();
+	}
+}
+
+void FrameArena::reset()
+{
+	high_water = peak_offset + spill_bytes;
+
+	if (!spills.empty()) {
+		spills.clear();
+		block_size = high_water + high_water / 2;
+		block.reset(new char[block_size]);
+	}
+	spill_bytes = 0;
+	offset = 0;
+	peak_offset = 0;
+}
+
+#ifdef TIMELOCK_FRAME_STATS
+size_t heap_allocation_count()
+{
+	return heap_allocations.load(std::memory_order_relaxed);
+}
+
+// Replaced only to count; the array and nothrow forms forward to these
+void* operator new(size_t size)
+{
+	heap_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+#else
+size_t heap_allocation_count()
+{
+	return 0;
+}
+#endif
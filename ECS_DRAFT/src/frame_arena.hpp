@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Bump allocator for temporaries that do not outlive a frame. Allocations are carved linearly
+// out of one block and only reclaimed by reset(); if the block runs out, the rest of the frame
+// spills into heap blocks and the next reset() grows the block to the frame's high water mark,
+// so a steady frame touches the heap no more. Main thread only.
+class FrameArena {
+public:
+	FrameArena(size_t initial_bytes);
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	void* allocate(size_t bytes, size_t alignment);
+	// Only the latest allocation is given back, which covers a vector regrowing at the top
+	void deallocate(void* ptr, size_t bytes);
+
+	// Invalidates everything allocated since the previous reset
+	void reset();
+
+	size_t capacity() const { return block_size; }
+	// Bytes the previous frame needed, spills included
+	size_t highWater() const { return high_water; }
+
+private:
+	std::unique_ptr<char[]> block;
+	size_t block_size = 0;
+	size_t offset = 0;
+	size_t peak_offset = 0;
+
+	std::vector<std::unique_ptr<char[]>> spills;
+	size_t spill_bytes = 0;
+
+	size_t high_water = 0;
+};
+
+extern FrameArena frame_arena;
+
+// Routes a standard container's storage through frame_arena
+template <typename T>
+class FrameAllocator {
+public:
+	using value_type = T;
+
+	FrameAllocator() = default;
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>&) {}
+
+	T* allocate(size_t n) { return (T*)frame_arena.allocate(n * sizeof(T), alignof(T)); }
+	void deallocate(T* ptr, size_t n) { frame_arena.deallocate(ptr, n * sizeof(T)); }
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) { return false; }
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+// Calls to the global operator new since startup, from any thread. Only counted in builds with
+// TIMELOCK_FRAME_STATS, which replace operator new; elsewhere the count stays 0
+#ifdef TIMELOCK_FRAME_STATS
+constexpr bool heap_allocations_counted = true;
+#else
+constexpr bool heap_allocations_counted = false;
+#endif
+size_t heap_allocation_count();
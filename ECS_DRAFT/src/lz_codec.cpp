@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "lz_codec.hpp"
+
+namespace {
+	const size_t LZ_MIN_MATCH = 4;
+	const size_t LZ_MAX_OFFSET = 65535;
+	const int LZ_HASH_BITS = 16;
+
+	uint32_t read32(const unsigned char* p)
+	{
+		uint32_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	uint32_t hash32(uint32_t value)
+	{
+		return (value * 2654435761u) >> (32 - LZ_HASH_BITS);
+	}
+
+	// Lengths that do not fit their nibble continue in bytes of 255 plus a remainder
+	void write_length(unsigned char*& out, size_t length)
+	{
+		while (length >= 255) {
+			*out++ = 255;
+			length -= 255;
+		}
+		*out++ = (unsigned char)length;
+	}
+
+	bool read_length(const unsigned char*& in, const unsigned char* in_end, size_t& length)
+	{
+		unsigned char byte;
+		do {
+			if (in == in_end) {
+				return false;
+			}
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	// A match_length of 0 marks the last sequence, which only carries literals
+	void write_sequence(unsigned char*& out, const unsigned char* literals, size_t literal_length,
+		size_t offset, size_t match_length)
+	{
+		unsigned char* token = out++;
+		*token = (unsigned char)(std::min<size_t>(literal_length, 15) << 4);
+		if (literal_length >= 15) {
+			write_length(out, literal_length - 15);
+		}
+		memcpy(out, literals, literal_length);
+		out += literal_length;
+
+		if (match_length == 0) {
+			return;
+		}
+		*out++ = (unsigned char)(offset & 0xff);
+		*out++ = (unsigned char)(offset >> 8);
+
+		const size_t extra = match_length - LZ_MIN_MATCH;
+		*token |= (unsigned char)std::min<size_t>(extra, 15);
+		if (extra >= 15) {
+			write_length(out, extra - 15);
+		}
+	}
+}
+
+size_t lz_compress_bound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t lz_compress(const unsigned char* src, size_t size, unsigned char* dst)
+{
+	std::vector<uint32_t> table((size_t)1 << LZ_HASH_BITS, UINT32_MAX);
+	unsigned char* out = dst;
+	size_t anchor = 0;
+	size_t pos = 0;
+
+	while (pos + LZ_MIN_MATCH <= size) {
+		const uint32_t sequence = read32(src + pos);
+		uint32_t& slot = table[hash32(sequence)];
+		const size_t candidate = slot;
+		slot = (uint32_t)pos;
+
+		if (candidate == UINT32_MAX || pos - candidate > LZ_MAX_OFFSET || read32(src + candidate) != sequence) {
+			// step faster through data that keeps missing, as incompressible regions rarely turn around
+			pos += 1 + ((pos - anchor) >> 6);
+			continue;
+		}
+
+		size_t match_length = LZ_MIN_MATCH;
+		while (pos + match_length < size && src[candidate + match_length] == src[pos + match_length]) {
+			match_length++;
+		}
+		write_sequence(out, src + anchor, pos - anchor, pos - candidate, match_length);
+		pos += match_length;
+		anchor = pos;
+	}
+
+	write_sequence(out, src + anchor, size - anchor, 0, 0);
+	return (size_t)(out - dst);
+}
+
+bool lz_decompress(const unsigned char* src, size_t size, unsigned char* dst, size_t dst_size)
+{
+	const unsigned char* in = src;
+	const unsigned char* in_end = src + size;
+	size_t out = 0;
+
+	while (in < in_end) {
+		const unsigned char token = *in++;
+
+		size_t literal_length = token >> 4;
+		if (literal_length == 15 && !read_length(in, in_end, literal_length)) {
+			return false;
+		}
+		if (literal_length > (size_t)(in_end - in) || literal_length > dst_size - out) {
+			return false;
+		}
+		memcpy(dst + out, in, literal_length);
+		in += literal_length;
+		out += literal_length;
+
+		if (in == in_end) {
+			break;
+		}
+
+		if (in_end - in < 2) {
+			return false;
+		}
+		const size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+		in += 2;
+
+		size_t match_length = token & 15;
+		if (match_length == 15 && !read_length(in, in_end, match_length)) {
+			return false;
+		}
+		match_length += LZ_MIN_MATCH;
+		if (offset == 0 || offset > out || match_length > dst_size - out) {
+			return false;
+		}
+
+		// matches may overlap their own output; each copy doubles the repeated run, so
+		// source and destination never overlap within a single memcpy
+		const unsigned char* match = dst + out - offset;
+		unsigned char* target = dst + out;
+		size_t copied = 0;
+		while (copied < match_length) {
+			const size_t chunk = std::min(match_length - copied, offset + copied);
+			memcpy(target + copied, match, chunk);
+			copied += chunk;
+		}
+		out += match_length;
+	}
+
+	return out == dst_size;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+// Byte-oriented LZ77 in the LZ4 block layout: each sequence is a token (literal length and
+// match length nibbles), the literals, then a 16-bit match offset. Decoding is a few memcpys
+// per sequence, which keeps cooked assets cheap to read back compared to PNG.
+
+// Worst-case compressed size of size input bytes
+size_t lz_compress_bound(size_t size);
+
+// Compresses into dst, which must hold lz_compress_bound(size) bytes; returns the bytes written
+size_t lz_compress(const unsigned char* src, size_t size, unsigned char* dst);
+
+// Fails unless the stream is well formed and expands to exactly dst_size bytes
+bool lz_decompress(const unsigned char* src, size_t size, unsigned char* dst, size_t dst_size);
@@ -13,6 +13,7 @@
 #include "systems/player/player_system.hpp"
 #include "systems/boss/boss_system.hpp"
 #include "systems/parser/parsing_system.hpp"
+#include "systems/parser/level_compiler.hpp"
 #include "systems/spawnpoint/spawnpoint_system.hpp"
 #include "systems/particle/particle_system.hpp"
 #include "systems/ui/ui_system.hpp"
@@ -22,6 +23,12 @@ int main(int argc, char *argv[])
 {
 
 	bool play_sound = true;
+	bool particle_benchmark = false;
+	bool verify_determinism = false;
+	bool frame_stats = false;
+	bool compile_levels = false;
+	bool level_benchmark = false;
+	bool hot_reload = false;
 	if (argc == 2)
 	{
 		std::vector<std::string> flags;
@@ -36,13 +43,55 @@ int main(int argc, char *argv[])
 			if (flag == "--nosound") {
 				play_sound = false;
 			}
+			else if (flag == "--particle-benchmark") {
+				particle_benchmark = true;
+			}
+			else if (flag == "--verify-determinism") {
+				verify_determinism = true;
+			}
+			else if (flag == "--gpu-particles") {
+				ParticleSystem::set_gpu_simulation(true);
+			}
+			else if (flag == "--particle-stats") {
+				ParticleSystem::set_telemetry(true);
+			}
+			else if (flag == "--frame-stats") {
+				frame_stats = true;
+			}
+			else if (flag == "--compile-levels") {
+				compile_levels = true;
+			}
+			else if (flag == "--level-benchmark") {
+				level_benchmark = true;
+			}
+			else if (flag == "--hot-reload") {
+				hot_reload = true;
+			}
 		}
 	}
 
+	if (particle_benchmark) {
+		ParticleSystem::run_benchmark(PARTICLE_COUNT_LIMIT, 600);
+		return EXIT_SUCCESS;
+	}
+	if (verify_determinism) {
+		return ParticleSystem::verify_determinism(PARTICLE_COUNT_LIMIT, 600) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// Cooks every LDtk export ahead of time instead of on first load
+	if (compile_levels) {
+		return LevelCompiler::compile_all() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (level_benchmark) {
+		LevelCompiler::run_load_benchmark(20);
+		return EXIT_SUCCESS;
+	}
+
 	SystemsManager system_manager;
 	if (system_manager.get_window() == nullptr) {
 		return EXIT_FAILURE;
 	}
+	system_manager.set_frame_stats(frame_stats);
 
 	// global systems
 	AISystem	  ai_system;
@@ -59,6 +108,7 @@ int main(int argc, char *argv[])
 	UiSystem ui_system;
 
 	world_system.setSound(play_sound);
+	parsing_system.set_hot_reload(hot_reload);
 
 	// register order is the order steps (and then late steps) will be called
 	system_manager.register_system(&parsing_system);
@@ -1,4 +1,5 @@
 #include "cannon_tower_utils.hpp"
+#include "../../world/entity_pool.hpp"
 #include <glm/trigonometric.hpp>
 #include <iostream>
 #include <cmath>
@@ -173,45 +174,41 @@ void cannon_fire(Entity tower_entity, float angle) {
 	// Currently a copy of create bolt
 	CannonTower& tower = registry.cannonTowers.get(tower_entity);
 
-	auto proj_entity = Entity();
+	Entity proj_entity = EntityPools::acquire(ENTITY_POOL_ID::CANNON_BOLT);
+	registry.pooleds.get(proj_entity).owner = tower_entity.id();
 
-	PhysicsObject& object = registry.physicsObjects.emplace(proj_entity);
+	PhysicsObject& object = reuse_component(registry.physicsObjects, proj_entity);
 	object.mass = 10.0f;
 	object.drag_coefficient = 0.01f;
 
 	//registry.falling.emplace(entity);
 
-	registry.bolts.emplace(proj_entity);
-	registry.harmfuls.emplace(proj_entity);
-	registry.projectiles.emplace(proj_entity);
+	reuse_component(registry.bolts, proj_entity);
+	reuse_component(registry.harmfuls, proj_entity);
+	reuse_component(registry.projectiles, proj_entity);
 
 	vec2 dir = vec2{ cos(angle), sin(angle) };
-	Motion& motion = registry.motions.emplace(proj_entity);
+	Motion& motion = reuse_component(registry.motions, proj_entity);
 	motion.angle = 0.f;
 	motion.velocity = CANNON_PROJECTILE_SPEED * dir;
 	motion.position = registry.motions.get(tower_entity).position + dir * registry.motions.get(Entity(tower.barrel_entity_id)).scale.x;
 	motion.scale = CANNON_PROJECTILE_SIZE;
 
-	registry.colors.insert(
-		proj_entity,
-		{ 1.0f, 1.0f, 1.0f }
-	);
-
-	registry.renderRequests.insert(
-		proj_entity,
-		{
-			TEXTURE_ASSET_ID::HEX,
-			EFFECT_ASSET_ID::HEX,
-			GEOMETRY_BUFFER_ID::HEX
-		}
-	);
+	reuse_component(registry.colors, proj_entity) = { 1.0f, 1.0f, 1.0f };
+
+	reuse_component(registry.renderRequests, proj_entity) = {
+		TEXTURE_ASSET_ID::HEX,
+		EFFECT_ASSET_ID::HEX,
+		GEOMETRY_BUFFER_ID::HEX
+	};
 
-	registry.layers.insert(proj_entity, { LAYER_ID::MIDGROUND });
+	reuse_component(registry.layers, proj_entity) = { LAYER_ID::MIDGROUND };
 
-	TimeControllable &timeControllable = registry.timeControllables.emplace(proj_entity);
+	TimeControllable &timeControllable = reuse_component(registry.timeControllables, proj_entity);
 	timeControllable.can_become_harmless = true;
 
 	// Particles
+	ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::CANNON_FIRE);
 	ParticleSystem::emit_elliptical_particles(motion.position, vec2(0.5f, 1.0f), angle, 30, 120.0f, 
 		motion.velocity * 0.3f, vec3(0.05f), 6.0f, 500.0f);
 }
\ No newline at end of file
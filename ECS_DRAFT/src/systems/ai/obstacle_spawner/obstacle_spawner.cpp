@@ -8,9 +8,39 @@
 
 // TODO: this is prob a temporary system! just need smthing for M3. this is probably similar to Yixian's screw platforms but the sun is rising and I have not slept
 
+// Brings back the spawner's previous obstacle at the start position; false if there is none
+bool reuse_obstacle(ObstacleSpawner& spawner) {
+    Entity obstacle = Entity(spawner.parked_obstacle_id);
+    spawner.parked_obstacle_id = 0;
+    if (obstacle.id() == 0 || !registry.inactives.has(obstacle)) {
+        return false;
+    }
+
+    activate_entity(obstacle);
+    spawner.obstacle_id = obstacle.id();
+
+    Motion& motion = registry.motions.get(obstacle);
+    reset_component(motion);
+    motion.position = spawner.start_position;
+    motion.scale = spawner.size;
+
+    reset_component(registry.physicsObjects.get(obstacle));
+    reset_component(registry.timeControllables.get(obstacle));
+    return true;
+}
+
+// Parks the live obstacle so the next spawn can reuse its meshes
+void park_obstacle(ObstacleSpawner& spawner) {
+    deactivate_entity(Entity(spawner.obstacle_id));
+    spawner.parked_obstacle_id = spawner.obstacle_id;
+    spawner.obstacle_id = 0;
+}
+
 void create_obstacle(ObstacleSpawner& spawner) {
+    const bool reused = reuse_obstacle(spawner);
+
     if (spawner.obstacle_type == "GEAR") {
-        Entity gear = create_gear(spawner.start_position, spawner.size, false, 0.0f, 0.0f);
+        Entity gear = reused ? Entity(spawner.obstacle_id) : create_gear(spawner.start_position, spawner.size, false, 0.0f, 0.0f);
 
         spawner.obstacle_id = gear.id();
 
@@ -27,7 +57,7 @@ void create_obstacle(ObstacleSpawner& spawner) {
         Motion& motion = registry.motions.get(gear);
         motion.velocity = spawner.velocity;
     } else if (spawner.obstacle_type == "SPIKEBALL") {
-        Entity spikeball = create_spikeball(spawner.start_position, spawner.size);
+        Entity spikeball = reused ? Entity(spawner.obstacle_id) : create_spikeball(spawner.start_position, spawner.size);
         spawner.obstacle_id = spikeball.id();
 
         PhysicsObject& phys = registry.physicsObjects.get(spikeball);
@@ -61,8 +91,7 @@ void obstacle_spawner_step(float elapsed_ms) {
             if (spawner.obstacle_id != 0) {
                 Entity obstacle = Entity(spawner.obstacle_id);
                 const vec2 obstacle_last_pos = registry.motions.get(obstacle).position;
-                registry.remove_all_components_of(obstacle);
-                spawner.obstacle_id = 0;
+                park_obstacle(spawner);
 
                 if (spawner.obstacle_type == "SPIKEBALL") {
                     spikeball_effects(obstacle_last_pos);
@@ -86,8 +115,7 @@ void obstacle_spawner_step(float elapsed_ms) {
                     spikeball_effects(obstacle_last_pos);
                 }
 
-                registry.remove_all_components_of(obstacle);
-                spawner.obstacle_id = 0;
+                park_obstacle(spawner);
                 spawner.time_left_ms = spawner.lifetime_ms;
             } else {
                 // last min hacky M3 fix lol TODO change
@@ -103,6 +131,7 @@ void obstacle_spawner_step(float elapsed_ms) {
                 vec2 disp = rand_direction();
                 vec2 par_pos = spawner.start_position + disp * spawner.size.x * 0.75f;
 
+                ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::HAZARD_WARNING);
                 ParticleSystem::spawn_particle(vec3(0.95f, 0.0f, 0.0f),
                     par_pos, 0.0, 10.0f * vec2(1.0f - factor + 0.2f), -disp * 10.0f, 400.0f, 1.0f, { 0.0f, 0.0f }, { 25.0f, 150.0f });
             }
@@ -111,6 +140,7 @@ void obstacle_spawner_step(float elapsed_ms) {
 }
 
 void spikeball_effects(vec2 pos) {
+    ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::IMPACT);
     for (int i = 0; i < 30; i++) {
         vec2 vel = random_sample_ellipse(vec2(0.0f), vec2(1.0f)) * 200.0f;
 
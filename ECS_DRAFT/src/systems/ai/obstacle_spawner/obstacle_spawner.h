@@ -4,6 +4,7 @@
 #include "../../../tinyECS/registry.hpp"
 #include "systems/ISystem.hpp"
 #include "../../world/world_init.hpp"
+#include "../../world/entity_pool.hpp"
 #include "../../particle/particle_system.hpp"
 
 void obstacle_spawner_step(float elapsed_ms);
@@ -1,4 +1,5 @@
 #include "pipe_utils.hpp"
+#include "../../world/entity_pool.hpp"
 #include <iostream>
 
 void pipe_step(float elapsed_ms) {
@@ -29,6 +30,10 @@ void screw_step(float elapsed_ms) {
 		const Entity entity = registry.screws.entities[i];
 		Screw& screw = registry.screws.components[i];
 
+		if (!is_active(entity)) {
+			continue;
+		}
+
 		screw.timer -= (elapsed_ms * registry.timeControllables.get(entity).target_time_control_factor);
 
 		if (screw.timer <= 0.0) {
@@ -38,9 +43,9 @@ void screw_step(float elapsed_ms) {
 }
 
 void fire_screw(vec2 position, vec2 velocity) {
-	auto proj_entity = Entity();
+	Entity proj_entity = EntityPools::acquire(ENTITY_POOL_ID::SCREW);
 
-	PhysicsObject& object = registry.physicsObjects.emplace(proj_entity);
+	PhysicsObject& object = reuse_component(registry.physicsObjects, proj_entity);
 	object.mass = 0.0f;
 	object.drag_coefficient = 0.0f;
 	object.apply_friction = false;
@@ -48,30 +53,27 @@ void fire_screw(vec2 position, vec2 velocity) {
 	object.apply_gravity = false;
 	object.apply_rotation = false;
 
-	registry.screws.emplace(proj_entity);
-	registry.harmfuls.emplace(proj_entity);
-	registry.projectiles.emplace(proj_entity);
+	reuse_component(registry.screws, proj_entity);
+	reuse_component(registry.harmfuls, proj_entity);
+	reuse_component(registry.projectiles, proj_entity);
 
-	Motion& motion = registry.motions.emplace(proj_entity);
+	Motion& motion = reuse_component(registry.motions, proj_entity);
 	motion.angle = 0.f;
 	motion.velocity = velocity;
 	motion.position = position;
 	motion.scale = SCREW_SIZE;
 
 
-	registry.renderRequests.insert(
-		proj_entity,
-		{
-			TEXTURE_ASSET_ID::SCREW,
-			EFFECT_ASSET_ID::TEXTURED,
-			GEOMETRY_BUFFER_ID::SPRITE,
-			velocity.x < 0
-		}
-	);
+	reuse_component(registry.renderRequests, proj_entity) = {
+		TEXTURE_ASSET_ID::SCREW,
+		EFFECT_ASSET_ID::TEXTURED,
+		GEOMETRY_BUFFER_ID::SPRITE,
+		velocity.x < 0
+	};
 
-	registry.layers.insert(proj_entity, { LAYER_ID::MIDGROUND });
+	reuse_component(registry.layers, proj_entity) = { LAYER_ID::MIDGROUND };
 
-	TimeControllable& timeControllable = registry.timeControllables.emplace(proj_entity);
+	TimeControllable& timeControllable = reuse_component(registry.timeControllables, proj_entity);
 	timeControllable.can_become_harmless = true;
 }
 
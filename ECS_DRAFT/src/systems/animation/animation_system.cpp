@@ -1,6 +1,9 @@
 #include "animation_system.hpp"
 #include <cmath>
+#include <numeric>
 #include "../world/world_init.hpp"
+#include "../world/entity_pool.hpp"
+#include "../../frame_arena.hpp"
 #include <iostream>
 
 void AnimationSystem::init(GLFWwindow* window) {
@@ -19,8 +22,7 @@ void AnimationSystem::step(float elapsed_ms) {
 		Entity entity = animateRequest_registry.entities[i];
 		AnimateRequest &animateRequest = animateRequest_registry.components[i];
 
-		// TODO: ensure animaiton collection contains animation id
-		const AnimationConfig& animationConfig = this->animation_collections.at(animateRequest.used_animation);
+		const AnimationConfig& animationConfig = animation_config(animateRequest.used_animation);
 
 		// Calculate time factor upon acceleration/deceleration
 		float timeFactor = 1.0f;
@@ -52,6 +54,24 @@ void AnimationSystem::step(float elapsed_ms) {
 
 }
 
+std::array<int, texture_count> AnimationSystem::texture_frame_counts() {
+	std::array<int, texture_count> frame_counts;
+	frame_counts.fill(0);
+
+	for (const AnimationConfig& animation_config : animation_collections) {
+		if (animation_config.sprite_texture == TEXTURE_ASSET_ID::TEXTURE_COUNT) {
+			continue;
+		}
+		int& frame_count = frame_counts[(int)animation_config.sprite_texture];
+		frame_count = std::gcd(frame_count, animation_config.frame_count);
+	}
+
+	for (int& frame_count : frame_counts) {
+		frame_count = max(frame_count, 1);
+	}
+	return frame_counts;
+}
+
 void AnimationSystem::updateTimer(AnimateRequest& animateRequest, const AnimationConfig& animationConfig, float elapsed_ms) {
 	// TODO: INCORPORATE ACCELERATION & DECELERATION LOGIC
 
@@ -78,141 +98,66 @@ void AnimationSystem::late_step(float elapsed_ms) {
 	auto& animateRequest_registry = registry.animateRequests;
 	auto& renderRequest_registry = registry.renderRequests;
 
-	for (int i = 0; i < animateRequest_registry.size(); i++) {
-		Entity entity = animateRequest_registry.entities[i];
-		AnimateRequest& animateRequest = animateRequest_registry.components[i];
+	AnimateRequest* animateRequests = animateRequest_registry.components.data();
+	const unsigned int request_count = (unsigned int)animateRequest_registry.size();
 
-		const AnimationConfig& animationConfig = this->animation_collections.at(animateRequest.used_animation);
+	// Calculate Frame: one pass over the packed requests with no lookups besides the clip table,
+	// setting aside the requests whose clip reached its last frame and has a follow-up
+	FrameVector<unsigned int> ended_requests;
+	for (unsigned int i = 0; i < request_count; i++) {
+		AnimateRequest& animateRequest = animateRequests[i];
+		const AnimationConfig& animationConfig = animation_collections[(int)animateRequest.used_animation];
 
+		const int last_frame = animationConfig.frame_count - 1;
+		const int frame = min((int)(animateRequest.timer * animationConfig.frames_per_ms), last_frame);
+		const float start_u_coord = frame * animationConfig.frame_u_width;
+		animateRequest.tex_u_range = { start_u_coord, start_u_coord + animationConfig.frame_u_width };
 
+		if (frame == last_frame && animationConfig.has_end()) {
+			ended_requests.push_back(i);
+		}
+	}
 
-		// Update Render Request
+	// Update Render Request
+	for (unsigned int i = 0; i < request_count; i++) {
+		Entity entity = animateRequest_registry.entities[i];
 		if (renderRequest_registry.has(entity)) {
-			RenderRequest& renderRequest = renderRequest_registry.get(entity);
-			if (renderRequest.used_texture != animationConfig.sprite_texture) {
-				renderRequest.used_texture = animationConfig.sprite_texture;
-			}
+			renderRequest_registry.get(entity).used_texture = animation_collections[(int)animateRequests[i].used_animation].sprite_texture;
+		}
+	}
 
-			// Calculate Frame
-			int frame = min((int)(animateRequest.timer / animationConfig.ms_per_frame), animationConfig.frame_count - 1);
-			float start_u_coord = (float)frame / (float)animationConfig.frame_count;
-			animateRequest.tex_u_range = { start_u_coord, start_u_coord + 1. / animationConfig.frame_count };
+	// Cutscenes advance through their clips here; rolling things step their own sequence
+	for (unsigned int i : ended_requests) {
+		Entity entity = animateRequest_registry.entities[i];
+		if (registry.cutScenes.has(entity)) {
+			AnimateRequest& animateRequest = animateRequests[i];
+			end_clip(entity, animateRequest, animation_collections[(int)animateRequest.used_animation]);
+		}
+	}
+}
 
-			if (registry.cutScenes.has(entity))
-			{
-				CutScene& cutscene = registry.cutScenes.get(entity);
+void AnimationSystem::end_clip(Entity entity, AnimateRequest& animateRequest, const AnimationConfig& animationConfig) {
+	if (animationConfig.next_clip != ANIMATION_ID::ANIMATION_COUNT) {
+		animateRequest.timer = 0.0f;
+		animateRequest.used_animation = animationConfig.next_clip;
+	}
 
-				if (animateRequest.used_animation == ANIMATION_ID::OUTRO_1 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::OUTRO_2;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::OUTRO_2 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::OUTRO_3;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::OUTRO_3 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::OUTRO_4;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::OUTRO_4 && frame == animationConfig.frame_count - 1) {
-					cutscene.state = 0;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_1 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_2;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_2 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_3;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_3 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_4;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_4 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_5;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_5 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_6;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_6 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_7;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_7 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_8;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_8 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_9;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_9 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_10;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_10 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_11;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_11 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_12;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_12 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_13;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_13 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_14;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_14 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_15;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_15 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_16;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_16 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_17;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_17 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_18;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_18 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_19;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_19 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_20;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_20 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_21;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_21 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_22;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_22 && frame == animationConfig.frame_count - 1) {
-					animateRequest.timer = 0.0f;
-					animateRequest.used_animation = ANIMATION_ID::INTRO_23;
-				}
-				else if (animateRequest.used_animation == ANIMATION_ID::INTRO_23 && frame == animationConfig.frame_count - 1) {
-					cutscene.state = 0;
-				}
-			}
-		}
+	switch (animationConfig.end_event) {
+	case ANIMATION_EVENT_ID::END_CUTSCENE:
+		registry.cutScenes.get(entity).state = 0;
+		break;
+	default:
+		break;
 	}
 }
 
+void AnimationSystem::destroy_oldest_rolling_platform(RollingThing& rolling_thing)
+{
+	EntityPools::destroy(Entity(rolling_thing.platforms[rolling_thing.first_platform].platform));
+	rolling_thing.first_platform = (rolling_thing.first_platform + 1) % ROLLING_PLATFORM_RING_SIZE;
+	rolling_thing.platform_count--;
+}
+
 // TODO: sorry for cluttering the animation system with this, I just needed the animation config info...
 void AnimationSystem::update_rolling_things(float elapsed_ms)
 {
@@ -221,73 +166,59 @@ void AnimationSystem::update_rolling_things(float elapsed_ms)
 	//		check if any platforms need to be spawned
 	//		   if yes, spawn platform at x offset stored in the json data from the left of the image (relative to motion.position, which stores the center)
 	//		   track spawned platforms
-	//     for spawned platforms:
-	//         increment "frames alive"
-	//         if frames alive > frames to last, destroy platform
+	//     for spawned platforms (a ring, oldest first):
+	//         destroy those from the front that have lasted ROLLING_PLATFORM_FRAMES_ALIVE frames
 
 	for (Entity& rt : registry.rollingThings.entities) {
 		Motion& rtMotion = registry.motions.get(rt);
 		AnimateRequest& animateRequest = registry.animateRequests.get(rt);
-		AnimationConfig animationConfig = this->animation_collections.at(animateRequest.used_animation);
+		const AnimationConfig* animationConfig = &animation_config(animateRequest.used_animation);
 		RollingThing& rThing = registry.rollingThings.get(rt);
 
-		int frame = min((int)(animateRequest.timer / animationConfig.ms_per_frame), animationConfig.frame_count);
+		int frame = min((int)(animateRequest.timer * animationConfig->frames_per_ms), animationConfig->frame_count);
 
 		if (frame != rThing.current_frame)
 		{
-			rThing.current_frame = frame;
-
-			// first, check if we need to swap between the two animations (spritesheet is larger than max texture size)
-			if (animateRequest.used_animation == ANIMATION_ID::ROLLING_THING_1 && rThing.current_frame == animationConfig.frame_count) {
-				animateRequest.used_animation = ANIMATION_ID::ROLLING_THING_2;
-				animateRequest.timer = 0.f;
-			} else if (animateRequest.used_animation == ANIMATION_ID::ROLLING_THING_2 && rThing.current_frame == animationConfig.frame_count) {
-				animateRequest.used_animation = ANIMATION_ID::ROLLING_THING_3;
-				animateRequest.timer = 0.f;
-			} else if (animateRequest.used_animation == ANIMATION_ID::ROLLING_THING_3 && rThing.current_frame == animationConfig.frame_count) {
-				animateRequest.used_animation = ANIMATION_ID::ROLLING_THING_4;
-				animateRequest.timer = 0.f;
-			} else if (animateRequest.used_animation == ANIMATION_ID::ROLLING_THING_4 && rThing.current_frame == animationConfig.frame_count){
-				animateRequest.used_animation = ANIMATION_ID::ROLLING_THING_1;
+			// past the last frame of this spritesheet, continue on the next one
+			if (frame == animationConfig->frame_count) {
+				animateRequest.used_animation = animationConfig->next_clip;
 				animateRequest.timer = 0.f;
+				animationConfig = &animation_config(animateRequest.used_animation);
+				frame = 0;
 			}
+			rThing.current_frame = frame;
 
-			// TOOO more elegant way of getting this to work...
-			if (animateRequest.used_animation == ANIMATION_ID::ROLLING_THING_2) {
-				frame += animationConfig.frame_count;
-			} else if (animateRequest.used_animation == ANIMATION_ID::ROLLING_THING_3)
-			{
-				frame += (animationConfig.frame_count*2);
-			} else if (animateRequest.used_animation == ANIMATION_ID::ROLLING_THING_4)
-			{
-				frame += (17 * 3);
-			}
+			// frame of the whole sequence
+			frame += animationConfig->sequence_offset;
 
 
-			// for all the current rolling platforms, check if need to delete, if not move down
-			for (unsigned int platform_id : rThing.platforms) {
-				Entity platform_entity = Entity(platform_id);
-				RollingPlatform& platform = registry.rollingPlatforms.get(platform_entity);
-				platform.frames_left--;
-				if (platform.frames_left <= 0) {
-					rThing.platforms.erase(std::remove(rThing.platforms.begin(), rThing.platforms.end(), platform_id), rThing.platforms.end());
-					registry.remove_all_components_of(platform_entity);
-				}
+			// platforms expire in the order they were spawned, so only the front of the ring is checked
+			rThing.frames_stepped++;
+			while (rThing.platform_count > 0 && rThing.platforms[rThing.first_platform].expires_at <= rThing.frames_stepped) {
+				destroy_oldest_rolling_platform(rThing);
 			}
 
-			// check json if we need to create new platforms this frame
-			std::string frame_num_str = std::to_string(frame);
-			std::vector<int>& to_spawn = registry.rolling_thing_data[frame_num_str];
+			// create the platforms the sequence drops on this frame
+			const RollingThingTimeline& timeline = registry.rolling_thing_timeline;
+			if (frame >= (int)timeline.frame_count()) {
+				continue;
+			}
+
+			float y_vel = (ROLLING_PLATFORM_SPEED / animationConfig->ms_per_frame) * 1000.f;
 
-			float y_vel = (ROLLING_PLATFORM_SPEED / animationConfig.ms_per_frame) * 1000.f;
+			for (uint32_t spawn = timeline.frame_start[frame]; spawn < timeline.frame_start[frame + 1]; spawn++) {
+				// only a denser sequence than the current one fills the ring; the oldest platform makes room
+				if (rThing.platform_count == ROLLING_PLATFORM_RING_SIZE) {
+					destroy_oldest_rolling_platform(rThing);
+				}
 
-			for (auto& spawn_x : to_spawn) {
-				float x_pos = spawn_x + (rtMotion.position.x - rtMotion.scale.x / 2);
+				float x_pos = timeline.spawn_x[spawn] + (rtMotion.position.x - rtMotion.scale.x / 2);
 				float y_pos = (rtMotion.position.y - rtMotion.scale.y / 2) + 62.0f;
 				Entity spawned_platform = create_rolling_platform(vec2{x_pos, y_pos}, ROLLING_PLATFORM_SIZE, y_vel);
-				RollingPlatform& rp = registry.rollingPlatforms.emplace(spawned_platform);
-				rp.frames_left = ROLLING_PLATFORM_FRAMES_ALIVE;
-				rThing.platforms.push_back(spawned_platform.id());
+
+				const int slot = (rThing.first_platform + rThing.platform_count) % ROLLING_PLATFORM_RING_SIZE;
+				rThing.platforms[slot] = { spawned_platform.id(), rThing.frames_stepped + ROLLING_PLATFORM_FRAMES_ALIVE };
+				rThing.platform_count++;
 			}
 
 
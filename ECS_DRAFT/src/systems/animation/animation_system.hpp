@@ -5,21 +5,69 @@
 #include "../../tinyECS/components.hpp"
 #include "../../tinyECS/registry.hpp"
 #include "systems/ISystem.hpp"
-#include <map>
+#include <array>
+#include <cassert>
+#include <initializer_list>
+#include <utility>
+
+// What happens when a clip that has a follow-up reaches its last frame
+enum class ANIMATION_EVENT_ID {
+	NONE = 0,
+	END_CUTSCENE = NONE + 1,
+	ANIMATION_EVENT_COUNT = END_CUTSCENE + 1
+};
 
 struct AnimationConfig {
-	const TEXTURE_ASSET_ID sprite_texture;
-	const ANIMATION_TYPE_ID animation_type;
-	const int frame_count;
-	const float duration_ms;
-	const float ms_per_frame;
-
+	TEXTURE_ASSET_ID sprite_texture = TEXTURE_ASSET_ID::TEXTURE_COUNT;
+	ANIMATION_TYPE_ID animation_type = ANIMATION_TYPE_ID::FREEZE;
+	int frame_count = 1;
+	float duration_ms = 1.f;
+	float ms_per_frame = 1.f;
+	// Reciprocals, so that frame selection is a multiply
+	float frames_per_ms = 1.f;
+	float frame_u_width = 1.f;
+
+	// Clip played after this one (ANIMATION_COUNT for none) and the event raised when it ends
+	ANIMATION_ID next_clip = ANIMATION_ID::ANIMATION_COUNT;
+	ANIMATION_EVENT_ID end_event = ANIMATION_EVENT_ID::NONE;
+	// Index of this clip's first frame in a sequence split over several spritesheets
+	int sequence_offset = 0;
+
+	AnimationConfig() = default;
 	AnimationConfig(TEXTURE_ASSET_ID sprite_texture, ANIMATION_TYPE_ID animation_type, int frame_count, float duration_ms) :
 		sprite_texture(sprite_texture), animation_type(animation_type), 
-		frame_count(frame_count), duration_ms(duration_ms), ms_per_frame(duration_ms/frame_count)
+		frame_count(frame_count), duration_ms(duration_ms), ms_per_frame(duration_ms/frame_count),
+		frames_per_ms(frame_count/duration_ms), frame_u_width(1.f/frame_count)
 	{}
+
+	AnimationConfig then(ANIMATION_ID clip) const {
+		AnimationConfig config = *this;
+		config.next_clip = clip;
+		return config;
+	}
+	AnimationConfig ending(ANIMATION_EVENT_ID event) const {
+		AnimationConfig config = *this;
+		config.end_event = event;
+		return config;
+	}
+	AnimationConfig in_sequence_at(int offset) const {
+		AnimationConfig config = *this;
+		config.sequence_offset = offset;
+		return config;
+	}
+
+	bool has_end() const { return next_clip != ANIMATION_ID::ANIMATION_COUNT || end_event != ANIMATION_EVENT_ID::NONE; }
 };
 
+// Dense clip table indexed by ANIMATION_ID
+inline std::array<AnimationConfig, animation_count> index_clips(std::initializer_list<std::pair<ANIMATION_ID, AnimationConfig>> clips) {
+	std::array<AnimationConfig, animation_count> table;
+	for (const auto& [animation_id, config] : clips) {
+		table[(int)animation_id] = config;
+	}
+	return table;
+}
+
 // Animation System that updates uv of texture to render
 class AnimationSystem : public ISystem
 {
@@ -31,45 +79,55 @@ public:
 	AnimationSystem()
 	{
 	}
+
+	// Frame count of the spritesheet behind each texture (1 when not animated); a texture shared
+	// by several clips uses the largest frame width common to all of them
+	static std::array<int, texture_count> texture_frame_counts();
+
+	static const AnimationConfig& animation_config(ANIMATION_ID animation_id) {
+		assert((int)animation_id < animation_count && animation_collections[(int)animation_id].sprite_texture != TEXTURE_ASSET_ID::TEXTURE_COUNT);
+		return animation_collections[(int)animation_id];
+	}
 private:
 	GLFWwindow* window = nullptr;
 
 	/* Animation Clip Collections :
-	* Key:		Animation ID
-	* Value:	Spritesheet texture id, type (cycle vs freeze on last), frame count, one cycle duration
+	* Index:	Animation ID
+	* Value:	Spritesheet texture id, type (cycle vs freeze on last), frame count, one cycle duration,
+	*			then the follow-up clip or end event of cutscene and multi-sheet clips
 	*/ 
-	const std::unordered_map<ANIMATION_ID, AnimationConfig> animation_collections = {
-
-		{ANIMATION_ID::INTRO_1, AnimationConfig(TEXTURE_ASSET_ID::INTRO_1, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_2, AnimationConfig(TEXTURE_ASSET_ID::INTRO_2, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_3, AnimationConfig(TEXTURE_ASSET_ID::INTRO_3, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_4, AnimationConfig(TEXTURE_ASSET_ID::INTRO_4, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_5, AnimationConfig(TEXTURE_ASSET_ID::INTRO_5, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_6, AnimationConfig(TEXTURE_ASSET_ID::INTRO_6, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_7, AnimationConfig(TEXTURE_ASSET_ID::INTRO_7, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_8, AnimationConfig(TEXTURE_ASSET_ID::INTRO_8, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_9, AnimationConfig(TEXTURE_ASSET_ID::INTRO_9, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_10, AnimationConfig(TEXTURE_ASSET_ID::INTRO_10, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_11, AnimationConfig(TEXTURE_ASSET_ID::INTRO_11, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_12, AnimationConfig(TEXTURE_ASSET_ID::INTRO_12, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_13, AnimationConfig(TEXTURE_ASSET_ID::INTRO_13, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_14, AnimationConfig(TEXTURE_ASSET_ID::INTRO_14, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_15, AnimationConfig(TEXTURE_ASSET_ID::INTRO_15, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_16, AnimationConfig(TEXTURE_ASSET_ID::INTRO_16, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_17, AnimationConfig(TEXTURE_ASSET_ID::INTRO_17, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_18, AnimationConfig(TEXTURE_ASSET_ID::INTRO_18, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_19, AnimationConfig(TEXTURE_ASSET_ID::INTRO_19, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_20, AnimationConfig(TEXTURE_ASSET_ID::INTRO_20, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_21, AnimationConfig(TEXTURE_ASSET_ID::INTRO_21, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_22, AnimationConfig(TEXTURE_ASSET_ID::INTRO_22, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0)},
-		{ANIMATION_ID::INTRO_23, AnimationConfig(TEXTURE_ASSET_ID::INTRO_23, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 7, 800.0)},
-
-
-
-		{ANIMATION_ID::OUTRO_1, AnimationConfig(TEXTURE_ASSET_ID::OUTRO_1, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 25, 3000.0)},
-		{ANIMATION_ID::OUTRO_2, AnimationConfig(TEXTURE_ASSET_ID::OUTRO_2, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 25, 3000.0)},
-		{ANIMATION_ID::OUTRO_3, AnimationConfig(TEXTURE_ASSET_ID::OUTRO_3, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 25, 3000.0)},
-		{ANIMATION_ID::OUTRO_4, AnimationConfig(TEXTURE_ASSET_ID::OUTRO_4, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 16, 2000.0)},
+	inline static const std::array<AnimationConfig, animation_count> animation_collections = index_clips({
+
+		{ANIMATION_ID::INTRO_1, AnimationConfig(TEXTURE_ASSET_ID::INTRO_1, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_2)},
+		{ANIMATION_ID::INTRO_2, AnimationConfig(TEXTURE_ASSET_ID::INTRO_2, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_3)},
+		{ANIMATION_ID::INTRO_3, AnimationConfig(TEXTURE_ASSET_ID::INTRO_3, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_4)},
+		{ANIMATION_ID::INTRO_4, AnimationConfig(TEXTURE_ASSET_ID::INTRO_4, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_5)},
+		{ANIMATION_ID::INTRO_5, AnimationConfig(TEXTURE_ASSET_ID::INTRO_5, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_6)},
+		{ANIMATION_ID::INTRO_6, AnimationConfig(TEXTURE_ASSET_ID::INTRO_6, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_7)},
+		{ANIMATION_ID::INTRO_7, AnimationConfig(TEXTURE_ASSET_ID::INTRO_7, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_8)},
+		{ANIMATION_ID::INTRO_8, AnimationConfig(TEXTURE_ASSET_ID::INTRO_8, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_9)},
+		{ANIMATION_ID::INTRO_9, AnimationConfig(TEXTURE_ASSET_ID::INTRO_9, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_10)},
+		{ANIMATION_ID::INTRO_10, AnimationConfig(TEXTURE_ASSET_ID::INTRO_10, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_11)},
+		{ANIMATION_ID::INTRO_11, AnimationConfig(TEXTURE_ASSET_ID::INTRO_11, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_12)},
+		{ANIMATION_ID::INTRO_12, AnimationConfig(TEXTURE_ASSET_ID::INTRO_12, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_13)},
+		{ANIMATION_ID::INTRO_13, AnimationConfig(TEXTURE_ASSET_ID::INTRO_13, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_14)},
+		{ANIMATION_ID::INTRO_14, AnimationConfig(TEXTURE_ASSET_ID::INTRO_14, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_15)},
+		{ANIMATION_ID::INTRO_15, AnimationConfig(TEXTURE_ASSET_ID::INTRO_15, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_16)},
+		{ANIMATION_ID::INTRO_16, AnimationConfig(TEXTURE_ASSET_ID::INTRO_16, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_17)},
+		{ANIMATION_ID::INTRO_17, AnimationConfig(TEXTURE_ASSET_ID::INTRO_17, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_18)},
+		{ANIMATION_ID::INTRO_18, AnimationConfig(TEXTURE_ASSET_ID::INTRO_18, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_19)},
+		{ANIMATION_ID::INTRO_19, AnimationConfig(TEXTURE_ASSET_ID::INTRO_19, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_20)},
+		{ANIMATION_ID::INTRO_20, AnimationConfig(TEXTURE_ASSET_ID::INTRO_20, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_21)},
+		{ANIMATION_ID::INTRO_21, AnimationConfig(TEXTURE_ASSET_ID::INTRO_21, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_22)},
+		{ANIMATION_ID::INTRO_22, AnimationConfig(TEXTURE_ASSET_ID::INTRO_22, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 10, 1100.0).then(ANIMATION_ID::INTRO_23)},
+		{ANIMATION_ID::INTRO_23, AnimationConfig(TEXTURE_ASSET_ID::INTRO_23, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 7, 800.0).ending(ANIMATION_EVENT_ID::END_CUTSCENE)},
+
+
+
+		{ANIMATION_ID::OUTRO_1, AnimationConfig(TEXTURE_ASSET_ID::OUTRO_1, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 25, 3000.0).then(ANIMATION_ID::OUTRO_2)},
+		{ANIMATION_ID::OUTRO_2, AnimationConfig(TEXTURE_ASSET_ID::OUTRO_2, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 25, 3000.0).then(ANIMATION_ID::OUTRO_3)},
+		{ANIMATION_ID::OUTRO_3, AnimationConfig(TEXTURE_ASSET_ID::OUTRO_3, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 25, 3000.0).then(ANIMATION_ID::OUTRO_4)},
+		{ANIMATION_ID::OUTRO_4, AnimationConfig(TEXTURE_ASSET_ID::OUTRO_4, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 16, 2000.0).ending(ANIMATION_EVENT_ID::END_CUTSCENE)},
 
 		{ANIMATION_ID::PLAYER_WALKING, AnimationConfig(TEXTURE_ASSET_ID::PLAYER_WALKING_V1, ANIMATION_TYPE_ID::CYCLE , 13, 300.0)},
 		{ANIMATION_ID::PLAYER_STANDING, AnimationConfig(TEXTURE_ASSET_ID::PLAYER_STANDING_V1, ANIMATION_TYPE_ID::CYCLE , 1, 450.0)},
@@ -107,15 +165,17 @@ private:
 		{ANIMATION_ID::BROKEN_PARTS, AnimationConfig(TEXTURE_ASSET_ID::BROKEN_PARTS, ANIMATION_TYPE_ID::FREEZE_ON_RANDOM , 3, 1.0)},
 
 		{ANIMATION_ID::DECEL_BAR, AnimationConfig(TEXTURE_ASSET_ID::DECEL_BAR, ANIMATION_TYPE_ID::FREEZE , 72, 1.0)},
-		{ANIMATION_ID::ROLLING_THING_1, AnimationConfig(TEXTURE_ASSET_ID::ROLLING_THING_1, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 17, 515.1515151515)},
-		{ANIMATION_ID::ROLLING_THING_2, AnimationConfig(TEXTURE_ASSET_ID::ROLLING_THING_2, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 17, 515.1515151515)},
-        {ANIMATION_ID::ROLLING_THING_3, AnimationConfig(TEXTURE_ASSET_ID::ROLLING_THING_3, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 17, 515.1515151515)},
-        {ANIMATION_ID::ROLLING_THING_4, AnimationConfig(TEXTURE_ASSET_ID::ROLLING_THING_4, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 15, 454.5454545455)},
+		// one 66 frame loop, split because the spritesheet is larger than the max texture size
+		{ANIMATION_ID::ROLLING_THING_1, AnimationConfig(TEXTURE_ASSET_ID::ROLLING_THING_1, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 17, 515.1515151515).then(ANIMATION_ID::ROLLING_THING_2)},
+		{ANIMATION_ID::ROLLING_THING_2, AnimationConfig(TEXTURE_ASSET_ID::ROLLING_THING_2, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 17, 515.1515151515).then(ANIMATION_ID::ROLLING_THING_3).in_sequence_at(17)},
+		{ANIMATION_ID::ROLLING_THING_3, AnimationConfig(TEXTURE_ASSET_ID::ROLLING_THING_3, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 17, 515.1515151515).then(ANIMATION_ID::ROLLING_THING_4).in_sequence_at(34)},
+		{ANIMATION_ID::ROLLING_THING_4, AnimationConfig(TEXTURE_ASSET_ID::ROLLING_THING_4, ANIMATION_TYPE_ID::FREEZE_ON_LAST , 15, 454.5454545455).then(ANIMATION_ID::ROLLING_THING_1).in_sequence_at(51)},
 
 		{ANIMATION_ID::CRACKING_RADIAL, AnimationConfig(TEXTURE_ASSET_ID::CRACKING_RADIAL, ANIMATION_TYPE_ID::FREEZE , 6, 1.0f)},
-		{ANIMATION_ID::CRACKING_RADIAL, AnimationConfig(TEXTURE_ASSET_ID::CRACKING_RADIAL, ANIMATION_TYPE_ID::FREEZE , 6, 1.0f)},
-	};
+	});
 
 	void updateTimer(AnimateRequest &animateRequest, const AnimationConfig& animationConfig, float elapsed_ms);
+	void end_clip(Entity entity, AnimateRequest& animateRequest, const AnimationConfig& animationConfig);
 	void update_rolling_things(float elapsed_ms);
+	void destroy_oldest_rolling_platform(RollingThing& rolling_thing);
 };
\ No newline at end of file
@@ -360,6 +360,7 @@ void boss_one_exhausted_step(Entity& boss_entity, Boss& boss, Motion& boss_motio
         if (registry.snoozeButtons.size() > 0 && registry.motions.has(registry.snoozeButtons.entities[0])) {
             const vec2 snooze_button_pos = registry.motions.get(registry.snoozeButtons.entities[0]).position;
             // Emit particles
+            ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_AURA);
             for (int i = 0; i < 30; i++) {
                 ParticleSystem::spawn_particle(BOSS_EXHAUST_HALO,
                     snooze_button_pos, 0.0f,
@@ -397,6 +398,7 @@ void boss_one_exhausted_step(Entity& boss_entity, Boss& boss, Motion& boss_motio
     // Breath particles
     if ((BOSS_EXHALE_PERIOD_MS - ((int)boss.timer_ms % (int)BOSS_EXHALE_PERIOD_MS)) < 50.0f) {
         // Reuse Coyote particle
+        ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_AURA);
         ParticleSystem::spawn_particle(PARTICLE_ID::EXHALE,
             boss_motion.position + vec2{0.0, 12.0f}, 0.0f, rand_float(0.5f, 1.0f) * vec2(16.0f),
             vec2{ rand_float(-25.0f, 25.0f), rand_float(10.0f, 15.0f) }, 1200.0f, 0.35f,
@@ -423,6 +425,7 @@ void boss_one_recover_step(Entity& boss_entity, Boss& boss, Motion& boss_motion,
 
     // Emit particles
     if (rand_float() < 0.1f) {
+        ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_AURA);
         ParticleSystem::spawn_particle(BOSS_RECOVER_HALO,
             random_sample_rectangle(boss_motion.position + vec2{0.0f, boss_motion.scale.y * 0.4f }, vec2{ boss_motion.scale.x, 30.0f }), 0.0f,
             vec2(0.8f, rand_float(15.f, 25.f)), vec2{0.0f, rand_float(-60.0f, -35.f)},
@@ -556,6 +559,7 @@ void boss_one_delayed_projectile_step(Entity& boss_entity, Boss& boss, Motion& b
         float angle_offset = M_PI / 3.0f * sinf(boss.timer_ms * 0.01f);
 
         vec2 direction_right = angle_to_direction(ANGLE_RIGHT + angle_offset);
+        ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_AURA);
         ParticleSystem::spawn_particle(BOSS_SUMMONING_HALO,
             boss_motion.position + vec2{ boss_motion.scale.x/3.0f, -5.0f }, 0.0, vec2(2.5f), 
             direction_right * 65.0f + 10.0f * rand_direction(), 500.0f, 0.8f, {0.0, 250.0f}, {50.0f, 0.0f});
@@ -600,6 +604,7 @@ void boss_one_dash_step(Entity& boss_entity, Boss& boss, Motion& boss_motion, fl
         vec2 position = random_sample_ellipse(boss_motion.position + vec2{ BOSS_ONE_BB_WIDTH_PX * 0.5f, 0.0f }, vec2{ BOSS_ONE_BB_WIDTH_PX * 0.5f, BOSS_ONE_BB_HEIGHT_PX});
         float angle = (left ? 180.0f : 0.0f) + rand_float(-5.f, 5.f);
 
+        ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_AURA);
         ParticleSystem::spawn_particle(BOSS_DASH_HALO,
             position, angle, vec2{ factor * 25.0f, 1.5f } * rand_float(0.8f, 1.2f), 
             angle_to_direction(angle) * rand_float(-10.0f, -5.0f), 200.0f, 0.8f, {50.0f, 100.0f}, {50.0f, 50.f});
@@ -684,6 +689,7 @@ void boss_one_ground_slam_follow_1_step(Entity& boss_entity, Boss& boss, Motion&
         AnimateRequest& animateRequest = registry.animateRequests.get(boss_entity);
         animateRequest.used_animation = ANIMATION_ID::BOSS_ONE_GROUND_SLAM_FALL;
 
+        ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_TELEGRAPH);
         ParticleSystem::spawn_particle(PARTICLE_ID::CROSS_STAR,
             boss_motion.position, 0.0f, boss_motion.scale * 1.5f, vec2(0.0f), DELAYED_PROJ_SIGNAL_DURATION_MS, 1.0f,
             { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.0f }, { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.9f * DELAYED_PROJ_SIGNAL_DURATION_MS });
@@ -846,6 +852,7 @@ void boss_one_ground_slam_follow_2_step(Entity& boss_entity, Boss& boss, Motion&
         AnimateRequest& animateRequest = registry.animateRequests.get(boss_entity);
         animateRequest.used_animation = ANIMATION_ID::BOSS_ONE_GROUND_SLAM_FALL;
 
+        ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_TELEGRAPH);
         ParticleSystem::spawn_particle(PARTICLE_ID::CROSS_STAR,
             boss_motion.position, 0.0f, boss_motion.scale * 1.5f, vec2(0.0f), DELAYED_PROJ_SIGNAL_DURATION_MS, 1.0f,
             { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.0f }, { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.9f * DELAYED_PROJ_SIGNAL_DURATION_MS });
@@ -1005,6 +1012,7 @@ void boss_one_ground_slam_follow_3_step(Entity& boss_entity, Boss& boss, Motion&
         AnimateRequest& animateRequest = registry.animateRequests.get(boss_entity);
         animateRequest.used_animation = ANIMATION_ID::BOSS_ONE_GROUND_SLAM_FALL;
 
+        ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_TELEGRAPH);
         ParticleSystem::spawn_particle(PARTICLE_ID::CROSS_STAR,
             boss_motion.position, 0.0f, boss_motion.scale * 1.5f, vec2(0.0f), DELAYED_PROJ_SIGNAL_DURATION_MS, 1.0f,
             { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.0f }, { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.9f * DELAYED_PROJ_SIGNAL_DURATION_MS });
@@ -1195,6 +1203,7 @@ void boss_one_regular_projectile_attack(Entity& boss_entity, Boss& boss, Motion&
             create_projectile(pos, size, velocity);
 
             // Particle effects
+            ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_TELEGRAPH);
             ParticleSystem::emit_elliptical_particles(pos, vec2{ 0.6f, 1.0f }, 0.0f, 30, 100.0f, vec2(0.0f), vec3{ 1.0f, 0.0, 0.0 }, 2.0f, 350.0f);
 
             firstBoss.num_of_projectiles_created++;
@@ -1236,6 +1245,7 @@ void boss_one_fast_projectile_attack(Entity& boss_entity, Boss& boss, Motion& bo
             create_projectile(pos, size, velocity);
 
             // Particle effects
+            ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_TELEGRAPH);
             ParticleSystem::emit_elliptical_particles(pos, vec2{ 0.6f, 1.0f }, 0.0f, 30, 100.0f, vec2(0.0f), vec3{ 1.0f, 0.0, 0.0 }, 2.0f, 350.0f);
 
             firstBoss.num_of_projectiles_created++;
@@ -1273,6 +1283,7 @@ void create_delayed_projectile(vec2 pos, float timer_ms) {
     delayed.timer_ms = timer_ms;
 
     // Particle effects
+    ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::HAZARD_WARNING);
     ParticleSystem::emit_elliptical_particles(pos, vec2(1.0f), 0.0f, 45, 80.0f, vec2(0.0f), BOSS_SUMMONING_HALO, 3.0f, 350.0f);
 }
 
@@ -1345,6 +1356,7 @@ void choose_dash_attack_test(Entity& boss_entity, Boss& boss, Motion& boss_motio
     AnimateRequest& animateRequest = registry.animateRequests.get(boss_entity);
     animateRequest.used_animation = ANIMATION_ID::BOSS_ONE_DASH;
 
+    ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_TELEGRAPH);
     ParticleSystem::spawn_particle(PARTICLE_ID::CROSS_STAR,
         boss_motion.position, 0.0f, boss_motion.scale * 1.5f, vec2(0.0f), DELAYED_PROJ_SIGNAL_DURATION_MS, 1.0f,
         { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.0f }, { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.9f * DELAYED_PROJ_SIGNAL_DURATION_MS });
@@ -1413,6 +1425,7 @@ void transition_to_attack_state(Entity& boss_entity, Boss& boss, Motion& boss_mo
         AnimateRequest& animateRequest = registry.animateRequests.get(boss_entity);
         animateRequest.used_animation = ANIMATION_ID::BOSS_ONE_DASH;
 
+        ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_TELEGRAPH);
         ParticleSystem::spawn_particle(PARTICLE_ID::CROSS_STAR,
             boss_motion.position, 0.0f, boss_motion.scale * 1.5f, vec2(0.0f), DELAYED_PROJ_SIGNAL_DURATION_MS, 1.0f,
             { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.0f }, { 0.1f * DELAYED_PROJ_SIGNAL_DURATION_MS, 0.9f * DELAYED_PROJ_SIGNAL_DURATION_MS });
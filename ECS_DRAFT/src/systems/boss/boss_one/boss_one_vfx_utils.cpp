@@ -59,6 +59,7 @@ void update_boss_halo(const Entity boss_entity, const Boss& boss) {
 void emit_broken_parts(const Motion& boss_motion) {
     vec2 position = random_sample_ellipse(boss_motion.position - vec2{ 0.0, 30.0f }, boss_motion.scale - vec2{0.0, 15.0f});
 
+    ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_DAMAGE);
     ParticleSystem::spawn_particle(PARTICLE_ID::BROKEN_PARTS,
         position, 0.0f,
         rand_float(0.8f, 1.2f) * vec2(16.0f), vec2{ 5.f * (position.x - boss_motion.position.x), rand_float(-150.0f, -100.0f) },
@@ -66,6 +67,7 @@ void emit_broken_parts(const Motion& boss_motion) {
 }
 
 void slam_effect(const Motion& boss_motion) {
+    ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_DAMAGE);
     // Crack particle
     
     float ground_level = BOSS_ONE_ON_GROUND_Y_POSITION + 0.5f * BOSS_ONE_BB_HEIGHT_PX;
@@ -98,6 +100,7 @@ void emit_gathering_particle(vec2 center, float radius, float life, vec3 color)
 
     vec2 position = center + radius * offset_direction;
 
+    ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::BOSS_TELEGRAPH);
     ParticleSystem::spawn_particle(color,
         position, 0.0f,
         vec2(2.5f), -offset_direction * speed * 1000.0f,
@@ -0,0 +1,53 @@
+#include "level_batch.hpp"
+#include "../world/world_init.hpp"
+
+bool LevelBatch::batched(LEVEL_SECTION_ID section) {
+    return section == LEVEL_SECTION_ID::COLLIDERS || section == LEVEL_SECTION_ID::CHECKPOINTS ||
+        section == LEVEL_SECTION_ID::CLOCK_HOLES;
+}
+
+void LevelBatch::build(const LevelView& level, LEVEL_SECTION_ID section, uint32_t first, uint32_t count, unsigned int first_id) {
+    assert(batched(section));
+    created_entities.assign(count, 1);
+
+    for (uint32_t i = 0; i < count; i++) {
+        Sink sink = { *this, first_id + i };
+        switch (section) {
+        case LEVEL_SECTION_ID::COLLIDERS: {
+            const LevelColliderRecord& collider = level.records<LevelColliderRecord>(section).first[first + i];
+            switch (collider.kind) {
+            case LEVEL_COLLIDER_KIND::LEVEL_BOUNDARY:
+                level_boundary_components(sink, collider.position, collider.size);
+                break;
+            case LEVEL_COLLIDER_KIND::PLATFORM:
+                static_collider_components(sink, collider.position, collider.size);
+                break;
+            case LEVEL_COLLIDER_KIND::SPIKE:
+                spike_collider_components(sink, collider.position, collider.size);
+                break;
+            default:
+                // world boundaries are created with the background
+                created_entities[i] = 0;
+                break;
+            }
+            break;
+        }
+        case LEVEL_SECTION_ID::CHECKPOINTS: {
+            const LevelPointRecord& checkpoint = level.records<LevelPointRecord>(section).first[first + i];
+            spawnpoint_components(sink, checkpoint.position, SPAWNPOINT_SCALE);
+            break;
+        }
+        case LEVEL_SECTION_ID::CLOCK_HOLES: {
+            const LevelBoxRecord& clock_hole = level.records<LevelBoxRecord>(section).first[first + i];
+            clock_hole_components(sink, clock_hole.position, clock_hole.size);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+void LevelBatch::insert() {
+    std::apply([](auto&... column) { (column.insert(), ...); }, columns);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <tuple>
+#include <vector>
+#include "level_format.hpp"
+#include "tinyECS/registry.hpp"
+
+// The components of a run of a level's plain records (colliders, clock holes, checkpoints). Building
+// one touches nothing but the batch, so batches are built on worker threads while a level loads;
+// insert() then hands each component type to its container in one insert_range on the main thread.
+// The component sets come from the same *_components helpers the create_ functions use.
+class LevelBatch
+{
+public:
+    // Sections instantiated through batches; each of their records makes one entity or none
+    static bool batched(LEVEL_SECTION_ID section);
+
+    // Builds the components of records [first, first + count) of section, whose entities take the
+    // ids from first_id on, one per record
+    void build(const LevelView& level, LEVEL_SECTION_ID section, uint32_t first, uint32_t count, unsigned int first_id);
+    void insert();
+
+    // Whether the i-th record of the batch made an entity
+    bool created(uint32_t i) const { return created_entities[i]; }
+
+private:
+    // Components of one type bound for the container they were added for
+    template <typename Component>
+    struct Column {
+        ComponentContainer<Component>* container = nullptr;
+        std::vector<unsigned int> ids;
+        std::vector<Component> values;
+
+        Component& add(ComponentContainer<Component>& target, unsigned int id) {
+            // one container per component type, the batch does not tell two apart
+            assert(container == nullptr || container == &target);
+            container = &target;
+            ids.push_back(id);
+            return values.emplace_back();
+        }
+
+        void insert() {
+            if (container != nullptr) {
+                container->insert_range(ids.data(), values.data(), (unsigned int)ids.size());
+            }
+            ids.clear();
+            values.clear();
+        }
+    };
+
+    // Sink for the *_components helpers that adds to the batch's columns
+    struct Sink {
+        LevelBatch& batch;
+        unsigned int id;
+
+        template <typename Component>
+        Component& add(ComponentContainer<Component>& container) {
+            return std::get<Column<Component>>(batch.columns).add(container, id);
+        }
+    };
+
+    // in insertion order
+    std::tuple<
+        Column<Motion>,
+        Column<Platform>,
+        Column<PhysicsObject>,
+        Column<Spike>,
+        Column<NonPhysicsCollider>,
+        Column<ClockHole>,
+        Column<SpawnPoint>,
+        Column<RenderRequest>,
+        Column<Layer>> columns;
+    std::vector<char> created_entities;
+};
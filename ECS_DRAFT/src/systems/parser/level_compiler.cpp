@@ -0,0 +1,800 @@
+#include <iostream>
+#include <filesystem>
+#include <cstring>
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+#include "level_compiler.hpp"
+#include "../../frame_arena.hpp"
+#include "../../worker_pool.hpp"
+
+namespace {
+    // Joins boxes that touch end to end along one axis and cover the same band on the other
+    void merge_along_axis(vector<LevelBoxRecord>& boxes, int axis) {
+        const int other = 1 - axis;
+        std::sort(boxes.begin(), boxes.end(), [axis, other](const LevelBoxRecord& a, const LevelBoxRecord& b) {
+            if (a.position[other] != b.position[other]) return a.position[other] < b.position[other];
+            if (a.size[other] != b.size[other]) return a.size[other] < b.size[other];
+            return a.position[axis] < b.position[axis];
+        });
+
+        vector<LevelBoxRecord> merged;
+        for (const LevelBoxRecord& box : boxes) {
+            if (!merged.empty()) {
+                LevelBoxRecord& last = merged.back();
+                const float start = last.position[axis] - 0.5f * last.size[axis];
+                const float last_end = last.position[axis] + 0.5f * last.size[axis];
+                const float box_start = box.position[axis] - 0.5f * box.size[axis];
+                const float box_end = box.position[axis] + 0.5f * box.size[axis];
+                if (last.position[other] == box.position[other] && last.size[other] == box.size[other] &&
+                    abs(last_end - box_start) < 0.01f) {
+                    last.position[axis] = 0.5f * (start + box_end);
+                    last.size[axis] = box_end - start;
+                    continue;
+                }
+            }
+            merged.push_back(box);
+        }
+        boxes.swap(merged);
+    }
+
+    // Greedy: rows first, then the rows that stack into columns
+    void merge_boxes(vector<LevelBoxRecord>& boxes) {
+        merge_along_axis(boxes, 0);
+        merge_along_axis(boxes, 1);
+    }
+
+    // Entities created for a record when its chunk is activated: the record's own, and its tiles
+    uint32_t chunk_entity_count(const LevelBoxRecord&) {
+        return 1;
+    }
+
+    uint32_t chunk_entity_count(const LevelPlatformRecord& record) {
+        return 1 + (uint32_t)(record.size.x / TILE_TO_PIXELS);
+    }
+
+    // Static colliders of a compiled level as they were placed in LDtk, and after merging
+    void count_static_colliders(const LevelView& level, uint32_t& placed, uint32_t& merged) {
+        placed = level.records<LevelPlatformRecord>(LEVEL_SECTION_ID::PIPE_PARTS).size() +
+            level.records<LevelBoxRecord>(LEVEL_SECTION_ID::SPIKES).size();
+        for (const LevelPlatformRecord& platform : level.records<LevelPlatformRecord>(LEVEL_SECTION_ID::PLATFORMS)) {
+            placed += platform.rounded ? 0 : 1;
+        }
+
+        merged = 0;
+        for (const LevelColliderRecord& collider : level.records<LevelColliderRecord>(LEVEL_SECTION_ID::COLLIDERS)) {
+            merged += collider.kind == LEVEL_COLLIDER_KIND::PLATFORM || collider.kind == LEVEL_COLLIDER_KIND::SPIKE;
+        }
+    }
+}
+
+/*
+ * COMPILING A LEVEL
+ */
+
+bool LevelCompiler::compile(const json& json_data, uint64_t source_hash, std::vector<unsigned char>& compiled) {
+    const bool compiled_ok = compile_level_to(json_data, source_hash, compiled);
+    cout << parsing_errors;
+    parsing_errors.clear();
+    return compiled_ok;
+}
+
+bool LevelCompiler::compile_level_to(const json& json_data, uint64_t source_hash, std::vector<unsigned char>& compiled) {
+    // a required key missing from the export fails the level instead of the game
+    try {
+        if (!compile_level(json_data)) {
+            return false;
+        }
+    } catch (const json::exception& e) {
+        string error = e.what();
+        print_parsing_error(error, level_name);
+        return false;
+    }
+
+    writer.finish(source_hash, compiled);
+    return true;
+}
+
+bool LevelCompiler::compile_level(const json& json_data) {
+    LevelFileHeader& header = writer.header();
+
+    const json& json_width = field(json_data, "width");
+    const json& json_height = field(json_data, "height");
+    if (!json_width.is_number() || !json_height.is_number()) {
+        string error = "missing level dimensions";
+        print_parsing_error(error, level_name);
+        return false;
+    }
+    header.width = json_width;
+    header.height = json_height;
+    header.stride = header.width / TILE_TO_PIXELS;
+    level_dimensions = vec2{ header.width, header.height };
+
+    const json& json_identifier = field(json_data, "identifier");
+    string identifier = json_identifier.is_string() ? json_identifier.get<string>() : level_name;
+    const json& next_levels = field(json_data, "neighbourLevels");
+    string next_level = next_levels.empty() ? "" : next_levels[0].get<string>();
+    if (identifier.size() >= sizeof(header.identifier) || next_level.size() >= sizeof(header.next_level)) {
+        string error = "level name too long";
+        print_parsing_error(error, level_name);
+        return false;
+    }
+    strcpy(header.identifier, identifier.c_str());
+    strcpy(header.next_level, next_level.c_str());
+
+    // levels exported without a tile layer have no tiles
+    const json& layers = field(json_data, "layers");
+    if (!layers.empty() && layers[0].is_object()) {
+        for (const json& tile_id : field(layers[0], "data")) {
+            writer.add(LEVEL_SECTION_ID::TILES, (uint16_t)tile_id.get<int>());
+        }
+    }
+
+    const json& entities = field(json_data, "entities");
+    const json& player_list = field(entities, "Player");
+    if (player_list.empty()) {
+        string error = "no Player entity";
+        print_parsing_error(error, level_name);
+        return false;
+    }
+    const json& playerJson = player_list[0];
+    float player_scale_factor = 1.5f;
+    if (!custom_field(playerJson, "scale").is_null()) {
+        player_scale_factor = custom_field(playerJson, "scale");
+    }
+    header.player_position = vec2(playerJson.at("x"), playerJson.at("y"));
+    header.player_size = { int(playerJson.at("width")) * player_scale_factor, int(playerJson.at("height")) * player_scale_factor };
+
+    compile_world_boundaries();
+    compile_level_entities(entities);
+    compile_static_colliders();
+    compile_chunks();
+    return true;
+}
+
+int LevelCompiler::compile_all() {
+    std::vector<string> level_names;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(PROJECT_SOURCE_DIR + std::string("../LDtk"), error)) {
+        if (entry.is_directory() && std::filesystem::exists(level_data_path(entry.path().filename().string()), error)) {
+            level_names.push_back(entry.path().filename().string());
+        }
+    }
+
+    // levels are independent, each worker parses and compiles whole levels; the reports are
+    // printed afterwards in directory order
+    std::vector<string> reports(level_names.size());
+    std::vector<char> failed(level_names.size(), 0);
+    WorkerPool workers;
+    workers.start(std::max(1, std::min((int)std::thread::hardware_concurrency(), (int)level_names.size())));
+    const auto start = std::chrono::high_resolution_clock::now();
+    workers.run((int)level_names.size(), [&](int i) {
+        failed[i] = !compile_if_stale(level_names[i], reports[i]);
+    });
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    for (const string& report : reports) {
+        cout << report;
+    }
+    cout << level_names.size() << " levels checked on " << workers.threadCount() << " threads in " << elapsed_ms << " ms" << endl;
+    return (int)std::count(failed.begin(), failed.end(), 1);
+}
+
+bool LevelCompiler::compile_if_stale(const string& level_name, string& report) {
+    const string source_path = level_data_path(level_name);
+    MappedFile source;
+    if (!source.open(source_path)) {
+        report = level_name + ": failed\n";
+        return false;
+    }
+
+    const uint64_t source_hash = content_hash(source.data(), source.size());
+    MappedFile existing;
+    LevelView level;
+    uint32_t placed_colliders, merged_colliders;
+    if (load_compiled_level(level_name, source_hash, existing, level)) {
+        count_static_colliders(level, placed_colliders, merged_colliders);
+        report = level_name + ": up to date, " + std::to_string(placed_colliders) + " -> " + std::to_string(merged_colliders) +
+            " static colliders, " + std::to_string(level.records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS).size()) + " chunks\n";
+        return true;
+    }
+
+    std::vector<unsigned char> compiled;
+    json json_data = json::parse(source.data(), source.data() + source.size(), nullptr, false);
+    LevelCompiler compiler(level_name);
+    const bool compiled_ok = !json_data.is_discarded() && compiler.compile_level_to(json_data, source_hash, compiled);
+    report = compiler.parsing_errors;
+    if (!compiled_ok || !store_compiled_level(level_name, compiled)) {
+        report += level_name + ": failed\n";
+        return false;
+    }
+    level.open(compiled.data(), compiled.size(), source_hash);
+    count_static_colliders(level, placed_colliders, merged_colliders);
+    report += level_name + ": " + std::to_string(source.size()) + " -> " + std::to_string(compiled.size()) + " bytes, " +
+        std::to_string(placed_colliders) + " -> " + std::to_string(merged_colliders) + " static colliders, " +
+        std::to_string(level.records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS).size()) + " chunks\n";
+    return true;
+}
+
+void LevelCompiler::run_load_benchmark(int iterations) {
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(PROJECT_SOURCE_DIR + std::string("../LDtk"), error)) {
+        const string level_name = entry.path().filename().string();
+        MappedFile source;
+        if (!entry.is_directory() || !source.open(level_data_path(level_name))) {
+            continue;
+        }
+        const uint64_t source_hash = content_hash(source.data(), source.size());
+
+        // from the export, as a load without a compiled copy does it
+        std::vector<unsigned char> compiled;
+        size_t heap_mark = heap_allocation_count();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            json json_data = json::parse(source.data(), source.data() + source.size(), nullptr, false);
+            LevelCompiler(level_name).compile(json_data, source_hash, compiled);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        const double export_ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+        const size_t export_allocations = (heap_allocation_count() - heap_mark) / iterations;
+
+        if (!store_compiled_level(level_name, compiled)) {
+            cout << level_name << ": could not store compiled level" << endl;
+            continue;
+        }
+
+        heap_mark = heap_allocation_count();
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            MappedFile compiled_file;
+            LevelView level;
+            load_compiled_level(level_name, source_hash, compiled_file, level);
+        }
+        end = std::chrono::high_resolution_clock::now();
+        const double compiled_ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+        const size_t compiled_allocations = (heap_allocation_count() - heap_mark) / iterations;
+
+        if (heap_allocations_counted) {
+            printf("%s: export %.3f ms, %zu allocations | compiled %.3f ms, %zu allocations\n",
+                level_name.c_str(), export_ms, export_allocations, compiled_ms, compiled_allocations);
+        }
+        else {
+            printf("%s: export %.3f ms | compiled %.3f ms\n", level_name.c_str(), export_ms, compiled_ms);
+        }
+    }
+}
+
+// Every LDtk entity type the compiler knows, with the custom fields it reads in the order its compile
+// function expects them
+const LevelCompiler::EntityType LevelCompiler::entity_types[] = {
+    { "Platform", &LevelCompiler::compile_platform, { {"size"}, {"rounded"} } },
+    { "MovingPlatform", &LevelCompiler::compile_moving_platform, { {"size"}, {"start", true}, {"end", true}, {"duration"}, {"rounded"} } },
+    { "Spike", &LevelCompiler::compile_spike, { {"length", true}, {"direction"} } },
+    { "Door", &LevelCompiler::compile_door, { {"open"} } },
+    { "Projectile", &LevelCompiler::compile_projectile, { {"scale"} } },
+    { "Pipe", &LevelCompiler::compile_pipe, { {"direction"}, {"time_offset"} } },
+    { "PipePart", &LevelCompiler::compile_pipe_part, {} },
+    { "Boundary", &LevelCompiler::compile_boundary, { {"length", true}, {"direction"} } },
+    { "PartOf", &LevelCompiler::compile_partof, {} },
+    { "Cannon", &LevelCompiler::compile_cannon, {} },
+    { "Ladder", &LevelCompiler::compile_ladder, { {"length", true} } },
+    { "Checkpoint", &LevelCompiler::compile_checkpoint, {} },
+    { "Breakable", &LevelCompiler::compile_breakable_platform, { {"size"}, {"direction"} } },
+    { "Chain", &LevelCompiler::compile_chain, {} },
+    { "Pendulum", &LevelCompiler::compile_pendulum, { {"length", true}, {"initial_angle"}, {"bob_radius"} } },
+    { "Gear", &LevelCompiler::compile_gear, { {"gear_edge", true}, {"fixed"}, {"angular_velocity"}, {"initial_angle"} } },
+    { "Spikeball", &LevelCompiler::compile_spikeball, { {"width"}, {"height"} } },
+    { "Obstacle_spawner", &LevelCompiler::compile_spawner, { {"x_velocity"}, {"y_velocity"}, {"width"}, {"height"}, {"start_point", true}, {"end_point", true}, {"Type"} } },
+    { "Rolling_thing", &LevelCompiler::compile_rolling_thing, { {"width"}, {"height"} } },
+    { "Clock_hole", &LevelCompiler::compile_clock_hole, { {"length", true}, {"direction"} } },
+};
+
+const LevelCompiler::EntityType* LevelCompiler::find_entity_type(const string& identifier) {
+    // interned once, each entity group of a file then costs one lookup
+    static const std::unordered_map<std::string_view, const EntityType*> types = []() {
+        std::unordered_map<std::string_view, const EntityType*> types;
+        for (const EntityType& type : entity_types) {
+            types[type.identifier] = &type;
+        }
+        return types;
+    }();
+
+    auto type = types.find(identifier);
+    return type != types.end() ? type->second : nullptr;
+}
+
+void LevelCompiler::compile_level_entities(const json& entities) {
+    EntityFields fields;
+    for (auto& [identifier, entity_list] : entities.items()) {
+        const EntityType* type = find_entity_type(identifier);
+        if (type == nullptr) {
+            continue;
+        }
+        for (const json& entity : entity_list) {
+            if (resolve_fields(*type, entity, fields)) {
+                writer.set_record_key(entity_key(entity));
+                (this->*type->compile)(entity, fields);
+            }
+        }
+    }
+    writer.set_record_key(0);
+}
+
+bool LevelCompiler::resolve_fields(const EntityType& type, const json& entity, EntityFields& fields) {
+    const json& custom_fields = field(entity, "customFields");
+    for (int i = 0; i < ENTITY_FIELD_LIMIT && type.fields[i].name != nullptr; i++) {
+        const FieldSchema& schema = type.fields[i];
+        fields[i] = &field(custom_fields, schema.name);
+        if (schema.point ? !validate_custom_field(*fields[i], schema.name, entity, {"cx", "cy"})
+            : !validate_custom_field(*fields[i], schema.name, entity)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LevelCompiler::compile_world_boundaries() {
+    float world_w = level_dimensions.x;
+    float world_h = level_dimensions.y;
+    float shift_differential = 0.5 * TILE_TO_PIXELS;
+
+    // horizontal world boundaries (top/bottom)
+    writer.add(LEVEL_SECTION_ID::COLLIDERS, LevelColliderRecord{
+        {world_w / 2.0f - shift_differential, 0.0f - (0.25 * world_h) - shift_differential}, {world_w, 1.0f}, LEVEL_COLLIDER_KIND::WORLD_BOUNDARY });
+    writer.add(LEVEL_SECTION_ID::COLLIDERS, LevelColliderRecord{
+        {world_w / 2.0f - shift_differential, world_h + (0.25 * world_h) - shift_differential}, {world_w, 1.0f}, LEVEL_COLLIDER_KIND::WORLD_BOUNDARY });
+
+    // vertical world boundaries (left/right)
+    writer.add(LEVEL_SECTION_ID::COLLIDERS, LevelColliderRecord{
+        {0.0f - shift_differential, world_h / 2.0f - shift_differential}, {1.0f, world_h * 1.5}, LEVEL_COLLIDER_KIND::WORLD_BOUNDARY });
+    writer.add(LEVEL_SECTION_ID::COLLIDERS, LevelColliderRecord{
+        {world_w - shift_differential, world_h / 2.0f - shift_differential}, {1.0f, world_h * 1.5}, LEVEL_COLLIDER_KIND::WORLD_BOUNDARY });
+}
+
+void LevelCompiler::compile_static_colliders() {
+    merge_boxes(platform_boxes);
+    for (const LevelBoxRecord& box : platform_boxes) {
+        writer.add(LEVEL_SECTION_ID::COLLIDERS, LevelColliderRecord{ box.position, box.size, LEVEL_COLLIDER_KIND::PLATFORM });
+    }
+
+    merge_boxes(spike_boxes);
+    for (const LevelBoxRecord& box : spike_boxes) {
+        writer.add(LEVEL_SECTION_ID::COLLIDERS, LevelColliderRecord{ box.position, box.size, LEVEL_COLLIDER_KIND::SPIKE });
+    }
+}
+
+void LevelCompiler::compile_chunks() {
+    std::map<int, LevelChunkRecord> chunks;
+    add_chunked_records(0, partof_records, chunks);
+    add_chunked_records(1, pipe_part_records, chunks);
+    add_chunked_records(2, platform_records, chunks);
+    add_chunked_records(3, spike_records, chunks);
+
+    for (const auto& [index, chunk] : chunks) {
+        writer.add(LEVEL_SECTION_ID::CHUNKS, chunk);
+    }
+}
+
+// Writes records to the slot'th chunked section, sorted by chunk, and extends each chunk's range
+template <typename Record>
+void LevelCompiler::add_chunked_records(int slot, vector<Record>& records, std::map<int, LevelChunkRecord>& chunks) {
+    const LEVEL_SECTION_ID section = level_chunk_sections[slot];
+    std::stable_sort(records.begin(), records.end(), [this](const Record& a, const Record& b) {
+        return chunk_of(a.position) < chunk_of(b.position);
+    });
+
+    for (const Record& record : records) {
+        auto [it, added] = chunks.try_emplace(chunk_of(record.position));
+        LevelChunkRecord& chunk = it->second;
+        if (added) {
+            chunk.min = record.position;
+            chunk.max = record.position;
+        }
+        if (chunk.count[slot] == 0) {
+            chunk.first[slot] = writer.count(section);
+        }
+        chunk.count[slot]++;
+        chunk.min = min(chunk.min, record.position - 0.5f * record.size);
+        chunk.max = max(chunk.max, record.position + 0.5f * record.size);
+        chunk.entity_count += chunk_entity_count(record);
+        writer.add(section, record);
+    }
+}
+
+int LevelCompiler::chunk_of(vec2 position) const {
+    const int chunks_per_row = (int)ceil(level_dimensions.x / LEVEL_CHUNK_SIZE_PX);
+    const int x = std::clamp((int)floor(position.x / LEVEL_CHUNK_SIZE_PX), 0, std::max(chunks_per_row - 1, 0));
+    const int y = std::max((int)floor(position.y / LEVEL_CHUNK_SIZE_PX), 0);
+    return x + y * chunks_per_row;
+}
+
+void LevelCompiler::compile_clock_hole(const json& clock_hole, const EntityFields& fields) {
+    vec2 dimensions;
+    vec2 position;
+    extract_boundary_attributes(clock_hole, fields, dimensions, position);
+    writer.add(LEVEL_SECTION_ID::CLOCK_HOLES, LevelBoxRecord{ position, dimensions });
+}
+
+void LevelCompiler::compile_chain(const json& chain, const EntityFields&) {
+    vec2 position = {chain.at("x"), level_dimensions.y / 2};
+    vec2 scale = {TILE_TO_PIXELS * ceil(level_dimensions.y / 1500), level_dimensions.y};
+    writer.add(LEVEL_SECTION_ID::CHAINS, LevelBoxRecord{ position, scale });
+}
+
+void LevelCompiler::compile_breakable_platform(const json& breakable, const EntityFields& fields) {
+    vec2 size;
+    int full_size = *fields[0];
+    string direction = *fields[1];
+
+    int conversion_factor;
+    bool is_x_axis;
+    if (direction == "up" || direction == "down")
+    {
+        size = {breakable.at("width"), static_cast<int>(breakable.at("height")) * full_size};
+        if (direction == "up") {
+            conversion_factor = (static_cast<int>(breakable.at("height")) / 2) - (static_cast<int>(size.y) / 2);
+        } else {
+            conversion_factor = (static_cast<int>(size.y) / 2) - (static_cast<int>(breakable.at("height")) / 2);
+        }
+        is_x_axis = false;
+    }
+    else
+    {
+        size = {static_cast<int>(breakable.at("width")) * full_size, breakable.at("height")};
+        if (direction == "left") {
+            conversion_factor = (static_cast<int>(breakable.at("width")) / 2) - (static_cast<int>(size.x) / 2);
+        } else {
+            conversion_factor = (static_cast<int>(size.x) / 2) - (static_cast<int>(breakable.at("width")) / 2);
+        }
+        is_x_axis = true;
+    }
+
+    vec2 start_pos = {static_cast<int>(breakable.at("x")) / TILE_TO_PIXELS, static_cast<int>(breakable.at("y")) / TILE_TO_PIXELS};
+    vec2 position = centralize_position(start_pos, conversion_factor, is_x_axis);
+
+    writer.add(LEVEL_SECTION_ID::BREAKABLES, LevelBoxRecord{ position, size });
+}
+
+void LevelCompiler::compile_spawner(const json& gear_spawner, const EntityFields& fields) {
+    LevelSpawnerRecord record = {};
+    record.velocity = vec2{*fields[0], *fields[1]};
+    record.size = vec2{*fields[2], *fields[3]};
+
+    const json& start_point = *fields[4];
+    record.start_position = vec2{start_point.at("cx"), start_point.at("cy")};
+    record.start_position *= TILE_TO_PIXELS;
+
+    const json& end_point = *fields[5];
+    record.end_position = vec2{end_point.at("cx"), end_point.at("cy")};
+    record.end_position *= TILE_TO_PIXELS;
+
+    const std::string& type = fields[6]->get_ref<const std::string&>();
+    if (type.size() >= sizeof(record.type)) {
+        string error = "spawner type too long: " + type;
+        print_parsing_error(error, entity_id(gear_spawner));
+        return;
+    }
+    strcpy(record.type, type.c_str());
+
+    writer.add(LEVEL_SECTION_ID::SPAWNERS, record);
+}
+
+void LevelCompiler::compile_rolling_thing(const json& rolling_thing, const EntityFields& fields) {
+    vec2 position = {rolling_thing.at("x"), rolling_thing.at("y")};
+    vec2 scale = {*fields[0], *fields[1]};
+    writer.add(LEVEL_SECTION_ID::ROLLING_THINGS, LevelBoxRecord{ position, scale });
+}
+
+
+
+void LevelCompiler::compile_pipe(const json& pipe, const EntityFields& fields) {
+    vec2 position = {pipe.at("x"), pipe.at("y")};
+    vec2 scale = {pipe.at("width"), pipe.at("height")};
+
+    LEVEL_DIRECTION direction;
+    if (!extract_direction(*fields[0], direction)) {
+        string error = "unknown direction";
+        print_parsing_error(error, entity_id(pipe));
+        return;
+    }
+    float time_offset = *fields[1];
+    writer.add(LEVEL_SECTION_ID::PIPES, LevelPipeRecord{ position, scale, direction, time_offset });
+}
+
+void LevelCompiler::compile_pipe_part(const json& pipe_part, const EntityFields&) {
+    vec2 position = {pipe_part.at("x"), pipe_part.at("y")};
+    vec2 size = {pipe_part.at("width"), pipe_part.at("height")};
+    pipe_part_records.push_back(LevelPlatformRecord{ position, size, false });
+    platform_boxes.push_back(LevelBoxRecord{ position, size });
+}
+
+
+
+void LevelCompiler::compile_door(const json& door, const EntityFields& fields) {
+    bool open = *fields[0];
+    vec2 position = door_position(door);
+    writer.add(LEVEL_SECTION_ID::DOORS, LevelDoorRecord{ position, open });
+}
+
+void LevelCompiler::compile_checkpoint(const json& checkpoint, const EntityFields&) {
+    vec2 position = {checkpoint.at("x"), static_cast<float>(checkpoint.at("y")) + PARSING_CHECKPOINT_Y_POS_DIFF};
+    writer.add(LEVEL_SECTION_ID::CHECKPOINTS, LevelPointRecord{ position });
+}
+
+
+void LevelCompiler::compile_cannon(const json& cannon, const EntityFields&) {
+    vec2 position = {cannon.at("x"), static_cast<float>(cannon.at("y")) + PARSING_CANNON_Y_POS_DIFF};
+    writer.add(LEVEL_SECTION_ID::CANNONS, LevelPointRecord{ position });
+}
+
+void LevelCompiler::compile_ladder(const json& ladder, const EntityFields& fields) {
+    vec2 position = {ladder.at("x"), ladder.at("y")};
+    int height = abs(static_cast<int>(fields[0]->at("cy")) - (position.y / TILE_TO_PIXELS)) + 1;
+
+    vec2 dimensions = {ladder.at("width"), ladder.at("height")};
+    writer.add(LEVEL_SECTION_ID::LADDERS, LevelLadderRecord{ position, dimensions, height });
+}
+
+void LevelCompiler::compile_pendulum(const json& pendulum, const EntityFields& fields) {
+    vec2 pivot_position = {pendulum.at("x"), pendulum.at("y")};
+    float end_pos_y = fields[0]->at("cy");
+    float length = abs(pivot_position.y - (end_pos_y * TILE_TO_PIXELS));
+    float initial_angle = *fields[1];
+    float bob_radius = *fields[2];
+
+    writer.add(LEVEL_SECTION_ID::PENDULUMS, LevelPendulumRecord{ pivot_position, length, initial_angle, bob_radius });
+}
+
+void LevelCompiler::compile_spikeball(const json& spikeball, const EntityFields& fields) {
+    vec2 position = {spikeball.at("x"), spikeball.at("y")};
+    vec2 size_px = {*fields[0], *fields[1]};
+    writer.add(LEVEL_SECTION_ID::SPIKEBALLS, LevelBoxRecord{ position, size_px });
+}
+
+
+void LevelCompiler::compile_gear(const json& gear, const EntityFields& fields) {
+    vec2 position = {gear.at("x"), gear.at("y")};
+    vec2 gear_edge_pos = {fields[0]->at("cx"), fields[0]->at("cy")};
+    float radius = abs(position.x  - (gear_edge_pos.x * TILE_TO_PIXELS));
+
+    bool fixed = *fields[1];
+    float angular_velocity = *fields[2];
+    float inital_angle = *fields[3];
+
+    vec2 size_px = {radius * 2, radius * 2};
+    writer.add(LEVEL_SECTION_ID::GEARS, LevelGearRecord{ position, size_px, fixed, angular_velocity, inital_angle });
+}
+
+void LevelCompiler::compile_projectile(const json& projectile, const EntityFields& fields) {
+    vec2 position = vec2{projectile.at("x"), projectile.at("y")};
+    float scale = *fields[0];
+    vec2 size = vec2 {scale, scale};
+    // TODO: handle other meshtypes? (some are null in json rn so cannot parse)
+    writer.add(LEVEL_SECTION_ID::PROJECTILES, LevelBoxRecord{ position, size });
+}
+
+void LevelCompiler::compile_boundary(const json& boundary, const EntityFields& fields) {
+    vec2 dimensions;
+    vec2 position;
+    extract_boundary_attributes(boundary, fields, dimensions, position);
+    writer.add(LEVEL_SECTION_ID::COLLIDERS, LevelColliderRecord{ position, dimensions, LEVEL_COLLIDER_KIND::LEVEL_BOUNDARY });
+}
+
+void LevelCompiler::compile_spike(const json& spike, const EntityFields& fields) {
+    const json& json_end_pos = *fields[0];
+    vec2 end_pos = {static_cast<int>(json_end_pos.at("cx")) * TILE_TO_PIXELS, static_cast<int>(json_end_pos.at("cy")) * TILE_TO_PIXELS};
+
+    string direction = *fields[1];
+    bool is_x_axis = direction == "left" || direction == "right";
+    int pos_stride = TILE_TO_PIXELS * (direction == "left" || direction == "up" ? -1 : 1);
+
+    vec2 dimensions = {spike.at("width"), spike.at("height")};
+    vec2 start_pos = {spike.at("x"), spike.at("y")};
+    int num_spikes = is_x_axis ? abs(end_pos.x - start_pos.x) / dimensions.x : abs(end_pos.y - start_pos.y) / dimensions.y;
+
+    for (int i = 0; i <= num_spikes; i++) {
+        vec2 position;
+        if (is_x_axis) {
+            position = {start_pos.x + (i * pos_stride), start_pos.y};
+        } else {
+            position = {start_pos.x, start_pos.y + (i * pos_stride)};
+        }
+        spike_records.push_back(LevelBoxRecord{ position, dimensions });
+        spike_boxes.push_back(LevelBoxRecord{ position, dimensions });
+    }
+}
+
+void LevelCompiler::compile_partof(const json& pf, const EntityFields&) {
+    vec2 dimensions = {pf.at("width"), pf.at("height")};
+    vec2 position = {pf.at("x"), pf.at("y")};
+    partof_records.push_back(LevelBoxRecord{ position, dimensions });
+}
+
+void LevelCompiler::compile_platform(const json& platform, const EntityFields& fields) {
+    vec2 dimensions = full_platform_dimensions(platform, *fields[0]);
+    vec2 start_pos = platform_start_position(platform, dimensions);
+    bool rounded = *fields[1];
+
+    // rounded platforms keep their own collider, its shape follows the edge mesh
+    if (rounded) {
+        writer.add(LEVEL_SECTION_ID::PLATFORMS, LevelPlatformRecord{ start_pos, dimensions, rounded });
+    } else {
+        platform_records.push_back(LevelPlatformRecord{ start_pos, dimensions, rounded });
+        platform_boxes.push_back(LevelBoxRecord{ start_pos, dimensions });
+    }
+}
+
+void LevelCompiler::compile_moving_platform(const json& platform, const EntityFields& fields) {
+    LevelMovingPlatformRecord record;
+    record.size = full_platform_dimensions(platform, *fields[0]);
+
+    // currently all position values in json are relative to leftmost tile in platform -- need to centralize position on x-axis.
+    int conversion_factor = (static_cast<int>(record.size.x) / 2) - (static_cast<int>(platform.at("width")) / 2);
+    record.start = convert_and_centralize_position(*fields[1], conversion_factor);
+    record.end = convert_and_centralize_position(*fields[2], conversion_factor);
+    record.initial_position = platform_start_position(platform, record.size);
+
+    // set duration to default value of 0.5 if no duration is set.
+    float duration = *fields[3];
+    if (duration == 0.0) {
+        duration = 0.5;
+    }
+    record.duration = duration;
+    record.rounded = (bool)*fields[4];
+
+    writer.add(LEVEL_SECTION_ID::MOVING_PLATFORMS, record);
+}
+
+/*
+ * HELPERS FOR EXTRACTING INFORMATION FROM JSON
+ */
+
+vec2 LevelCompiler::door_position(const json& door) {
+    int x_start = static_cast<float>(door.at("x")) - (0.5 * TILE_TO_PIXELS);
+    int y_start = static_cast<float>(door.at("y")) + (0.5 * TILE_TO_PIXELS);
+
+    int x = x_start + (0.5 * DOOR_SIZE.x);
+    int y = y_start - (0.5 * DOOR_SIZE.y);
+
+    return {x, y};
+}
+
+bool LevelCompiler::extract_direction(const json& direction, LEVEL_DIRECTION& level_direction) {
+    for (int i = 0; i < (int)LEVEL_DIRECTION::LEVEL_DIRECTION_COUNT; i++) {
+        if (direction.is_string() && direction.get_ref<const string&>() == level_direction_name((LEVEL_DIRECTION)i)) {
+            level_direction = (LEVEL_DIRECTION)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void LevelCompiler::extract_boundary_attributes(const json& boundary, const EntityFields& fields, vec2& dimensions, vec2& position) {
+    int x = boundary.at("x");
+    int y = boundary.at("y");
+    vec2 start_pos = vec2{x / TILE_TO_PIXELS, y / TILE_TO_PIXELS};
+
+    const json& end_pos_json = *fields[0];
+    vec2 end_pos = {end_pos_json.at("cx"), end_pos_json.at("cy")};
+
+    int size;
+    string direction = *fields[1];
+
+    int conversion_factor;
+    bool is_x_axis;
+    if (direction == "up" || direction == "down")
+    {
+        size = abs(end_pos.y - start_pos.y) + 1;
+        dimensions = {boundary.at("width"), static_cast<int>(boundary.at("height")) * size};
+
+        if (direction == "up") {
+            conversion_factor = (static_cast<int>(boundary.at("height")) / 2) - (static_cast<int>(dimensions.y) / 2);
+        } else {
+            conversion_factor = (static_cast<int>(dimensions.y) / 2) - (static_cast<int>(boundary.at("height")) / 2);
+        }
+        is_x_axis = false;
+    }
+    else
+    {
+        size = abs(end_pos.x - start_pos.x) + 1;
+        dimensions = {static_cast<int>(boundary.at("width")) * size, boundary.at("height")};
+
+        if (direction == "left") {
+            conversion_factor = (static_cast<int>(boundary.at("width")) / 2) - (static_cast<int>(dimensions.x) / 2);
+        } else {
+            conversion_factor = (static_cast<int>(dimensions.x) / 2) - (static_cast<int>(boundary.at("width")) / 2);
+        }
+        is_x_axis = true;
+    }
+
+    position = centralize_position(start_pos, conversion_factor, is_x_axis);
+}
+
+
+vec2 LevelCompiler::full_platform_dimensions(const json& platform, const json& size) {
+    int full_size = size;
+    int full_width = full_size * static_cast<int>(platform.at("width"));
+    return {full_width, platform.at("height")};
+}
+
+vec2 LevelCompiler::platform_start_position(const json& platform, vec2 dimensions) {
+    int left_x = static_cast<int>(platform.at("x")) - (static_cast<int>(platform.at("width")) / 2);
+    int start_x = left_x + (static_cast<int>(dimensions[0]) / 2);
+    return {start_x, platform.at("y")};
+}
+
+/*
+ * OTHER HELPERS
+ */
+
+vec2 LevelCompiler::convert_and_centralize_position(const json& pos, int conversion_factor) {
+    return vec2({
+        static_cast<int>(pos.at("cx")) * TILE_TO_PIXELS + conversion_factor,
+        static_cast<int>(pos.at("cy")) * TILE_TO_PIXELS
+    });
+}
+
+vec2 LevelCompiler::centralize_position(vec2 pos, int conversion_factor, bool is_x_axis) {
+    return vec2({
+        pos.x * TILE_TO_PIXELS + (is_x_axis ? conversion_factor : 0),
+        pos.y * TILE_TO_PIXELS + (!is_x_axis ? conversion_factor : 0)
+    });
+}
+
+const json& LevelCompiler::field(const json& object, const char* key) {
+    // missing keys read as null, as they do through the non-const operator[]
+    static const json null_field;
+    if (!object.is_object()) {
+        return null_field;
+    }
+    auto it = object.find(key);
+    return it != object.end() ? *it : null_field;
+}
+
+const json& LevelCompiler::custom_field(const json& entity, const char* name) {
+    return field(field(entity, "customFields"), name);
+}
+
+uint64_t LevelCompiler::entity_key(const json& entity) {
+    const json& iid = field(entity, "iid");
+    if (!iid.is_string()) {
+        return 0;
+    }
+    const string& id = iid.get_ref<const string&>();
+    return content_hash(id.data(), id.size());
+}
+
+string LevelCompiler::entity_id(const json& entity) {
+    const json& iid = field(entity, "iid");
+    return iid.is_string() ? iid.get<string>() : iid.dump();
+}
+
+bool LevelCompiler::validate_custom_field(const json& attribute, const char* attribute_name, const json& entity, std::initializer_list<const char*> sub_attributes) {
+    if (attribute.is_null()) {
+        string error = string("NULL value for customField: ") + attribute_name;
+        print_parsing_error(error, entity_id(entity));
+        return false;
+    }
+
+    if (sub_attributes.size() > 0) {
+        for (const char* sub : sub_attributes) {
+            if (!validate_custom_field(field(attribute, sub), sub, entity)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void LevelCompiler::print_parsing_error(const string& error, const string& entity_id) {
+    // collected and printed at once, so levels compiled side by side do not interleave their errors
+    parsing_errors += "\033[96m" + level_name + ": ";
+
+    parsing_errors += "\033[91m" "Error when parsing entity " "\033[93m" + entity_id + ": " "\033[91m" + error + "\n";
+
+    // set the line color back to normal in console
+    parsing_errors += "\033[0m";
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <array>
+#include <map>
+#include "json.hpp"
+#include "level_format.hpp"
+#include "tinyECS/components.hpp"
+using namespace std;
+using namespace nlohmann;
+
+// Compiles the LDtk export of a level (LDtk/<Level>/data.json) into the binary level format,
+// resolving every entity's placement the way the level parser used to at load time
+class LevelCompiler
+{
+public:
+    LevelCompiler(string level_name) : level_name(level_name)
+    {
+    }
+
+    bool compile(const json& json_data, uint64_t source_hash, std::vector<unsigned char>& compiled);
+
+    // Compiles every level under LDtk/ whose compiled copy is missing or out of date, one level per
+    // worker thread; returns the number of levels that failed
+    static int compile_all();
+
+    // Times loading every level from its export (parse and compile) against mapping its compiled
+    // copy, and counts the heap allocations of each
+    static void run_load_benchmark(int iterations);
+
+private:
+    string level_name;
+    LevelWriter writer;
+    string parsing_errors;
+    vec2 level_dimensions;
+
+    // boxes of static platforms and spikes, merged into collider records once the level is read
+    vector<LevelBoxRecord> platform_boxes;
+    vector<LevelBoxRecord> spike_boxes;
+
+    // tile-only records, written grouped by chunk once the level is read
+    vector<LevelBoxRecord> partof_records;
+    vector<LevelPlatformRecord> pipe_part_records;
+    vector<LevelPlatformRecord> platform_records;
+    vector<LevelBoxRecord> spike_records;
+
+    // Custom fields of one entity, resolved in the order its type's schema lists them
+    static const int ENTITY_FIELD_LIMIT = 8;
+    using EntityFields = std::array<const json*, ENTITY_FIELD_LIMIT>;
+
+    struct FieldSchema {
+        const char* name;
+        bool point; // a grid point, which needs cx and cy
+    };
+
+    // Factory for one LDtk entity type; its fields are checked before compile runs, so compile
+    // only reads them
+    struct EntityType {
+        const char* identifier;
+        void (LevelCompiler::*compile)(const json& entity, const EntityFields& fields);
+        FieldSchema fields[ENTITY_FIELD_LIMIT];
+    };
+    static const EntityType entity_types[];
+    static const EntityType* find_entity_type(const string& identifier);
+    bool resolve_fields(const EntityType& type, const json& entity, EntityFields& fields);
+
+    static bool compile_if_stale(const string& level_name, string& report);
+    bool compile_level_to(const json& json_data, uint64_t source_hash, std::vector<unsigned char>& compiled);
+    bool compile_level(const json& json_data);
+    void compile_level_entities(const json& entities);
+    void compile_platform(const json& platform, const EntityFields& fields);
+    void compile_moving_platform(const json& platform, const EntityFields& fields);
+    void compile_boundary(const json& boundary, const EntityFields& fields);
+    void compile_partof(const json& partof, const EntityFields& fields);
+    void compile_spike(const json& spike, const EntityFields& fields);
+    void compile_projectile(const json& projectile, const EntityFields& fields);
+    void compile_cannon(const json& cannon, const EntityFields& fields);
+    void compile_ladder(const json& ladder, const EntityFields& fields);
+    void compile_checkpoint(const json& checkpoint, const EntityFields& fields);
+    void compile_door(const json& door, const EntityFields& fields);
+    void compile_pipe(const json& pipe, const EntityFields& fields);
+    void compile_pipe_part(const json& part, const EntityFields& fields);
+    void compile_breakable_platform(const json& breakable, const EntityFields& fields);
+    void compile_chain(const json& chain, const EntityFields& fields);
+    void compile_pendulum(const json& pendulum, const EntityFields& fields);
+    void compile_gear(const json& gear, const EntityFields& fields);
+    void compile_spikeball(const json& spikeball, const EntityFields& fields);
+    void compile_spawner(const json& spawner, const EntityFields& fields);
+    void compile_rolling_thing(const json& rolling_thing, const EntityFields& fields);
+    void compile_clock_hole(const json& clock_hole, const EntityFields& fields);
+    void compile_world_boundaries();
+    void compile_static_colliders();
+    void compile_chunks();
+
+    template <typename Record>
+    void add_chunked_records(int slot, vector<Record>& records, std::map<int, LevelChunkRecord>& chunks);
+    int chunk_of(vec2 position) const;
+
+    vec2 full_platform_dimensions(const json& platform, const json& size);
+    vec2 platform_start_position(const json& platform, vec2 dimensions);
+    void extract_boundary_attributes(const json& boundary, const EntityFields& fields, vec2& dimensions, vec2& position);
+    vec2 door_position(const json& door);
+    bool extract_direction(const json& direction, LEVEL_DIRECTION& level_direction);
+
+    vec2 convert_and_centralize_position(const json& pos, int conversion_factor);
+    vec2 centralize_position(vec2 pos, int conversion_factor, bool is_x_axis);
+
+    // Lookups into the export without copying it; entities are checked before their fields are read
+    static const json& field(const json& object, const char* key);
+    static const json& custom_field(const json& entity, const char* name);
+    static string entity_id(const json& entity);
+    // Hash of the entity's iid, which stays the same while it is edited; 0 if it has none
+    static uint64_t entity_key(const json& entity);
+    bool validate_custom_field(const json& attribute, const char* attribute_name, const json& entity, std::initializer_list<const char*> sub_attributes = {});
+    void print_parsing_error(const string& error, const string& entity_id);
+};
@@ -0,0 +1,213 @@
+#include <cstring>
+#include <filesystem>
+
+#include "level_format.hpp"
+
+namespace {
+	const char COMPILED_LEVEL_MAGIC[4] = { 'L', 'V', 'L', 'C' };
+	const uint32_t COMPILED_LEVEL_VERSION = 4;
+
+	size_t align_up(size_t offset) {
+		return (offset + 7) & ~(size_t)7;
+	}
+}
+
+const uint32_t level_record_sizes[level_section_count] = {
+	sizeof(uint16_t),					// TILES
+	sizeof(LevelColliderRecord),		// COLLIDERS
+	sizeof(LevelBoxRecord),				// BREAKABLES
+	sizeof(LevelPointRecord),			// CANNONS
+	sizeof(LevelBoxRecord),				// CHAINS
+	sizeof(LevelPointRecord),			// CHECKPOINTS
+	sizeof(LevelBoxRecord),				// CLOCK_HOLES
+	sizeof(LevelDoorRecord),			// DOORS
+	sizeof(LevelGearRecord),			// GEARS
+	sizeof(LevelLadderRecord),			// LADDERS
+	sizeof(LevelMovingPlatformRecord),	// MOVING_PLATFORMS
+	sizeof(LevelSpawnerRecord),			// SPAWNERS
+	sizeof(LevelBoxRecord),				// PARTOFS
+	sizeof(LevelPendulumRecord),		// PENDULUMS
+	sizeof(LevelPipeRecord),			// PIPES
+	sizeof(LevelPlatformRecord),		// PIPE_PARTS
+	sizeof(LevelPlatformRecord),		// PLATFORMS
+	sizeof(LevelBoxRecord),				// PROJECTILES
+	sizeof(LevelBoxRecord),				// ROLLING_THINGS
+	sizeof(LevelBoxRecord),				// SPIKES
+	sizeof(LevelBoxRecord),				// SPIKEBALLS
+	sizeof(LevelChunkRecord),			// CHUNKS
+	sizeof(uint64_t),					// KEYS
+};
+
+const char* level_direction_name(LEVEL_DIRECTION direction) {
+	switch (direction) {
+	case LEVEL_DIRECTION::UP:
+		return "up";
+	case LEVEL_DIRECTION::DOWN:
+		return "down";
+	case LEVEL_DIRECTION::LEFT:
+		return "left";
+	default:
+		return "right";
+	}
+}
+
+int LevelTiles::at(int pos_x, int pos_y, int offset_x, int offset_y) const {
+	int tile_coord_y = (pos_y / TILE_TO_PIXELS) + offset_y;
+	int tile_coord_x = (pos_x / TILE_TO_PIXELS) + offset_x;
+	int index = tile_coord_x + tile_coord_y * stride;
+	if (index < 0 || (size_t)index >= count) {
+		return 0;
+	}
+	return ids[index];
+}
+
+bool LevelView::open(const unsigned char* data, size_t size, uint64_t source_hash) {
+	close();
+
+	if (size < sizeof(LevelFileHeader)) {
+		return false;
+	}
+	memcpy(&file_header, data, sizeof(file_header));
+	if (memcmp(file_header.magic, COMPILED_LEVEL_MAGIC, sizeof(file_header.magic)) != 0 ||
+		file_header.version != COMPILED_LEVEL_VERSION ||
+		file_header.source_hash != source_hash ||
+		file_header.identifier[sizeof(file_header.identifier) - 1] != '\0' ||
+		file_header.next_level[sizeof(file_header.next_level) - 1] != '\0') {
+		return false;
+	}
+
+	for (int i = 0; i < level_section_count; i++) {
+		const LevelSection& section = file_header.sections[i];
+		if (section.record_size != level_record_sizes[i] ||
+			section.offset < sizeof(LevelFileHeader) || section.offset % 8 != 0 ||
+			section.offset > size || (uint64_t)section.count * section.record_size > size - section.offset) {
+			return false;
+		}
+	}
+
+	uint64_t keyed_records = 0;
+	for (int i = 0; i < level_section_count; i++) {
+		if (level_section_keyed((LEVEL_SECTION_ID)i)) {
+			keyed_records += file_header.sections[i].count;
+		}
+	}
+	if (file_header.sections[(int)LEVEL_SECTION_ID::KEYS].count != keyed_records) {
+		return false;
+	}
+
+	if (content_hash(data + sizeof(LevelFileHeader), size - sizeof(LevelFileHeader)) != file_header.checksum) {
+		return false;
+	}
+
+	bytes = data;
+	for (const LevelChunkRecord& chunk : records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS)) {
+		for (int i = 0; i < level_chunk_section_count; i++) {
+			if ((uint64_t)chunk.first[i] + chunk.count[i] > file_header.sections[(int)level_chunk_sections[i]].count) {
+				bytes = nullptr;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void LevelView::close() {
+	bytes = nullptr;
+}
+
+const uint64_t* LevelView::record_keys(LEVEL_SECTION_ID section) const {
+	assert(level_section_keyed(section));
+	uint64_t first = 0;
+	for (int i = 0; i < (int)section; i++) {
+		if (level_section_keyed((LEVEL_SECTION_ID)i)) {
+			first += file_header.sections[i].count;
+		}
+	}
+	return records<uint64_t>(LEVEL_SECTION_ID::KEYS).first + first;
+}
+
+LevelTiles LevelView::tiles() const {
+	LevelRecords<uint16_t> ids = records<uint16_t>(LEVEL_SECTION_ID::TILES);
+
+	LevelTiles tiles;
+	tiles.ids = ids.first;
+	tiles.count = ids.count;
+	tiles.stride = (int)file_header.stride;
+	return tiles;
+}
+
+LevelWriter::LevelWriter() {
+	memset(&file_header, 0, sizeof(file_header));
+	memcpy(file_header.magic, COMPILED_LEVEL_MAGIC, sizeof(file_header.magic));
+	file_header.version = COMPILED_LEVEL_VERSION;
+}
+
+void LevelWriter::finish(uint64_t source_hash, std::vector<unsigned char>& compiled) {
+	std::vector<unsigned char>& key_records = sections[(int)LEVEL_SECTION_ID::KEYS];
+	key_records.clear();
+	for (int i = 0; i < level_section_count; i++) {
+		const unsigned char* section_keys = (const unsigned char*)keys[i].data();
+		key_records.insert(key_records.end(), section_keys, section_keys + keys[i].size() * sizeof(uint64_t));
+	}
+
+	size_t size = align_up(sizeof(LevelFileHeader));
+	for (int i = 0; i < level_section_count; i++) {
+		LevelSection& section = file_header.sections[i];
+		section.offset = size;
+		section.record_size = level_record_sizes[i];
+		section.count = (uint32_t)(sections[i].size() / section.record_size);
+		size = align_up(size + sections[i].size());
+	}
+
+	compiled.assign(size, 0);
+	for (int i = 0; i < level_section_count; i++) {
+		if (!sections[i].empty()) {
+			memcpy(compiled.data() + file_header.sections[i].offset, sections[i].data(), sections[i].size());
+		}
+	}
+
+	file_header.source_hash = source_hash;
+	file_header.checksum = content_hash(compiled.data() + sizeof(LevelFileHeader), size - sizeof(LevelFileHeader));
+	memcpy(compiled.data(), &file_header, sizeof(file_header));
+}
+
+std::string compiled_level_path(const std::string& level_name) {
+	return cooked_path("LDtk_" + level_name + ".lvl");
+}
+
+bool load_compiled_level(const std::string& level_name, uint64_t source_hash, MappedFile& compiled, LevelView& level) {
+	if (!compiled.open(compiled_level_path(level_name))) {
+		return false;
+	}
+	if (!level.open(compiled.data(), compiled.size(), source_hash)) {
+		compiled.close();
+		return false;
+	}
+	return true;
+}
+
+bool store_compiled_level(const std::string& level_name, const std::vector<unsigned char>& compiled) {
+	const std::string path = compiled_level_path(level_name);
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+	// write to a temporary name first so a concurrent reader never maps a half-written file
+	const std::string file_path = temporary_path(path);
+	std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	file.write((const char*)compiled.data(), (std::streamsize)compiled.size());
+	file.close();
+	if (!file) {
+		std::filesystem::remove(file_path, error);
+		return false;
+	}
+
+	std::filesystem::rename(file_path, path, error);
+	if (error) {
+		std::filesystem::remove(file_path, error);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../common.hpp"
+#include "../../mapped_file.hpp"
+
+// Compiled levels: the LDtk export of a level reduced to what instantiation needs. Positions and
+// sizes are resolved at compile time, so loading maps the file and walks typed record arrays.
+
+enum class LEVEL_SECTION_ID : uint32_t {
+	TILES = 0,
+	COLLIDERS = TILES + 1,
+	// entity records, in the order the level's entities are created
+	BREAKABLES = COLLIDERS + 1,
+	CANNONS = BREAKABLES + 1,
+	CHAINS = CANNONS + 1,
+	CHECKPOINTS = CHAINS + 1,
+	CLOCK_HOLES = CHECKPOINTS + 1,
+	DOORS = CLOCK_HOLES + 1,
+	GEARS = DOORS + 1,
+	LADDERS = GEARS + 1,
+	MOVING_PLATFORMS = LADDERS + 1,
+	SPAWNERS = MOVING_PLATFORMS + 1,
+	PARTOFS = SPAWNERS + 1,
+	PENDULUMS = PARTOFS + 1,
+	PIPES = PENDULUMS + 1,
+	PIPE_PARTS = PIPES + 1,
+	PLATFORMS = PIPE_PARTS + 1,
+	PROJECTILES = PLATFORMS + 1,
+	ROLLING_THINGS = PROJECTILES + 1,
+	SPIKES = ROLLING_THINGS + 1,
+	SPIKEBALLS = SPIKES + 1,
+	// ranges of the streamed sections' records, per chunk
+	CHUNKS = SPIKEBALLS + 1,
+	// key of every record from COLLIDERS up to CHUNKS, section after section
+	KEYS = CHUNKS + 1,
+	LEVEL_SECTION_COUNT = KEYS + 1
+};
+const int level_section_count = (int)LEVEL_SECTION_ID::LEVEL_SECTION_COUNT;
+
+// Sections whose records carry a key: the hash of the iid of the LDtk entity they were compiled
+// from, so an edited entity can be told apart from a new one. Records derived from several entities
+// (merged colliders, world boundaries) and tile-only records have key 0.
+inline bool level_section_keyed(LEVEL_SECTION_ID section) {
+	return section >= LEVEL_SECTION_ID::COLLIDERS && section < LEVEL_SECTION_ID::CHUNKS;
+}
+
+// Sections holding tiles only, whose records are grouped by chunk so they can be streamed; rounded
+// platforms keep their collider and come before the chunked platforms
+const LEVEL_SECTION_ID level_chunk_sections[] = {
+	LEVEL_SECTION_ID::PARTOFS,
+	LEVEL_SECTION_ID::PIPE_PARTS,
+	LEVEL_SECTION_ID::PLATFORMS,
+	LEVEL_SECTION_ID::SPIKES,
+};
+const int level_chunk_section_count = sizeof(level_chunk_sections) / sizeof(level_chunk_sections[0]);
+
+enum class LEVEL_COLLIDER_KIND : uint32_t {
+	WORLD_BOUNDARY = 0,
+	LEVEL_BOUNDARY = WORLD_BOUNDARY + 1,
+	// merged boxes of the level's static platforms and spikes, whose records then only hold tiles
+	PLATFORM = LEVEL_BOUNDARY + 1,
+	SPIKE = PLATFORM + 1,
+	LEVEL_COLLIDER_KIND_COUNT = SPIKE + 1
+};
+
+enum class LEVEL_DIRECTION : uint32_t {
+	UP = 0,
+	DOWN = UP + 1,
+	LEFT = DOWN + 1,
+	RIGHT = LEFT + 1,
+	LEVEL_DIRECTION_COUNT = RIGHT + 1
+};
+const char* level_direction_name(LEVEL_DIRECTION direction);
+
+// Records
+struct LevelColliderRecord {
+	vec2 position;
+	vec2 size;
+	LEVEL_COLLIDER_KIND kind;
+};
+
+// Spikes, part-ofs, breakables, clock holes, chains, projectiles, rolling things and spikeballs
+struct LevelBoxRecord {
+	vec2 position;
+	vec2 size;
+};
+
+// Cannons and checkpoints
+struct LevelPointRecord {
+	vec2 position;
+};
+
+// Platforms and pipe parts
+struct LevelPlatformRecord {
+	vec2 position;
+	vec2 size;
+	uint32_t rounded;
+};
+
+struct LevelMovingPlatformRecord {
+	vec2 size;
+	vec2 initial_position;
+	vec2 start;
+	vec2 end;
+	float duration;
+	uint32_t rounded;
+};
+
+struct LevelDoorRecord {
+	vec2 position;
+	uint32_t open;
+};
+
+struct LevelLadderRecord {
+	vec2 position;
+	vec2 size;
+	int32_t height;
+};
+
+struct LevelPipeRecord {
+	vec2 position;
+	vec2 size;
+	LEVEL_DIRECTION direction;
+	float time_offset;
+};
+
+struct LevelPendulumRecord {
+	vec2 pivot_position;
+	float length;
+	float initial_angle;
+	float bob_radius;
+};
+
+struct LevelGearRecord {
+	vec2 position;
+	vec2 size;
+	uint32_t fixed;
+	float angular_velocity;
+	float initial_angle;
+};
+
+struct LevelSpawnerRecord {
+	char type[16];
+	vec2 size;
+	vec2 velocity;
+	vec2 start_position;
+	vec2 end_position;
+};
+
+// A chunk's records in each of level_chunk_sections, and the box they cover
+struct LevelChunkRecord {
+	vec2 min;
+	vec2 max;
+	uint32_t entity_count;	// created when the chunk is activated
+	uint32_t first[level_chunk_section_count];
+	uint32_t count[level_chunk_section_count];
+};
+
+// Byte size of each section's records, checked when a level is opened
+extern const uint32_t level_record_sizes[level_section_count];
+
+struct LevelSection {
+	uint64_t offset;
+	uint32_t count;
+	uint32_t record_size;
+};
+
+// File layout: header, then each section's records, 8 byte aligned
+struct LevelFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t source_hash;
+	uint64_t checksum;	// of everything after the header
+	uint32_t width;
+	uint32_t height;
+	uint32_t stride;	// tiles per row
+	uint32_t padding;
+	vec2 player_position;
+	vec2 player_size;
+	char identifier[32];
+	char next_level[32];
+	LevelSection sections[level_section_count];
+};
+
+// Tile ids of a level's tile layer, row major
+struct LevelTiles {
+	const uint16_t* ids = nullptr;
+	size_t count = 0;
+	int stride = 1;
+
+	// Tile id at a pixel position, offset by whole tiles
+	int at(int pos_x, int pos_y, int offset_x = 0, int offset_y = 0) const;
+};
+
+template <typename Record>
+struct LevelRecords {
+	const Record* first = nullptr;
+	uint32_t count = 0;
+
+	const Record* begin() const { return first; }
+	const Record* end() const { return first + count; }
+	uint32_t size() const { return count; }
+};
+
+// Read-only view of a compiled level held by someone else (a mapping or a buffer)
+class LevelView {
+public:
+	// Checks the header, the checksum and every section's bounds; source_hash is the hash of the
+	// LDtk export the level should have been compiled from
+	bool open(const unsigned char* data, size_t size, uint64_t source_hash);
+	void close();
+
+	bool is_open() const { return bytes != nullptr; }
+	const LevelFileHeader& header() const { return file_header; }
+	LevelTiles tiles() const;
+
+	template <typename Record>
+	LevelRecords<Record> records(LEVEL_SECTION_ID section) const {
+		if (bytes == nullptr) {
+			return {};
+		}
+		const LevelSection& records = file_header.sections[(int)section];
+		assert(records.record_size == sizeof(Record));
+		return { (const Record*)(bytes + records.offset), records.count };
+	}
+
+	// Raw bytes of a record, for comparing two compiled copies of a level
+	const unsigned char* record_data(LEVEL_SECTION_ID section, uint32_t index) const {
+		const LevelSection& records = file_header.sections[(int)section];
+		return bytes + records.offset + (size_t)index * records.record_size;
+	}
+
+	// Keys of a keyed section's records, one per record
+	const uint64_t* record_keys(LEVEL_SECTION_ID section) const;
+
+private:
+	const unsigned char* bytes = nullptr;
+	LevelFileHeader file_header;
+};
+
+// Writes the records of a level into the binary format
+class LevelWriter {
+public:
+	LevelWriter();
+
+	LevelFileHeader& header() { return file_header; }
+
+	// Key given to the records added from now on, 0 outside of an entity
+	void set_record_key(uint64_t key) { record_key = key; }
+
+	template <typename Record>
+	void add(LEVEL_SECTION_ID section, const Record& record) {
+		assert(level_record_sizes[(int)section] == sizeof(Record));
+		std::vector<unsigned char>& records = sections[(int)section];
+		const unsigned char* bytes = (const unsigned char*)&record;
+		records.insert(records.end(), bytes, bytes + sizeof(Record));
+		if (level_section_keyed(section)) {
+			keys[(int)section].push_back(record_key);
+		}
+	}
+
+	uint32_t count(LEVEL_SECTION_ID section) const {
+		return (uint32_t)(sections[(int)section].size() / level_record_sizes[(int)section]);
+	}
+
+	void finish(uint64_t source_hash, std::vector<unsigned char>& compiled);
+
+private:
+	LevelFileHeader file_header;
+	std::vector<unsigned char> sections[level_section_count];
+	std::vector<uint64_t> keys[level_section_count];
+	uint64_t record_key = 0;
+};
+
+// Compiled copies live in the per-user cache directory, next to the cooked textures
+std::string compiled_level_path(const std::string& level_name);
+
+// Maps the compiled copy of a level if it is still in sync with its export
+bool load_compiled_level(const std::string& level_name, uint64_t source_hash, MappedFile& compiled, LevelView& level);
+bool store_compiled_level(const std::string& level_name, const std::vector<unsigned char>& compiled);
@@ -0,0 +1,70 @@
+#include <iostream>
+#include "level_prefetcher.hpp"
+#include "level_compiler.hpp"
+
+bool prepare_level(const std::string& level_name, PreparedLevel& prepared) {
+    prepared = PreparedLevel();
+    prepared.name = level_name;
+
+    string filename = level_data_path(level_name);
+    MappedFile source;
+    if (!source.open(filename)) {
+        cout << "Error could not open file " << filename << endl;
+        return false;
+    }
+    const uint64_t source_hash = content_hash(source.data(), source.size());
+
+    // the compiled copy is only used while it matches the export it was compiled from
+    prepared.compiled_file = std::make_unique<MappedFile>();
+    if (load_compiled_level(level_name, source_hash, *prepared.compiled_file, prepared.level)) {
+        return true;
+    }
+    prepared.compiled_file.reset();
+
+    json json_data = json::parse(source.data(), source.data() + source.size(), nullptr, false);
+    if (json_data.is_discarded()) {
+        cout << "Error: could not parse JSON " << filename << endl;
+        return false;
+    }
+    if (!LevelCompiler(level_name).compile(json_data, source_hash, prepared.compiled_level)) {
+        return false;
+    }
+    if (!store_compiled_level(level_name, prepared.compiled_level)) {
+        cout << "Warning: could not store compiled level " << compiled_level_path(level_name) << endl;
+    }
+    return prepared.level.open(prepared.compiled_level.data(), prepared.compiled_level.size(), source_hash);
+}
+
+void LevelPrefetcher::request(const std::string& level_name) {
+    if (level_name == requested_name) {
+        return;
+    }
+    wait();
+
+    requested_name = level_name;
+    prefetched_ok = false;
+    worker = std::thread([this, level_name]() {
+        prefetched_ok = prepare_level(level_name, prefetched);
+    });
+}
+
+bool LevelPrefetcher::take(const std::string& level_name, PreparedLevel& prepared) {
+    if (level_name != requested_name) {
+        return false;
+    }
+    wait();
+    requested_name.clear();
+
+    if (!prefetched_ok) {
+        return false;
+    }
+    prepared = std::move(prefetched);
+    prefetched = PreparedLevel();
+    return true;
+}
+
+void LevelPrefetcher::wait() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
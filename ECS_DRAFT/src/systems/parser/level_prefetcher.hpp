@@ -0,0 +1,43 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "level_format.hpp"
+
+// A level ready to be instantiated: its compiled copy mapped, or compiled in memory from its
+// export when no up-to-date copy exists. Moving it keeps the view valid.
+struct PreparedLevel
+{
+    std::string name;
+    std::unique_ptr<MappedFile> compiled_file;
+    std::vector<unsigned char> compiled_level;
+    LevelView level;
+};
+
+// Blocking; stores what it compiles so the next load can map it
+bool prepare_level(const std::string& level_name, PreparedLevel& prepared);
+
+// Prepares one level on a background thread while the current one is played, so switching to it
+// only has to instantiate its records
+class LevelPrefetcher
+{
+public:
+    ~LevelPrefetcher() { wait(); }
+
+    // Starts preparing level_name unless it is already the prefetched level
+    void request(const std::string& level_name);
+
+    // Hands over the prefetched level if it is level_name, waiting for it if it is not ready yet
+    bool take(const std::string& level_name, PreparedLevel& prepared);
+
+private:
+    void wait();
+
+    std::thread worker;
+    std::string requested_name;
+
+    // only touched by the worker until it is joined
+    PreparedLevel prefetched;
+    bool prefetched_ok = false;
+};
@@ -0,0 +1,240 @@
+#include <cstring>
+#include "level_streamer.hpp"
+#include "../world/world_init.hpp"
+#include "tinyECS/registry.hpp"
+
+namespace {
+    bool overlaps(const LevelChunkRecord& chunk, vec2 view_min, vec2 view_max) {
+        return chunk.min.x <= view_max.x && chunk.max.x >= view_min.x &&
+            chunk.min.y <= view_max.y && chunk.max.y >= view_min.y;
+    }
+}
+
+LevelStreamer::LevelStreamer() {
+    worker = std::thread([this]() { worker_loop(); });
+}
+
+LevelStreamer::~LevelStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    worker.join();
+}
+
+void LevelStreamer::reset(const LevelView& level, const LevelTiles& tiles) {
+    cancel_preparation();
+    this->level = level;
+    this->tiles = tiles;
+    chunks.assign(level.records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS).size(), ChunkState());
+    active_chunks = 0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    preparation.assign(chunks.size(), PREPARATION::NONE);
+    prepared_chunks.assign(chunks.size(), PreparedChunk());
+}
+
+void LevelStreamer::update(vec2 view_center, vec2 view_half_extents, uint32_t budget) {
+    const LevelRecords<LevelChunkRecord> records = level.records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS);
+    const vec2 near_extents = view_half_extents + vec2(LEVEL_STREAM_MARGIN);
+    const vec2 far_extents = view_half_extents + vec2(2.0f * LEVEL_STREAM_MARGIN);
+
+    // retire first so the entity count never grows past what a single view needs
+    uint32_t spent = 0;
+    for (uint32_t i = 0; i < records.size() && spent < budget; i++) {
+        if (chunks[i].active && !overlaps(records.first[i], view_center - far_extents, view_center + far_extents)) {
+            spent += retire(chunks[i]);
+        }
+    }
+    for (uint32_t i = 0; i < records.size() && spent < budget; i++) {
+        if (!chunks[i].active && overlaps(records.first[i], view_center - near_extents, view_center + near_extents)) {
+            spent += activate(i);
+        }
+    }
+
+    // queue the chunks the view may reach next, and drop what was prepared for chunks it left
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (uint32_t i = 0; i < records.size(); i++) {
+            if (chunks[i].active) {
+                continue;
+            }
+            const bool near = overlaps(records.first[i], view_center - far_extents, view_center + far_extents);
+            if (near && preparation[i] == PREPARATION::NONE) {
+                preparation[i] = PREPARATION::QUEUED;
+                queued_chunks.push_back(i);
+                queued = true;
+            } else if (!near && preparation[i] == PREPARATION::READY) {
+                preparation[i] = PREPARATION::NONE;
+                prepared_chunks[i] = PreparedChunk();
+            }
+        }
+    }
+    if (queued) {
+        work_ready.notify_one();
+    }
+}
+
+void LevelStreamer::apply_edit(const LevelView& edited, const LevelTiles& edited_tiles) {
+    const LevelRecords<LevelChunkRecord> records = level.records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS);
+    const LevelRecords<LevelChunkRecord> edited_records = edited.records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS);
+
+    std::vector<ChunkState> edited_chunks(edited_records.size());
+    for (uint32_t i = 0; i < records.size(); i++) {
+        if (!chunks[i].active) {
+            continue;
+        }
+        uint32_t match = 0;
+        while (match < edited_records.size() &&
+            (edited_chunks[match].active || !same_chunk(records.first[i], edited, edited_records.first[match]))) {
+            match++;
+        }
+        if (match < edited_records.size()) {
+            edited_chunks[match] = chunks[i];
+        } else {
+            retire(chunks[i]);
+        }
+    }
+
+    cancel_preparation();
+    level = edited;
+    tiles = edited_tiles;
+    chunks.swap(edited_chunks);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    preparation.assign(chunks.size(), PREPARATION::NONE);
+    prepared_chunks.assign(chunks.size(), PreparedChunk());
+}
+
+bool LevelStreamer::same_chunk(const LevelChunkRecord& chunk, const LevelView& edited, const LevelChunkRecord& edited_chunk) const {
+    if (chunk.min != edited_chunk.min || chunk.max != edited_chunk.max) {
+        return false;
+    }
+    for (int i = 0; i < level_chunk_section_count; i++) {
+        const LEVEL_SECTION_ID section = level_chunk_sections[i];
+        if (chunk.count[i] != edited_chunk.count[i] ||
+            (chunk.count[i] > 0 && memcmp(level.record_data(section, chunk.first[i]), edited.record_data(section, edited_chunk.first[i]),
+                (size_t)chunk.count[i] * level_record_sizes[(int)section]) != 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t LevelStreamer::activate(uint32_t index) {
+    const LevelChunkRecord& chunk = level.records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS).first[index];
+
+    // takes the worker's preparation if it is done, otherwise prepares the chunk here; a chunk the
+    // worker is still on is left to it, its result is dropped
+    PreparedChunk prepared;
+    bool ready = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready = preparation[index] == PREPARATION::READY;
+        if (ready) {
+            prepared = std::move(prepared_chunks[index]);
+            prepared_chunks[index] = PreparedChunk();
+        }
+        preparation[index] = PREPARATION::NONE;
+    }
+    if (!ready) {
+        prepare(chunk, prepared);
+    }
+
+    // reserves nothing, only reads the id the chunk's first entity will get
+    ChunkState& state = chunks[index];
+    state.first_id = Entity::create_range(0);
+    for (const TileRun& run : prepared.runs) {
+        if (run.partof) {
+            create_partof(run.position, run.size, prepared.tile_ids[run.first_tile]);
+        } else {
+            create_platform_tiles(run.position, run.size, prepared.tile_ids.data() + run.first_tile);
+        }
+    }
+    state.end_id = Entity::create_range(0);
+    state.active = true;
+    active_chunks++;
+    return chunk.entity_count;
+}
+
+void LevelStreamer::prepare(const LevelChunkRecord& chunk, PreparedChunk& prepared) const {
+    prepared.runs.clear();
+    prepared.tile_ids.clear();
+    auto add_partof = [&](vec2 position, vec2 size) {
+        prepared.runs.push_back(TileRun{ position, size, (uint32_t)prepared.tile_ids.size(), true });
+        prepared.tile_ids.push_back(tiles.at(position.x, position.y));
+    };
+    auto add_platform = [&](vec2 position, vec2 size) {
+        prepared.runs.push_back(TileRun{ position, size, (uint32_t)prepared.tile_ids.size(), false });
+        for (int i = 0; i < platform_tile_count(size); i++) {
+            prepared.tile_ids.push_back(platform_tile_id(position, size, tiles, i));
+        }
+    };
+
+    const LevelRecords<LevelBoxRecord> partofs = level.records<LevelBoxRecord>(LEVEL_SECTION_ID::PARTOFS);
+    for (uint32_t i = chunk.first[0]; i < chunk.first[0] + chunk.count[0]; i++) {
+        add_partof(partofs.first[i].position, partofs.first[i].size);
+    }
+    const LevelRecords<LevelPlatformRecord> pipe_parts = level.records<LevelPlatformRecord>(LEVEL_SECTION_ID::PIPE_PARTS);
+    for (uint32_t i = chunk.first[1]; i < chunk.first[1] + chunk.count[1]; i++) {
+        add_platform(pipe_parts.first[i].position, pipe_parts.first[i].size);
+    }
+    const LevelRecords<LevelPlatformRecord> platforms = level.records<LevelPlatformRecord>(LEVEL_SECTION_ID::PLATFORMS);
+    for (uint32_t i = chunk.first[2]; i < chunk.first[2] + chunk.count[2]; i++) {
+        add_platform(platforms.first[i].position, platforms.first[i].size);
+    }
+    // drawn only, the spike colliders are merged
+    const LevelRecords<LevelBoxRecord> spikes = level.records<LevelBoxRecord>(LEVEL_SECTION_ID::SPIKES);
+    for (uint32_t i = chunk.first[3]; i < chunk.first[3] + chunk.count[3]; i++) {
+        add_partof(spikes.first[i].position, spikes.first[i].size);
+    }
+}
+
+void LevelStreamer::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_ready.wait(lock, [this]() { return stopping || !queued_chunks.empty(); });
+        if (stopping) {
+            return;
+        }
+        const uint32_t index = queued_chunks.front();
+        queued_chunks.pop_front();
+        // activated or dropped since it was queued
+        if (preparation[index] != PREPARATION::QUEUED) {
+            continue;
+        }
+
+        // the level is only switched after cancel_preparation() saw the worker idle
+        preparing = true;
+        lock.unlock();
+        PreparedChunk prepared;
+        prepare(level.records<LevelChunkRecord>(LEVEL_SECTION_ID::CHUNKS).first[index], prepared);
+        lock.lock();
+        preparing = false;
+
+        if (preparation[index] == PREPARATION::QUEUED) {
+            preparation[index] = PREPARATION::READY;
+            prepared_chunks[index] = std::move(prepared);
+        }
+        work_done.notify_all();
+    }
+}
+
+void LevelStreamer::cancel_preparation() {
+    std::unique_lock<std::mutex> lock(mutex);
+    queued_chunks.clear();
+    work_done.wait(lock, [this]() { return !preparing; });
+    preparation.clear();
+    prepared_chunks.clear();
+}
+
+uint32_t LevelStreamer::retire(ChunkState& state) {
+    for (unsigned int id = state.first_id; id < state.end_id; id++) {
+        registry.remove_all_components_of(Entity(id));
+    }
+    state.active = false;
+    active_chunks--;
+    return state.end_id - state.first_id;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "level_format.hpp"
+
+// Creates the static tiles of a level's chunks as the view comes near them and removes them once
+// it has moved away. A worker thread looks up the tiles of the chunks coming into range ahead of
+// time, so activating one only creates its entities.
+// Only tiles are streamed: colliders and everything with state or AI are created with the level and
+// stay, since obstacles, bolts and platforms keep moving and colliding while they are off screen.
+class LevelStreamer
+{
+public:
+    LevelStreamer();
+    ~LevelStreamer();
+    LevelStreamer(const LevelStreamer&) = delete;
+    LevelStreamer& operator=(const LevelStreamer&) = delete;
+
+    // Starts streaming a freshly loaded level; the entities of the previous one are already flushed
+    void reset(const LevelView& level, const LevelTiles& tiles);
+
+    // Activates the chunks within LEVEL_STREAM_MARGIN of the view and retires those beyond twice
+    // that, creating or removing about budget entities at most; a started chunk is always finished.
+    // Chunks within twice the margin are prepared in the background.
+    void update(vec2 view_center, vec2 view_half_extents, uint32_t budget);
+
+    // Switches to an edited copy of the level: active chunks whose records did not change keep their
+    // entities, the others are retired and streamed in again from the edited records
+    void apply_edit(const LevelView& edited, const LevelTiles& edited_tiles);
+
+    uint32_t active_chunk_count() const { return active_chunks; }
+    uint32_t chunk_count() const { return (uint32_t)chunks.size(); }
+
+private:
+    // Entities of an active chunk are created back to back, so their ids are one range
+    struct ChunkState {
+        bool active = false;
+        unsigned int first_id = 0;
+        unsigned int end_id = 0;
+    };
+
+    // A chunk's tiles with their ids looked up: one run per record, in the order they are created
+    struct TileRun {
+        vec2 position;
+        vec2 size;
+        uint32_t first_tile;	// into tile_ids
+        bool partof;			// a single tile entity rather than a platform's tiles
+    };
+    struct PreparedChunk {
+        std::vector<TileRun> runs;
+        std::vector<int> tile_ids;
+    };
+
+    enum class PREPARATION : uint8_t {
+        NONE = 0,
+        QUEUED = NONE + 1,
+        READY = QUEUED + 1
+    };
+
+    uint32_t activate(uint32_t index);
+    uint32_t retire(ChunkState& state);
+    bool same_chunk(const LevelChunkRecord& chunk, const LevelView& edited, const LevelChunkRecord& edited_chunk) const;
+
+    // Reads the level and its tiles only, the worker runs it
+    void prepare(const LevelChunkRecord& chunk, PreparedChunk& prepared) const;
+    void worker_loop();
+    // Waits for the worker to finish the chunk it is on and drops every preparation, before the
+    // level it reads is switched
+    void cancel_preparation();
+
+    LevelView level;
+    LevelTiles tiles;
+    std::vector<ChunkState> chunks;
+    uint32_t active_chunks = 0;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+    bool stopping = false;
+    bool preparing = false;
+
+    // guarded by mutex
+    std::deque<uint32_t> queued_chunks;
+    std::vector<PREPARATION> preparation;
+    std::vector<PreparedChunk> prepared_chunks;
+};
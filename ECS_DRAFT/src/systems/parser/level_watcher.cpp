@@ -0,0 +1,116 @@
+#include <iostream>
+#include <cstring>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#include "level_watcher.hpp"
+
+LevelWatcher::~LevelWatcher() {
+    stop();
+#ifdef __linux__
+    if (inotify_fd >= 0) {
+        close(inotify_fd);
+    }
+#endif
+}
+
+void LevelWatcher::watch(const std::string& level_name) {
+    if (level_name == this->level_name) {
+        return;
+    }
+    stop();
+    this->level_name = level_name;
+
+    const std::filesystem::path export_path = level_data_path(level_name);
+#ifdef __linux__
+    if (inotify_fd < 0) {
+        inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+    // editors save by rewriting the file or by renaming a temporary one over it
+    if (inotify_fd >= 0) {
+        watch_fd = inotify_add_watch(inotify_fd, export_path.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    }
+    if (watch_fd < 0) {
+        std::cout << "Warning: cannot watch " << export_path << " for edits" << std::endl;
+    }
+#else
+    std::error_code error;
+    last_write_time = std::filesystem::last_write_time(export_path, error);
+#endif
+}
+
+bool LevelWatcher::poll(PreparedLevel& edited) {
+    if (export_saved()) {
+        edit_pending = true;
+    }
+
+    if (worker.joinable()) {
+        if (!worker_done) {
+            return false;
+        }
+        worker.join();
+        if (prepared_ok && !edit_pending) {
+            edited = std::move(prepared);
+            prepared = PreparedLevel();
+            return true;
+        }
+    }
+
+    if (edit_pending) {
+        edit_pending = false;
+        worker_done = false;
+        prepared_ok = false;
+        worker = std::thread([this, level_name = level_name]() {
+            prepared_ok = prepare_level(level_name, prepared);
+            worker_done = true;
+        });
+    }
+    return false;
+}
+
+bool LevelWatcher::export_saved() {
+    if (level_name.empty()) {
+        return false;
+    }
+
+#ifdef __linux__
+    if (watch_fd < 0) {
+        return false;
+    }
+    bool saved = false;
+    alignas(inotify_event) char events[4096];
+    ssize_t length;
+    while ((length = read(inotify_fd, events, sizeof(events))) > 0) {
+        for (char* next = events; next < events + length; ) {
+            const inotify_event* event = (const inotify_event*)next;
+            saved |= event->wd == watch_fd && event->len > 0 && strcmp(event->name, "data.json") == 0;
+            next += sizeof(inotify_event) + event->len;
+        }
+    }
+    return saved;
+#else
+    std::error_code error;
+    const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(level_data_path(level_name), error);
+    if (error || write_time == last_write_time) {
+        return false;
+    }
+    last_write_time = write_time;
+    return true;
+#endif
+}
+
+void LevelWatcher::stop() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+    edit_pending = false;
+    prepared = PreparedLevel();
+
+#ifdef __linux__
+    if (watch_fd >= 0) {
+        inotify_rm_watch(inotify_fd, watch_fd);
+        watch_fd = -1;
+    }
+#endif
+}
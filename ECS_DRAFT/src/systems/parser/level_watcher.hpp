@@ -0,0 +1,41 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include "level_prefetcher.hpp"
+
+// Dev mode: notices when the LDtk export of the level being played is saved (inotify on Linux,
+// its modification time elsewhere) and prepares the edited level on a background thread
+class LevelWatcher
+{
+public:
+    ~LevelWatcher();
+
+    // Watches level_name instead of the previous level, dropping an edit of it not yet applied
+    void watch(const std::string& level_name);
+
+    // Non-blocking; hands over the edited level once it is prepared. A save made while the previous
+    // one was being prepared supersedes it, and a save that cannot be read waits for the next one.
+    bool poll(PreparedLevel& edited);
+
+private:
+    bool export_saved();
+    void stop();
+
+    std::string level_name;
+#ifdef __linux__
+    int inotify_fd = -1;
+    int watch_fd = -1;
+#else
+    std::filesystem::file_time_type last_write_time;
+#endif
+    bool edit_pending = false;
+
+    std::thread worker;
+    std::atomic<bool> worker_done = false;
+
+    // only touched by the worker until it is joined
+    PreparedLevel prepared;
+    bool prepared_ok = false;
+};
@@ -1,13 +1,24 @@
 #include <iostream>
 #include "parsing_system.hpp"
 #include "../world/world_init.hpp"
+#include "../world/entity_pool.hpp"
+#include "level_batch.hpp"
 #include "tinyECS/registry.hpp"
 #include "../boss/boss_one/boss_one_utils.hpp"
 #include <fstream>
 #include "systems/ai/pipe/pipe_utils.hpp"
+#include "systems/particle/particle_system.hpp"
+#include "systems/camera/camera_system.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <string_view>
+#include <unordered_map>
 
 void LevelParsingSystem::init(GLFWwindow *window) {
     this->window = window;
+    workers.start(std::max(1, (int)std::thread::hardware_concurrency()));
     parse_rolling_thing_json();
 }
 
@@ -15,7 +26,8 @@ void LevelParsingSystem::step(float elapsed_ms) {
     LevelState& level_state = registry.levelStates.components[0];
 
     if (level_state.shouldReparseEntities) {
-        init_level_entities(reparsable_entities);
+        init_breakable_platforms();
+        init_projectiles();
         level_state.shouldReparseEntities = false;
         return;
     }
@@ -41,7 +53,14 @@ void LevelParsingSystem::step(float elapsed_ms) {
         }
     }
 
-    if (!level_state.shouldLoad) return;
+    if (!level_state.shouldLoad) {
+        PreparedLevel edited;
+        if (hot_reload && watcher.poll(edited)) {
+            apply_level_edit(edited);
+        }
+        stream_level_chunks(LEVEL_STREAM_BUDGET);
+        return;
+    }
 
     // remove all entities with motion (flush the current level)
     while (registry.motions.size() > 0) {
@@ -52,19 +71,20 @@ void LevelParsingSystem::step(float elapsed_ms) {
     while (registry.renderRequests.size() > 0) {
         registry.remove_all_components_of(registry.renderRequests.entities.back());
     }
+    EntityPools::clear();
 
     // Remove all particles
-    while (registry.particles.entities.size() > 0)
-        registry.remove_all_components_of(registry.particles.entities.back());
+    ParticleSystem::clear_particles();
 
-    if (!parse_json()) {
-        cout << "Error: could not parse JSON" << endl;
+    if (!load_level()) {
+        cout << "Error: could not load level " << level_state.curr_level_folder_name << endl;
         return;
     }
+    const LevelFileHeader& header = level.header();
 
-    json next_levels = json_data["neighbourLevels"];
-    if (!next_levels.empty()) {
-        level_state.next_level_folder_name = next_levels[0];
+    if (header.next_level[0] != '\0') {
+        level_state.next_level_folder_name = header.next_level;
+        prefetcher.request(level_state.next_level_folder_name);
     } else {
         cout << "Next level name not present in JSON" << endl;
         level_state.next_level_folder_name = level_state.curr_level_folder_name;
@@ -72,14 +92,20 @@ void LevelParsingSystem::step(float elapsed_ms) {
 
     level_state.ground = level_ground_map.at(level_state.curr_level_folder_name);
 
-    tile_id_array = json_data["layers"][0]["data"];
-    stride = static_cast<int>(json_data["width"]) / TILE_TO_PIXELS;
+    tiles = level.tiles();
 
-    level_state.dimensions = vec2{ json_data["width"], json_data["height"] };
+    level_state.dimensions = vec2{ header.width, header.height };
     init_level_background();
-    init_level_entities(json_data["entities"]);
+    init_level_entities();
     init_player_and_camera();
 
+    // the chunks around the spawn are all there for the first frame
+    streamer.reset(level, tiles);
+    stream_level_chunks(UINT32_MAX);
+    if (hot_reload) {
+        watcher.watch(level_state.curr_level_folder_name);
+    }
+
     if (level_state.ground == TEXTURE_ASSET_ID::BOSS_ONE_LEVEL_GROUND) {
         for (Entity& e : registry.snoozeButtons.entities) {
             registry.remove_all_components_of(e);
@@ -124,41 +150,32 @@ void LevelParsingSystem::late_step(float elapsed_ms) {
 }
 
 /*
- * INITIALIZATION FUNCTIONS FOR PARSING AND CREATING OBJECTS FROM JSON
+ * INITIALIZATION FUNCTIONS FOR CREATING OBJECTS FROM THE COMPILED LEVEL
  */
 
 void LevelParsingSystem::init_level_background() {
-    // TODO: static w, h values -- should change (maybe parse from level file).
     LevelState& levelState = registry.levelStates.components[0];
-    float scale_factor = json_data["width"] > json_data["height"] ? ceil(static_cast<float>(json_data["width"]) / BACKGROUND_WIDTH) : ceil(static_cast<float>(json_data["height"]) / BACKGROUND_HEIGHT);
+    float level_w = level.header().width;
+    float level_h = level.header().height;
+    float scale_factor = level_w > level_h ? ceil(level_w / BACKGROUND_WIDTH) : ceil(level_h / BACKGROUND_HEIGHT);
     float background_w = BACKGROUND_WIDTH * scale_factor;
     float background_h = BACKGROUND_HEIGHT * scale_factor;
     create_parallaxbackground({background_w, background_h}, TEXTURE_ASSET_ID::GEARS_BACKGROUND);
     create_background({background_w, background_h}, TEXTURE_ASSET_ID::METAL_BACKGROUND);
-    create_levelground({json_data["width"], json_data["height"]}, levelState.ground);
-
-    // world boundaries
-    float world_w = json_data["width"];
-    float world_h = json_data["height"];
-    float shift_differential = 0.5 * TILE_TO_PIXELS;
-
-    // horizontal world boundaries (top/bottom)
-    create_world_boundary({world_w / 2.0f - shift_differential, 0.0f - (0.25 * world_h) - shift_differential}, {world_w, 1.0f});
-    create_world_boundary({world_w / 2.0f - shift_differential, world_h + (0.25 * world_h) - shift_differential}, {world_w, 1.0f});
+    create_levelground({level_w, level_h}, levelState.ground);
 
-    // vertical world boundaries (left/right)
-    create_world_boundary({0.0f - shift_differential, world_h / 2.0f - shift_differential}, {1.0f, world_h * 1.5});
-    create_world_boundary({world_w - shift_differential, world_h / 2.0f - shift_differential}, {1.0f, world_h * 1.5});
+    // world boundaries (placed by the compiler around the level's edges)
+    for (const LevelColliderRecord& collider : level.records<LevelColliderRecord>(LEVEL_SECTION_ID::COLLIDERS)) {
+        if (collider.kind == LEVEL_COLLIDER_KIND::WORLD_BOUNDARY) {
+            create_world_boundary(collider.position, collider.size);
+        }
+    }
 }
 
 void LevelParsingSystem::init_player_and_camera() {
-    json playerJson = json_data["entities"]["Player"][0];
-    vec2 initPos = vec2(playerJson["x"], playerJson["y"]);
-    float player_scale_factor = 1.5f;
-    if (!playerJson["customFields"]["scale"].is_null()) {
-        player_scale_factor = playerJson["customFields"]["scale"];
-    }
-    create_player(initPos, { int(playerJson["width"]) * player_scale_factor, int(playerJson["height"]) * player_scale_factor});
+    const LevelFileHeader& header = level.header();
+    vec2 initPos = header.player_position;
+    create_player(initPos, header.player_size);
     create_deceleration_bar(initPos + DECEL_BAR_OFFSET);
     create_camera(initPos, { 1.0f, 1.0f });
 
@@ -166,553 +183,349 @@ void LevelParsingSystem::init_player_and_camera() {
     // hardcode rn but maybe should pass position as text entity in ldtk?
     bool tutorial = true;
     if (tutorial) {
-		if (json_data["identifier"] == "Level_0") {
+        const string identifier = header.identifier;
+		if (identifier == "Level_0") {
             create_tutorial_text({ initPos.x + 2650, initPos.y }, {6000, 1500 }, TEXTURE_ASSET_ID::TUTORIAL_TEXT);
         }
-        if (json_data["identifier"] == "Level_4") {
+        if (identifier == "Level_4") {
             create_tutorial_text({ initPos.x + 1750, initPos.y - 140}, { 4000, 600 }, TEXTURE_ASSET_ID::BOSS_TUTORIAL_TEXT);
         }
-        else if (json_data["identifier"] == "Level_6") {
+        else if (identifier == "Level_6") {
             create_tutorial_text({ initPos.x + 250, initPos.y - 150 }, { 450, 70 }, TEXTURE_ASSET_ID::ACCEL);
         }
     }
 }
 
-void LevelParsingSystem::init_level_entities(json entities) {
-    // TODO: This is really ugly -- can prob clean this up with a map or smt.
-    for (auto& [entity_type, entity_list] : entities.items()) {
-        if (entity_type == "Platform") {
-            init_platforms(entity_list, false);
-        } else if (entity_type == "MovingPlatform") {
-            init_platforms(entity_list, true);
-        } else if (entity_type == "Spike") {
-            init_spikes(entity_list);
-        } else if (entity_type == "Door") {
-            init_doors(entity_list);
-        } else if (entity_type == "Projectile") {
-            reparsable_entities["Projectile"] = entity_list;
-            init_projectiles(entity_list);
-        } else if (entity_type == "Pipe") {
-            init_pipes(entity_list);
-        } else if (entity_type == "PipePart") {
-            init_pipeparts(entity_list);
-        } else if (entity_type == "Boundary") {
-            init_boundaries(entity_list);
-        } else if (entity_type == "PartOf") {
-            init_partof(entity_list);
-        } else if (entity_type == "Cannon") {
-            init_cannons(entity_list);
-        } else if (entity_type == "Ladder") {
-            init_ladders(entity_list);
-        } else if (entity_type == "Checkpoint") {
-            init_checkpoints(entity_list);
-        } else if (entity_type == "Breakable") {
-            reparsable_entities["Breakable"] = entity_list;
-            init_breakable_platforms(entity_list);
-        } else if (entity_type == "Chain") {
-            init_chains(entity_list);
-        } else if (entity_type == "Pendulum") {
-            init_pendulums(entity_list);
-        } else if (entity_type == "Gear") {
-            init_gears(entity_list);
-        } else if (entity_type == "Spikeball") {
-            init_spikeballs(entity_list);
-        } else if (entity_type == "Obstacle_spawner") {
-            init_spawners(entity_list);
-        } else if (entity_type == "Rolling_thing") {
-            init_rolling_things(entity_list);
-        } else if (entity_type == "Clock_hole") {
-            init_clock_holes(entity_list);
-        }
-    }
-
-
-}
-
-void LevelParsingSystem::init_clock_holes(json clock_holes) {
-    for (json& clock_hole : clock_holes) {
-        vec2 dimensions;
-        vec2 position;
-        if (!extract_boundary_attributes(clock_hole, dimensions, position)) {
+void LevelParsingSystem::init_level_entities() {
+    // phase one: the workers build the components of the batched sections, LEVEL_BATCH_RECORDS
+    // records per batch, into ids reserved here
+    struct BatchJob {
+        LEVEL_SECTION_ID section;
+        uint32_t first;
+        uint32_t count;
+        unsigned int first_id;
+    };
+    vector<BatchJob> jobs;
+    for (int section = (int)LEVEL_SECTION_ID::COLLIDERS; section < (int)LEVEL_SECTION_ID::CHUNKS; section++) {
+        if (!LevelBatch::batched((LEVEL_SECTION_ID)section)) {
             continue;
         }
-        create_clock_hole(position, dimensions);
-    }
-}
-
-
-void LevelParsingSystem::init_chains(json chains) {
-    LevelState& ls = registry.levelStates.components[0];
-    for (json& chain : chains) {
-        vec2 position = {chain["x"], ls.dimensions.y / 2};
-        vec2 scale = {TILE_TO_PIXELS * ceil(ls.dimensions.y / 1500), ls.dimensions.y};
-        create_chain(position, scale);
-    }
-}
-
-void LevelParsingSystem::init_breakable_platforms(json breakables) {
-    // clear all projectiles (for reparsing)
-    while (registry.breakables.entities.size() > 0) {
-        registry.remove_all_components_of(registry.breakables.entities.back());
-    }
-
-    for (json& breakable : breakables) {
-        vec2 size;
-
-        json json_full_size = breakable["customFields"]["size"];
-        if (!validate_custom_field(json_full_size, "size", breakable["iid"])) {
-            continue;
+        const uint32_t count = level.header().sections[section].count;
+        const unsigned int first_id = Entity::create_range(count);
+        for (uint32_t first = 0; first < count; first += LEVEL_BATCH_RECORDS) {
+            jobs.push_back({ (LEVEL_SECTION_ID)section, first, std::min(count - first, (uint32_t)LEVEL_BATCH_RECORDS), first_id + first });
         }
-        int full_size = json_full_size;
+    }
+    vector<LevelBatch> batches(jobs.size());
+    workers.run((int)jobs.size(), [&](int i) {
+        batches[i].build(level, jobs[i].section, jobs[i].first, jobs[i].count, jobs[i].first_id);
+    });
 
-        json json_direction = breakable["customFields"]["direction"];
-        if (!validate_custom_field(json_direction, "direction", breakable["iid"])) {
+    // phase two: sections in the order the level's entities were created in when they were read from
+    // the export; batches are inserted in bulk, the other sections created record by record
+    size_t job = 0;
+    for (int section = (int)LEVEL_SECTION_ID::COLLIDERS; section < (int)LEVEL_SECTION_ID::CHUNKS; section++) {
+        if (!LevelBatch::batched((LEVEL_SECTION_ID)section)) {
+            instantiate_section((LEVEL_SECTION_ID)section);
             continue;
         }
-        string direction = json_direction;
-
-        int conversion_factor;
-        bool is_x_axis;
-        if (direction == "up" || direction == "down")
-        {
-            size = {breakable["width"], static_cast<int>(breakable["height"]) * full_size};
-            if (direction == "up") {
-                conversion_factor = (static_cast<int>(breakable["height"]) / 2) - (static_cast<int>(size.y) / 2);
-            } else {
-                conversion_factor = (static_cast<int>(size.y) / 2) - (static_cast<int>(breakable["height"]) / 2);
+        vector<RecordEntities>& entities = record_entities[section];
+        entities.assign(level.header().sections[section].count, RecordEntities());
+        for (; job < jobs.size() && jobs[job].section == (LEVEL_SECTION_ID)section; job++) {
+            batches[job].insert();
+            for (uint32_t i = 0; i < jobs[job].count; i++) {
+                const unsigned int id = jobs[job].first_id + i;
+                entities[jobs[job].first + i] = { id, batches[job].created(i) ? id + 1 : id };
             }
-            is_x_axis = false;
         }
-        else
-        {
-            size = {static_cast<int>(breakable["width"]) * full_size, breakable["height"]};
-            if (direction == "left") {
-                conversion_factor = (static_cast<int>(breakable["width"]) / 2) - (static_cast<int>(size.x) / 2);
-            } else {
-                conversion_factor = (static_cast<int>(size.x) / 2) - (static_cast<int>(breakable["width"]) / 2);
-            }
-            is_x_axis = true;
-        }
-
-        vec2 start_pos = {static_cast<int>(breakable["x"]) / TILE_TO_PIXELS, static_cast<int>(breakable["y"]) / TILE_TO_PIXELS};
-        vec2 position = centralize_position(start_pos, conversion_factor, is_x_axis);
-
-        create_time_controllable_breakable_static_platform(position, size, false, 2.0, tile_id_array, stride);
-    }
-}
-
-void LevelParsingSystem::init_spawners(json gear_spawners) {
-    for (json& gear_spawner : gear_spawners) {
-        json customFields = gear_spawner["customFields"];
-        vec2 velocity = vec2{customFields["x_velocity"], customFields["y_velocity"]};
-        vec2 size = vec2{customFields["width"], customFields["height"]};
-
-        vec2 start_pos = vec2{customFields["start_point"]["cx"], customFields["start_point"]["cy"]};
-        start_pos *= TILE_TO_PIXELS;
-
-        vec2 end_pos = vec2{customFields["end_point"]["cx"], customFields["end_point"]["cy"]};
-        end_pos *= TILE_TO_PIXELS;
-
-        std::string type = customFields["Type"];
-
-        create_spawner(type, size, velocity, start_pos, end_pos);
     }
 }
 
-void LevelParsingSystem::init_rolling_things(json rolling_things) {
-    for (json& rolling_thing : rolling_things) {
-        vec2 position = {rolling_thing["x"], rolling_thing["y"]};
-        vec2 scale = {rolling_thing["customFields"]["width"], rolling_thing["customFields"]["height"]};
-        create_rolling_thing(position, scale);
+void LevelParsingSystem::stream_level_chunks(uint32_t budget) {
+    if (registry.cameras.entities.size() < 1) {
+        return;
     }
-}
-
-
-
-void LevelParsingSystem::init_pipes(json pipes) {
-    for (json& pipe : pipes) {
-        vec2 position = {pipe["x"], pipe["y"]};
-        vec2 scale = {pipe["width"], pipe["height"]};
-
-        json json_direction = pipe["customFields"]["direction"];
-        if (!validate_custom_field(json_direction, "direction", pipe["iid"])) {
-            continue;
+    const Motion& camera_motion = registry.motions.get(registry.cameras.entities[0]);
+    streamer.update(camera_motion.position, CameraSystem::get_camera_offsets(camera_motion.scale), budget);
+}
+
+void LevelParsingSystem::instantiate_section(LEVEL_SECTION_ID section) {
+    vector<RecordEntities>& entities = record_entities[(int)section];
+    entities.assign(level.header().sections[(int)section].count, RecordEntities());
+    for (uint32_t i = 0; i < entities.size(); i++) {
+        entities[i] = instantiate_record(section, i);
+    }
+}
+
+LevelParsingSystem::RecordEntities LevelParsingSystem::instantiate_record(LEVEL_SECTION_ID section, uint32_t index) {
+    // creators make their entities back to back, so a record's entities are one id range
+    RecordEntities entities;
+    entities.first_id = Entity::create_range(0);
+
+    switch (section) {
+    case LEVEL_SECTION_ID::COLLIDERS: {
+        const LevelColliderRecord& collider = level.records<LevelColliderRecord>(section).first[index];
+        switch (collider.kind) {
+        case LEVEL_COLLIDER_KIND::LEVEL_BOUNDARY:
+            create_level_boundary(collider.position, collider.size);
+            break;
+        case LEVEL_COLLIDER_KIND::PLATFORM:
+            create_static_collider(collider.position, collider.size);
+            break;
+        case LEVEL_COLLIDER_KIND::SPIKE:
+            create_spike_collider(collider.position, collider.size);
+            break;
+        default:
+            // world boundaries are created with the background
+            break;
         }
-        json json_time_offset = pipe["customFields"]["time_offset"];
-        if (!validate_custom_field(json_time_offset, "time_offset", pipe["iid"]))
-        {
-            continue;
+        break;
+    }
+    case LEVEL_SECTION_ID::BREAKABLES: {
+        const LevelBoxRecord& breakable = level.records<LevelBoxRecord>(section).first[index];
+        create_time_controllable_breakable_static_platform(breakable.position, breakable.size, false, 2.0);
+        break;
+    }
+    case LEVEL_SECTION_ID::CANNONS:
+        create_cannon_tower(level.records<LevelPointRecord>(section).first[index].position);
+        break;
+    case LEVEL_SECTION_ID::CHAINS: {
+        const LevelBoxRecord& chain = level.records<LevelBoxRecord>(section).first[index];
+        create_chain(chain.position, chain.size);
+        break;
+    }
+    case LEVEL_SECTION_ID::CHECKPOINTS:
+        create_spawnpoint(level.records<LevelPointRecord>(section).first[index].position, SPAWNPOINT_SCALE);
+        break;
+    case LEVEL_SECTION_ID::CLOCK_HOLES: {
+        const LevelBoxRecord& clock_hole = level.records<LevelBoxRecord>(section).first[index];
+        create_clock_hole(clock_hole.position, clock_hole.size);
+        break;
+    }
+    case LEVEL_SECTION_ID::DOORS: {
+        const LevelDoorRecord& door = level.records<LevelDoorRecord>(section).first[index];
+        create_door(door.position, door.open, tiles);
+        break;
+    }
+    case LEVEL_SECTION_ID::GEARS: {
+        const LevelGearRecord& gear = level.records<LevelGearRecord>(section).first[index];
+        create_gear(gear.position, gear.size, gear.fixed, gear.angular_velocity, gear.initial_angle);
+        break;
+    }
+    case LEVEL_SECTION_ID::LADDERS: {
+        const LevelLadderRecord& ladder = level.records<LevelLadderRecord>(section).first[index];
+        create_ladder(ladder.position, ladder.size, ladder.height, tiles);
+        break;
+    }
+    case LEVEL_SECTION_ID::MOVING_PLATFORMS: {
+        const LevelMovingPlatformRecord& platform = level.records<LevelMovingPlatformRecord>(section).first[index];
+        vector<Path> paths;
+        paths.push_back(Path(platform.start, platform.end, platform.duration));
+        paths.push_back(Path(platform.end, platform.start, platform.duration));
+        create_moving_platform(platform.size, paths, platform.initial_position, tiles, platform.rounded);
+        break;
+    }
+    case LEVEL_SECTION_ID::SPAWNERS: {
+        const LevelSpawnerRecord& spawner = level.records<LevelSpawnerRecord>(section).first[index];
+        create_spawner(std::string(spawner.type), spawner.size, spawner.velocity, spawner.start_position, spawner.end_position);
+        break;
+    }
+    case LEVEL_SECTION_ID::PENDULUMS: {
+        const LevelPendulumRecord& pendulum = level.records<LevelPendulumRecord>(section).first[index];
+        create_pendulum(pendulum.pivot_position, pendulum.length, pendulum.initial_angle, pendulum.bob_radius);
+        break;
+    }
+    case LEVEL_SECTION_ID::PIPES: {
+        const LevelPipeRecord& pipe = level.records<LevelPipeRecord>(section).first[index];
+        create_pipe_head(pipe.position, pipe.size, level_direction_name(pipe.direction), tiles, pipe.time_offset);
+        break;
+    }
+    case LEVEL_SECTION_ID::PLATFORMS: {
+        // the other platforms are tiles over merged colliders, streamed with their chunk
+        const LevelPlatformRecord& platform = level.records<LevelPlatformRecord>(section).first[index];
+        if (platform.rounded) {
+            create_static_platform(platform.position, platform.size, tiles, true);
         }
-
-        string direction = json_direction;
-        float time_offset = json_time_offset;
-        create_pipe_head(position, scale, direction, tile_id_array, stride, time_offset);
+        break;
     }
-}
-
-void LevelParsingSystem::init_pipeparts(json parts) {
-    for (json& pipe_part : parts) {
-        vec2 position = {pipe_part["x"], pipe_part["y"]};
-        vec2 size = {pipe_part["width"], pipe_part["height"]};
-        create_static_platform(position, size, tile_id_array, stride, false);
+    case LEVEL_SECTION_ID::PROJECTILES: {
+        const LevelBoxRecord& projectile = level.records<LevelBoxRecord>(section).first[index];
+        vec2 velocity = {0, 0};
+        create_bolt(projectile.position, projectile.size, velocity, false, true);
+        break;
     }
-}
-
-
-
-void LevelParsingSystem::init_doors(json doors) {
-    for (json door : doors) {
-        json json_open = door["customFields"]["open"];
-        if (!validate_custom_field(json_open, "open", door["iid"])) {
-            continue;
-        }
-        bool open = json_open;
-
-        vec2 position;
-        extract_door_position(door, position);
-        create_door(position, open, this->tile_id_array, this->stride);
+    case LEVEL_SECTION_ID::ROLLING_THINGS: {
+        const LevelBoxRecord& rolling_thing = level.records<LevelBoxRecord>(section).first[index];
+        create_rolling_thing(rolling_thing.position, rolling_thing.size);
+        break;
     }
-}
-
-void LevelParsingSystem::init_checkpoints(json checkpoints) {
-    for (json checkpoint : checkpoints) {
-        vec2 position = {checkpoint["x"], static_cast<float>(checkpoint["y"]) + PARSING_CHECKPOINT_Y_POS_DIFF};
-        create_spawnpoint(position, SPAWNPOINT_SCALE);
+    case LEVEL_SECTION_ID::SPIKEBALLS: {
+        const LevelBoxRecord& spikeball = level.records<LevelBoxRecord>(section).first[index];
+        create_spikeball(spikeball.position, spikeball.size);
+        break;
     }
-}
-
-
-void LevelParsingSystem::init_cannons(json cannons) {
-    for (json cannon : cannons) {
-        vec2 position = {cannon["x"], static_cast<float>(cannon["y"]) + PARSING_CANNON_Y_POS_DIFF};
-        create_cannon_tower(position);
+    default:
+        // tiles, and the sections streamed by chunk
+        break;
     }
-}
 
-void LevelParsingSystem::init_ladders(json ladders) {
-    for (json ladder : ladders) {
-        vec2 position = {ladder["x"], ladder["y"]};
-
-        json json_length = ladder["customFields"]["length"];
-        if (!validate_custom_field(json_length, "length", ladder["iid"], {"cx", "cy"})) {
-            continue;
-        }
-        int height = abs(static_cast<int>(json_length["cy"]) - (position.y / TILE_TO_PIXELS)) + 1;
-
-        vec2 dimensions = {ladder["width"], ladder["height"]};
-        create_ladder(position, dimensions, height, tile_id_array, stride);
-    }
+    entities.end_id = Entity::create_range(0);
+    return entities;
 }
 
-void LevelParsingSystem::init_pendulums(json pendulum) {
-    for (json pendulum : pendulum) {
-        vec2 pivot_position = {pendulum["x"], pendulum["y"]};
-
-        json json_end_pos = pendulum["customFields"]["length"];
-        if (!validate_custom_field(json_end_pos, "length", pendulum["iid"], {"cx", "cy"})) {
-            continue;
-        }
-        float end_pos_y = json_end_pos["cy"];
-        float length = abs(pivot_position.y - (end_pos_y * TILE_TO_PIXELS));
-
-        json json_initial_angle = pendulum["customFields"]["initial_angle"];
-        json json_bob_radius = pendulum["customFields"]["bob_radius"];
-
-        if (!validate_custom_field(json_initial_angle, "initial_angle", pendulum["iid"]) ||
-            !validate_custom_field(json_bob_radius, "bob_radius", pendulum["iid"])) {
-            continue;
-        }
-
-        float initial_angle = json_initial_angle;
-        float bob_radius = json_bob_radius;
-
-        create_pendulum(pivot_position, length, initial_angle, bob_radius);
-
-    }
-}
-
-void LevelParsingSystem::init_spikeballs(json spikeballs) {
-    for (json spikeball : spikeballs) {
-        json json_width = spikeball["customFields"]["width"];
-        json json_height = spikeball["customFields"]["height"];
-
-        if (!validate_custom_field(json_width, "width", spikeball["iid"]) ||
-            !validate_custom_field(json_height, "height", spikeball["iid"])) {
-            continue;
-        }
-        vec2 position = {spikeball["x"], spikeball["y"]};
-        vec2 size_px = {json_width, json_height};
-        create_spikeball(position, size_px);
-    }
-}
-
-
-void LevelParsingSystem::init_gears(json gears) {
-    for (json gear : gears) {
-        vec2 position = {gear["x"], gear["y"]};
-
-        json json_gear_edge = gear["customFields"]["gear_edge"];
-        if (!validate_custom_field(json_gear_edge, "gear_edge", gear["iid"], {"cx", "cy"})) {
-            continue;
-        }
-        vec2 gear_edge_pos = {json_gear_edge["cx"], json_gear_edge["cy"]};
-        float radius = abs(position.x  - (gear_edge_pos.x * TILE_TO_PIXELS));
-
-        // TODO: error handling
-        bool fixed = gear["customFields"]["fixed"];
-        float angular_velocity = gear["customFields"]["angular_velocity"];
-        float inital_angle = gear["customFields"]["initial_angle"];
-
-        vec2 size_px = {radius * 2, radius * 2};
-        create_gear(position, size_px, fixed, angular_velocity, inital_angle);
+void LevelParsingSystem::init_breakable_platforms() {
+    // clear all breakables (for reparsing)
+    while (registry.breakables.entities.size() > 0) {
+        registry.remove_all_components_of(registry.breakables.entities.back());
     }
+    instantiate_section(LEVEL_SECTION_ID::BREAKABLES);
 }
 
-void LevelParsingSystem::init_projectiles(json projectiles) {
+void LevelParsingSystem::init_projectiles() {
     // clear all bolts (for reparsing)
     while (registry.bolts.entities.size() > 0) {
         registry.remove_all_components_of(registry.bolts.entities.back());
     }
-
-    for (json projectile: projectiles) {
-        vec2 position = vec2{projectile["x"], projectile["y"]};
-        vec2 velocity = {0, 0};
-        float scale = projectile["customFields"]["scale"];
-        vec2 size = vec2 {scale, scale};
-        // TODO: handle other meshtypes? (some are null in json rn so cannot parse)
-        // string meshtype = "";
-        // if (projectile["customFields"]["meshtype"]) meshtype = projectile["customFields"]["meshtype"];
-        create_bolt(position, size, velocity, false, true);
-    }
+    instantiate_section(LEVEL_SECTION_ID::PROJECTILES);
 }
 
-void LevelParsingSystem::init_boundaries(json boundaries) {
-    for (json boundary : boundaries) {
-        vec2 dimensions;
-        vec2 position;
-        if (!extract_boundary_attributes(boundary, dimensions, position)) {
-            continue;
-        }
-        create_level_boundary(position, dimensions);
-    }
-}
+/*
+ * HOT RELOAD
+ */
 
-void LevelParsingSystem::init_spikes(json spikes) {
-    for (json spike : spikes) {
-        json json_end_pos = spike["customFields"]["length"];
-        if (!validate_custom_field(json_end_pos, "length", spike["iid"], {"cx", "cy"})) {
-            continue;
-        }
-        vec2 end_pos = {static_cast<int>(json_end_pos["cx"]) * TILE_TO_PIXELS, static_cast<int>(json_end_pos["cy"]) * TILE_TO_PIXELS};
+void LevelParsingSystem::apply_level_edit(PreparedLevel& edited) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    const LevelFileHeader& header = level.header();
+    const LevelFileHeader& edited_header = edited.level.header();
+
+    // the tile layer and the level's bounds are baked into most entities, only a full load redoes them
+    if (header.width != edited_header.width || header.height != edited_header.height ||
+        strcmp(header.identifier, edited_header.identifier) != 0 || strcmp(header.next_level, edited_header.next_level) != 0 ||
+        header.sections[(int)LEVEL_SECTION_ID::TILES].count != edited_header.sections[(int)LEVEL_SECTION_ID::TILES].count ||
+        memcmp(level.record_data(LEVEL_SECTION_ID::TILES, 0), edited.level.record_data(LEVEL_SECTION_ID::TILES, 0),
+            header.sections[(int)LEVEL_SECTION_ID::TILES].count * sizeof(uint16_t)) != 0) {
+        cout << edited.name << ": layout changed, reloading" << endl;
+        current_level = std::move(edited);
+        registry.levelStates.components[0].shouldLoad = true;
+        return;
+    }
 
-        json json_direction = spike["customFields"]["direction"];
-        if (!validate_custom_field(json_direction, "direction", spike["iid"])) {
-            continue;
-        }
-        string direction = json_direction;
-        bool is_x_axis = direction == "left" || direction == "right";
-        int pos_stride = TILE_TO_PIXELS * (direction == "left" || direction == "up" ? -1 : 1);
-
-        vec2 dimensions = {spike["width"], spike["height"]};
-        vec2 start_pos = {spike["x"], spike["y"]};
-        int num_spikes = is_x_axis ? abs(end_pos.x - start_pos.x) / dimensions.x : abs(end_pos.y - start_pos.y) / dimensions.y;
-
-        for (int i = 0; i <= num_spikes; i++) {
-            vec2 position;
-            if (is_x_axis) {
-                position = {start_pos.x + (i * pos_stride), start_pos.y};
+    // records are matched by the iid of their entity: one whose record changed was edited, it is
+    // destroyed and created again while everything else keeps its entities and their state. Records
+    // without an entity (merged colliders, tiles) are matched by content.
+    vector<RecordEntities> edited_entities[level_section_count];
+    vector<uint32_t> added[level_section_count];
+    bool section_changed[level_section_count] = {};
+    uint32_t added_count = 0;
+    uint32_t removed_count = 0;
+    for (int section = (int)LEVEL_SECTION_ID::COLLIDERS; section < (int)LEVEL_SECTION_ID::CHUNKS; section++) {
+        const LEVEL_SECTION_ID id = (LEVEL_SECTION_ID)section;
+        const uint32_t record_size = level_record_sizes[section];
+        const uint32_t record_count = header.sections[section].count;
+        const uint64_t* keys = level.record_keys(id);
+        const uint64_t* edited_keys = edited.level.record_keys(id);
+
+        // an entity may have several records, they are matched in order
+        std::unordered_map<uint64_t, vector<uint32_t>> unmatched_keys;
+        std::unordered_map<std::string_view, vector<uint32_t>> unmatched_records;
+        for (uint32_t i = record_count; i-- > 0;) {
+            if (keys[i] != 0) {
+                unmatched_keys[keys[i]].push_back(i);
             } else {
-                position = {start_pos.x, start_pos.y + (i * pos_stride)};
+                unmatched_records[std::string_view((const char*)level.record_data(id, i), record_size)].push_back(i);
             }
-            create_spike(position, dimensions, tile_id_array, stride);
         }
-    }
-}
 
-void LevelParsingSystem::init_partof(json partof) {
-    for (json pf : partof) {
-        vec2 dimensions = {pf["width"], pf["height"]};
-        vec2 position = {pf["x"], pf["y"]};
-        create_partof(position, dimensions, tile_id_array, stride);
-    }
-}
-
-void LevelParsingSystem::init_platforms(json platforms, bool moving) {
-    for (json platform : platforms) {
-        vec2 dimensions;
-        vec2 startPos;
-        bool rounded;
-        if (moving) {
-            vector<Path> path;
-            if (!extract_path_attributes(platform, path, startPos, dimensions, rounded)) {
+        vector<char> kept(record_count, 0);
+        edited_entities[section].assign(edited_header.sections[section].count, RecordEntities());
+        for (uint32_t i = 0; i < edited_header.sections[section].count; i++) {
+            const std::string_view record((const char*)edited.level.record_data(id, i), record_size);
+            vector<uint32_t>* candidates = nullptr;
+            if (edited_keys[i] != 0) {
+                auto match = unmatched_keys.find(edited_keys[i]);
+                candidates = match != unmatched_keys.end() ? &match->second : nullptr;
+            } else {
+                auto match = unmatched_records.find(record);
+                candidates = match != unmatched_records.end() ? &match->second : nullptr;
+            }
+            if (candidates == nullptr || candidates->empty()) {
+                added[section].push_back(i);
                 continue;
             }
-            create_moving_platform(dimensions, path, startPos, tile_id_array, stride, rounded);
-        } else {
-            if (!extract_platform_attributes(platform, dimensions, startPos, rounded)) {
+
+            const uint32_t old_index = candidates->back();
+            candidates->pop_back();
+            if (memcmp(level.record_data(id, old_index), record.data(), record_size) != 0) {
+                added[section].push_back(i);
                 continue;
             }
-            create_static_platform(startPos, dimensions, tile_id_array, stride, rounded);
+            edited_entities[section][i] = record_entities[section][old_index];
+            kept[old_index] = 1;
         }
-    }
-}
-
-/*
- * HELPERS FOR EXTRACTING INFORMATION FROM JSON
- */
 
-bool LevelParsingSystem::extract_door_position(json door, vec2& position) {
-    int x_start = static_cast<float>(door["x"]) - (0.5 * TILE_TO_PIXELS);
-    int y_start = static_cast<float>(door["y"]) + (0.5 * TILE_TO_PIXELS);
-
-    int x = x_start + (0.5 * DOOR_SIZE.x);
-    int y = y_start - (0.5 * DOOR_SIZE.y);
-
-    position = {x, y};
-    return true;
-}
-
-bool LevelParsingSystem::extract_boundary_attributes(json boundary, vec2& dimensions, vec2& position) {
-    int x = boundary["x"];
-    int y = boundary["y"];
-    vec2 start_pos = vec2{x / TILE_TO_PIXELS, y / TILE_TO_PIXELS};
-
-    json end_pos_json = boundary["customFields"]["length"];
-    if (!validate_custom_field(end_pos_json, "length", boundary["iid"])) {
-        return false;
-    }
-    vec2 end_pos = {end_pos_json["cx"], end_pos_json["cy"]};
-
-    int size;
-    json json_direction = boundary["customFields"]["direction"];
-    if (!validate_custom_field(json_direction, "direction", boundary["iid"])) {
-        return false;
-    }
-    string direction = json_direction;
-
-    int conversion_factor;
-    bool is_x_axis;
-    if (direction == "up" || direction == "down")
-    {
-        size = abs(end_pos.y - start_pos.y) + 1;
-        dimensions = {boundary["width"], static_cast<int>(boundary["height"]) * size};
-
-        if (direction == "up") {
-            conversion_factor = (static_cast<int>(boundary["height"]) / 2) - (static_cast<int>(dimensions.y) / 2);
-        } else {
-            conversion_factor = (static_cast<int>(dimensions.y) / 2) - (static_cast<int>(boundary["height"]) / 2);
+        // pooled bolts may have been recycled by other bolts, they are all created afresh instead
+        const bool pooled = id == LEVEL_SECTION_ID::PROJECTILES;
+        for (uint32_t i = 0; i < record_count; i++) {
+            if (kept[i]) {
+                continue;
+            }
+            const RecordEntities& entities = record_entities[section][i];
+            for (unsigned int entity_id = entities.first_id; entity_id < entities.end_id && !pooled; entity_id++) {
+                destroy_spawned_entities(Entity(entity_id));
+                registry.remove_all_components_of(Entity(entity_id));
+            }
+            removed_count++;
+            section_changed[section] = true;
         }
-        is_x_axis = false;
-    }
-    else
-    {
-        size = abs(end_pos.x - start_pos.x) + 1;
-        dimensions = {static_cast<int>(boundary["width"]) * size, boundary["height"]};
-
-        if (direction == "left") {
-            conversion_factor = (static_cast<int>(boundary["width"]) / 2) - (static_cast<int>(dimensions.x) / 2);
-        } else {
-            conversion_factor = (static_cast<int>(dimensions.x) / 2) - (static_cast<int>(boundary["width"]) / 2);
+        section_changed[section] |= !added[section].empty();
+        if (pooled) {
+            added[section].clear();
         }
-        is_x_axis = true;
+        added_count += (uint32_t)added[section].size();
     }
 
-    position = centralize_position(start_pos, conversion_factor, is_x_axis);
-    return true;
-}
+    // chunks still hold views into the old level, they are carried over before it is released
+    LevelTiles edited_tiles = edited.level.tiles();
+    streamer.apply_edit(edited.level, edited_tiles);
 
-
-bool LevelParsingSystem::extract_full_platform_dimensions(json platform, vec2& dimensions) {
-    json json_size = platform["customFields"]["size"];
-    if (!validate_custom_field(json_size, "size", platform["iid"])) {
-        return false;
-    }
-    int full_size = json_size;
-    int full_width = full_size * static_cast<int>(platform["width"]);
-    dimensions = {full_width, platform["height"]};
-
-    return true;
-}
-
-bool LevelParsingSystem::extract_platform_attributes(json platform, vec2& dimensions, vec2& startPos, bool& rounded) {
-    if (!extract_full_platform_dimensions(platform, dimensions)) {
-        return false;
-    }
-
-    int left_x = static_cast<int>(platform["x"]) - (static_cast<int>(platform["width"]) / 2);
-    int start_x = left_x + (static_cast<int>(dimensions[0]) / 2);
-    startPos = {start_x, platform["y"]};
-
-    json json_rounded = platform["customFields"]["rounded"];
-    if (!validate_custom_field(json_rounded, "rounded", platform["iid"])) {
-        return false;
-    }
-    rounded = json_rounded;
-
-    return true;
-}
-
-bool LevelParsingSystem::extract_path_attributes(json platform, vector<Path>& paths, vec2& init_pos_in_path, vec2& dimensions, bool& rounded) {
-    extract_full_platform_dimensions(platform, dimensions);
-
-    // currently all position values in json are relative to leftmost tile in platform -- need to centralize position on x-axis.
-    int conversion_factor = (static_cast<int>(dimensions.x) / 2) - (static_cast<int>(platform["width"]) / 2);
-
-    json start_pos_json = platform["customFields"]["start"];
-    if (!validate_custom_field(start_pos_json, "start", platform["iid"], {"cx", "cy"})) {
-        return false;
-    }
-    vec2 start_pos = convert_and_centralize_position(start_pos_json, conversion_factor);
-
-    json end_pos_json = platform["customFields"]["end"];
-    if (!validate_custom_field(end_pos_json, "start", platform["iid"], {"cx", "cy"})) {
-        return false;
-    }
-    vec2 end_pos = convert_and_centralize_position(end_pos_json, conversion_factor);
-
-    int left_x = static_cast<int>(platform["x"]) - (static_cast<int>(platform["width"]) / 2);
-    int start_x = left_x + (static_cast<int>(dimensions[0]) / 2);
-    init_pos_in_path = {start_x, platform["y"]};
-
-    // set duration to default value of 0.5 if no duration is set.
-    json json_duration = platform["customFields"]["duration"];
-    if (!validate_custom_field(json_duration, "duration", platform["iid"])) {
-        return false;
-    }
-    float duration = json_duration;
-    if (duration == 0.0) {
-        duration = 0.5;
+    current_level = std::move(edited);
+    level = current_level.level;
+    tiles = edited_tiles;
+    for (int section = 0; section < level_section_count; section++) {
+        record_entities[section] = std::move(edited_entities[section]);
+        for (uint32_t i : added[section]) {
+            record_entities[section][i] = instantiate_record((LEVEL_SECTION_ID)section, i);
+        }
     }
 
-    Path forward = Path(start_pos, end_pos, duration);
-    Path backward = Path(end_pos, start_pos, duration);
-    paths.push_back(forward);
-    paths.push_back(backward);
-
-    json json_rounded = platform["customFields"]["rounded"];
-    if (!validate_custom_field(json_rounded, "rounded", platform["iid"])) {
-        return false;
+    if (section_changed[(int)LEVEL_SECTION_ID::PROJECTILES]) {
+        init_projectiles();
+        added_count += (uint32_t)record_entities[(int)LEVEL_SECTION_ID::PROJECTILES].size();
     }
-    rounded = json_rounded;
 
-    return true;
+    const float elapsed_ms = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    cout << current_level.name << ": hot reloaded, " << added_count << " records created, " << removed_count
+        << " removed in " << elapsed_ms << " ms" << endl;
 }
 
 /*
  * OTHER HELPERS
  */
 
-bool LevelParsingSystem::parse_json() {
-    LevelState& level_state = registry.levelStates.components[0];
-    string filename = PROJECT_SOURCE_DIR + std::string("../LDtk/") + level_state.curr_level_folder_name + string("/data.json");
-    ifstream level_file(filename);
-    if (!level_file) {
-        cout << "Error could not open file " << filename << endl;
-        return false;
+bool LevelParsingSystem::load_level() {
+    const string level_name = registry.levelStates.components[0].curr_level_folder_name;
+
+    // reloads reuse the loaded level; switching takes the prefetched one, or prepares it here
+    // if the prefetch was for another level or failed
+    if (current_level.name != level_name || !current_level.level.is_open()) {
+        PreparedLevel next_level;
+        if (!prefetcher.take(level_name, next_level) && !prepare_level(level_name, next_level)) {
+            return false;
+        }
+        current_level = std::move(next_level);
     }
 
-    level_file >> json_data;
-    level_file.close();
+    level = current_level.level;
     return true;
 }
 
@@ -727,57 +540,34 @@ bool LevelParsingSystem::parse_rolling_thing_json() {
     json rolling_thing_json;
     rolling_thing >> rolling_thing_json;
 
-    // populate the map in the registry TODO: I think there is a way to just directly get this from the json library
+    // the file maps frame numbers to x offsets; count the spawns of each frame first, then flatten them
+    // so a frame's spawns are found without building a key
+    RollingThingTimeline& timeline = registry.rolling_thing_timeline;
+    timeline = RollingThingTimeline();
     for (auto& [key, value] : rolling_thing_json.items()) {
-        std::vector<int> int_vector;
-        for (auto& element : value) {
-            int_vector.push_back(element.get<int>());
+        // only the canonical spelling, so two keys can never name the same frame
+        char* end;
+        const long frame = strtol(key.c_str(), &end, 10);
+        if (key.empty() || *end != '\0' || frame < 0 || std::to_string(frame) != key || !value.is_array()) {
+            cout << "Error: rolling thing frame \"" << key << "\" is not a frame number with a list of x offsets" << endl;
+            timeline = RollingThingTimeline();
+            return false;
+        }
+        if (timeline.frame_start.size() < (size_t)frame + 2) {
+            timeline.frame_start.resize(frame + 2, 0);
         }
-        registry.rolling_thing_data[key] = int_vector;
+        timeline.frame_start[frame + 1] = (uint32_t)value.size();
     }
-    rolling_thing.close();
-    return true;
-}
-
-
-vec2 LevelParsingSystem::convert_and_centralize_position(json pos, int conversion_factor) {
-    return vec2({
-        static_cast<int>(pos["cx"]) * TILE_TO_PIXELS + conversion_factor,
-        static_cast<int>(pos["cy"]) * TILE_TO_PIXELS
-    });
-}
-
-vec2 LevelParsingSystem::centralize_position(vec2 pos, int conversion_factor, bool is_x_axis) {
-    return vec2({
-        pos.x * TILE_TO_PIXELS + (is_x_axis ? conversion_factor : 0),
-        pos.y * TILE_TO_PIXELS + (!is_x_axis ? conversion_factor : 0)
-    });
-}
-
-bool LevelParsingSystem::validate_custom_field(json attribute, string attribute_name, string entity_id, vector<string> sub_attributes) {
-    if (attribute.is_null()) {
-        string error = "NULL value for customField: " + attribute_name;
-        print_parsing_error(error, entity_id);
-        return false;
+    for (size_t frame = 1; frame < timeline.frame_start.size(); frame++) {
+        timeline.frame_start[frame] += timeline.frame_start[frame - 1];
     }
 
-    if (!sub_attributes.empty()) {
-        for (const string& sub : sub_attributes) {
-            if (!validate_custom_field(attribute[sub], sub, entity_id)) {
-                return false;
-            }
+    timeline.spawn_x.resize(timeline.frame_start.empty() ? 0 : timeline.frame_start.back());
+    for (auto& [key, value] : rolling_thing_json.items()) {
+        uint32_t spawn = timeline.frame_start[strtol(key.c_str(), nullptr, 10)];
+        for (auto& element : value) {
+            timeline.spawn_x[spawn++] = element.get<float>();
         }
     }
-
     return true;
 }
-
-void LevelParsingSystem::print_parsing_error(string& error, string entity_id) {
-    LevelState& ls = registry.levelStates.components[0];
-    cout << "\033[96m" << ls.curr_level_folder_name << ": ";
-
-    cout << "\033[91m" << "Error when parsing entity " << "\033[93m" << entity_id << ": " << "\033[91m" << error << endl;
-
-    // set the line color back to normal in console
-    cout << "\033[0m";
-}
\ No newline at end of file
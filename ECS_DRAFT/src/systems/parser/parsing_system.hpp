@@ -3,6 +3,10 @@
 #include "json.hpp"
 #include "tinyECS/components.hpp"
 #include "tinyECS/registry.hpp"
+#include "level_prefetcher.hpp"
+#include "level_streamer.hpp"
+#include "level_watcher.hpp"
+#include "worker_pool.hpp"
 using namespace std;
 using namespace nlohmann;
 
@@ -19,15 +23,33 @@ public:
         registry.gameStates.components[0].game_scene_transition_state = SCENE_TRANSITION_STATE::TRANSITION_OUT;
     }
 
+    // Dev mode: saving the export of the level being played applies the edit to the live level
+    void set_hot_reload(bool enabled) { hot_reload = enabled; }
+
     LevelParsingSystem()
     {
     }
 private:
+    // Ids of the entities created for one record
+    struct RecordEntities {
+        unsigned int first_id = 0;
+        unsigned int end_id = 0;
+    };
+
     GLFWwindow* window = nullptr;
 
-    json json_data;
-    json tile_id_array;
-    int stride;
+    // the current level stays loaded for reloads; the next one is prepared in the background
+    PreparedLevel current_level;
+    LevelPrefetcher prefetcher;
+    LevelView level;
+    LevelTiles tiles;
+    LevelStreamer streamer;
+    std::vector<RecordEntities> record_entities[level_section_count];
+    // build the components of the level's plain records while it loads
+    WorkerPool workers;
+
+    bool hot_reload = false;
+    LevelWatcher watcher;
 
     const std::unordered_map<std::string, TEXTURE_ASSET_ID> level_ground_map =
     {
@@ -42,42 +64,15 @@ private:
         {"Level_9", TEXTURE_ASSET_ID::DECEL_LEVEL_9_GROUND}
     };
 
-    json reparsable_entities = {};
-
-    bool parse_json();
+    bool load_level();
     bool parse_rolling_thing_json();
     void init_level_background();
     void init_player_and_camera();
-    void init_level_entities(json entities);
-    void init_platforms(json platforms, bool moving);
-    void init_boundaries(json boundaries);
-    void init_partof(json partof);
-    void init_spikes(json spikes);
-    void init_projectiles(json projectiles);
-    void init_cannons(json cannons);
-    void init_ladders(json ladders);
-    void init_checkpoints(json checkpoints);
-    void init_doors(json doors);
-    void init_pipes(json pipes);
-    void init_pipeparts(json parts);
-    void init_breakable_platforms(json breakables);
-    void init_chains(json chains);
-    void init_pendulums(json pendulums);
-    void init_gears(json gears);
-    void init_spikeballs(json spikeballs);
-    void init_spawners(json spawners);
-    void init_rolling_things(json rolling_things);
-
-    void init_clock_holes(json clock_holes);
-
-    bool extract_full_platform_dimensions(json platform, vec2& dimensions);
-    bool extract_platform_attributes(json platform, vec2& dimensions, vec2& startPos, bool& rounded);
-    bool extract_path_attributes(json platform, vector<Path>& paths, vec2& startPos, vec2& dimensions, bool& rounded);
-    bool extract_boundary_attributes(json boundary, vec2& dimensions, vec2& position);
-    bool extract_door_position(json door, vec2& position);
-
-    vec2 convert_and_centralize_position(json pos, int conversion_factor);
-    vec2 centralize_position(vec2 pos, int conversion_factor, bool is_x_axis);
-    bool validate_custom_field(json attribute, string attribute_name, string entity, vector<string> sub_attributes = {});
-    void print_parsing_error(string& error, string entity);
+    void init_level_entities();
+    void stream_level_chunks(uint32_t budget);
+    void instantiate_section(LEVEL_SECTION_ID section);
+    RecordEntities instantiate_record(LEVEL_SECTION_ID section, uint32_t index);
+    void apply_level_edit(PreparedLevel& edited);
+    void init_projectiles();
+    void init_breakable_platforms();
 };
@@ -0,0 +1,287 @@
+#include "particle_kernel.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PARTICLE_KERNEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define PARTICLE_AVX2_TARGET
+#else
+#define PARTICLE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#else
+#define PARTICLE_KERNEL_X86 0
+#endif
+
+namespace {
+	// Scalar update of one particle; the AVX2 path below does exactly this for 8 at a time
+	inline void step_particle(ParticlePool& pool, int i, const ParticleStepParams& params, uint8_t* dead) {
+		const float dt = params.time_change_s;
+
+		pool.timer[i] += dt * 1000.0f;
+		const float dx = pool.position_x[i] - params.camera_position.x;
+		const float dy = pool.position_y[i] - params.camera_position.y;
+		const float distance_sq = params.cull_by_camera ? dx * dx + dy * dy : 0.0f;
+		dead[i] = pool.timer[i] > pool.life[i] || distance_sq > pool.cull_distance_sq[i];
+
+		// Update motion
+		pool.position_x[i] += dt * pool.velocity_x[i];
+		pool.position_y[i] += dt * pool.velocity_y[i];
+		const float angle = pool.angle[i] + dt * pool.angular_velocity[i];
+		pool.angle[i] = angle - 360.0f * floorf(angle * (1.0f / 360.0f));
+
+		if (abs(pool.wind_influence[i]) > 1e-4f) {
+			pool.position_x[i] += dt * params.wind_field.x * pool.wind_influence[i];
+			pool.position_y[i] += dt * params.wind_field.y * pool.wind_influence[i];
+		}
+
+		if (abs(pool.gravity_influence[i]) > 1e-4f) {
+			pool.velocity_x[i] += dt * params.gravity_field.x * pool.gravity_influence[i];
+			pool.velocity_y[i] += dt * params.gravity_field.y * pool.gravity_influence[i];
+		}
+
+		if (params.field != nullptr && abs(pool.turbulence_influence[i]) > 1e-4f) {
+			const vec2 direction = params.field->sample(
+				pool.position_x[i] * params.field_cells_per_pixel, pool.position_y[i] * params.field_cells_per_pixel);
+			pool.velocity_x[i] += dt * params.turbulence_strength * direction.x;
+			pool.velocity_y[i] += dt * params.turbulence_strength * direction.y;
+		}
+
+		pool.velocity_x[i] *= pool.velocity_decay[i];
+		pool.velocity_y[i] *= pool.velocity_decay[i];
+
+		const float animation_timer = pool.animation_timer[i] + params.animation_elapsed_ms;
+		if (animation_timer <= pool.animation_limit[i]) {
+			pool.animation_timer[i] = animation_timer;
+		}
+	}
+
+#if PARTICLE_KERNEL_X86
+	bool cpu_supports_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 1);
+		const bool os_saves_ymm = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+		const bool fma = (info[2] & (1 << 12)) != 0;
+		if (!os_saves_ymm || !avx || !fma || (_xgetbv(0) & 6) != 6) {
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+	}
+
+	PARTICLE_AVX2_TARGET
+	inline __m256 lerp8(__m256 a, __m256 b, __m256 t) {
+		return _mm256_fmadd_ps(_mm256_sub_ps(b, a), t, a);
+	}
+
+	// Updates whole blocks of 8 from begin and returns where the scalar tail should start
+	PARTICLE_AVX2_TARGET
+	int step_particles_avx2(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead, int begin, int end) {
+		const int block_end = begin + (end - begin) / 8 * 8;
+
+		float* position_x = pool.position_x.data();
+		float* position_y = pool.position_y.data();
+		float* velocity_x = pool.velocity_x.data();
+		float* velocity_y = pool.velocity_y.data();
+		float* angle = pool.angle.data();
+		float* timer = pool.timer.data();
+		float* animation_timer = pool.animation_timer.data();
+		const float* angular_velocity = pool.angular_velocity.data();
+		const float* life = pool.life.data();
+		const float* cull_distance_sq = pool.cull_distance_sq.data();
+		const float* wind_influence = pool.wind_influence.data();
+		const float* gravity_influence = pool.gravity_influence.data();
+		const float* turbulence_influence = pool.turbulence_influence.data();
+		const float* velocity_decay = pool.velocity_decay.data();
+		const float* animation_limit = pool.animation_limit.data();
+
+		const float dt_s = params.time_change_s;
+		const __m256 dt = _mm256_set1_ps(dt_s);
+		const __m256 dt_ms = _mm256_set1_ps(dt_s * 1000.0f);
+		const __m256 animation_dt = _mm256_set1_ps(params.animation_elapsed_ms);
+
+		const __m256 camera_x = _mm256_set1_ps(params.camera_position.x);
+		const __m256 camera_y = _mm256_set1_ps(params.camera_position.y);
+		const __m256 camera_mask = params.cull_by_camera ?
+			_mm256_castsi256_ps(_mm256_set1_epi32(-1)) : _mm256_setzero_ps();
+
+		const __m256 wind_x = _mm256_set1_ps(dt_s * params.wind_field.x);
+		const __m256 wind_y = _mm256_set1_ps(dt_s * params.wind_field.y);
+		const __m256 gravity_x = _mm256_set1_ps(dt_s * params.gravity_field.x);
+		const __m256 gravity_y = _mm256_set1_ps(dt_s * params.gravity_field.y);
+		const __m256 turbulence_gain = _mm256_set1_ps(dt_s * params.turbulence_strength);
+		const __m256 cells_per_pixel = _mm256_set1_ps(params.field_cells_per_pixel);
+
+		const __m256 threshold = _mm256_set1_ps(1e-4f);
+		const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+		const __m256 full_turn = _mm256_set1_ps(360.0f);
+		const __m256 inverse_turn = _mm256_set1_ps(1.0f / 360.0f);
+
+		const __m256i cell_mask = _mm256_set1_epi32(TURBULENCE_FIELD_RESOLUTION - 1);
+		const __m256i resolution = _mm256_set1_epi32(TURBULENCE_FIELD_RESOLUTION);
+		const __m256i one_cell = _mm256_set1_epi32(1);
+
+		for (int i = begin; i < block_end; i += 8) {
+			const __m256 timer_8 = _mm256_add_ps(_mm256_loadu_ps(timer + i), dt_ms);
+			_mm256_storeu_ps(timer + i, timer_8);
+
+			__m256 px = _mm256_loadu_ps(position_x + i);
+			__m256 py = _mm256_loadu_ps(position_y + i);
+			const __m256 dx = _mm256_sub_ps(px, camera_x);
+			const __m256 dy = _mm256_sub_ps(py, camera_y);
+			const __m256 distance_sq = _mm256_and_ps(_mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy)), camera_mask);
+			const __m256 died = _mm256_or_ps(
+				_mm256_cmp_ps(timer_8, _mm256_loadu_ps(life + i), _CMP_GT_OQ),
+				_mm256_cmp_ps(distance_sq, _mm256_loadu_ps(cull_distance_sq + i), _CMP_GT_OQ));
+			const int died_bits = _mm256_movemask_ps(died);
+			for (int k = 0; k < 8; k++) {
+				dead[i + k] = (died_bits >> k) & 1;
+			}
+
+			// Update motion
+			__m256 vx = _mm256_loadu_ps(velocity_x + i);
+			__m256 vy = _mm256_loadu_ps(velocity_y + i);
+			px = _mm256_fmadd_ps(dt, vx, px);
+			py = _mm256_fmadd_ps(dt, vy, py);
+
+			__m256 angle_8 = _mm256_fmadd_ps(dt, _mm256_loadu_ps(angular_velocity + i), _mm256_loadu_ps(angle + i));
+			angle_8 = _mm256_fnmadd_ps(full_turn, _mm256_floor_ps(_mm256_mul_ps(angle_8, inverse_turn)), angle_8);
+			_mm256_storeu_ps(angle + i, angle_8);
+
+			const __m256 wind_8 = _mm256_loadu_ps(wind_influence + i);
+			const __m256 wind_on = _mm256_cmp_ps(_mm256_and_ps(wind_8, abs_mask), threshold, _CMP_GT_OQ);
+			px = _mm256_add_ps(px, _mm256_and_ps(wind_on, _mm256_mul_ps(wind_x, wind_8)));
+			py = _mm256_add_ps(py, _mm256_and_ps(wind_on, _mm256_mul_ps(wind_y, wind_8)));
+
+			const __m256 gravity_8 = _mm256_loadu_ps(gravity_influence + i);
+			const __m256 gravity_on = _mm256_cmp_ps(_mm256_and_ps(gravity_8, abs_mask), threshold, _CMP_GT_OQ);
+			vx = _mm256_add_ps(vx, _mm256_and_ps(gravity_on, _mm256_mul_ps(gravity_x, gravity_8)));
+			vy = _mm256_add_ps(vy, _mm256_and_ps(gravity_on, _mm256_mul_ps(gravity_y, gravity_8)));
+
+			if (params.field != nullptr) {
+				const __m256 turbulence_on = _mm256_cmp_ps(
+					_mm256_and_ps(_mm256_loadu_ps(turbulence_influence + i), abs_mask), threshold, _CMP_GT_OQ);
+
+				if (_mm256_movemask_ps(turbulence_on) != 0) {
+					const __m256 u = _mm256_mul_ps(px, cells_per_pixel);
+					const __m256 v = _mm256_mul_ps(py, cells_per_pixel);
+					const __m256 u_floor = _mm256_floor_ps(u);
+					const __m256 v_floor = _mm256_floor_ps(v);
+					const __m256 s = _mm256_sub_ps(u, u_floor);
+					const __m256 t = _mm256_sub_ps(v, v_floor);
+
+					// the resolution is a power of two, so masking wraps negative cells too
+					const __m256i x0 = _mm256_and_si256(_mm256_cvtps_epi32(u_floor), cell_mask);
+					const __m256i y0 = _mm256_and_si256(_mm256_cvtps_epi32(v_floor), cell_mask);
+					const __m256i x1 = _mm256_and_si256(_mm256_add_epi32(x0, one_cell), cell_mask);
+					const __m256i y1 = _mm256_and_si256(_mm256_add_epi32(y0, one_cell), cell_mask);
+					const __m256i row0 = _mm256_mullo_epi32(y0, resolution);
+					const __m256i row1 = _mm256_mullo_epi32(y1, resolution);
+					const __m256i i00 = _mm256_add_epi32(row0, x0);
+					const __m256i i10 = _mm256_add_epi32(row0, x1);
+					const __m256i i01 = _mm256_add_epi32(row1, x0);
+					const __m256i i11 = _mm256_add_epi32(row1, x1);
+
+					const float* field_x = params.field->direction_x();
+					const float* field_y = params.field->direction_y();
+					const __m256 direction_x = lerp8(
+						lerp8(_mm256_i32gather_ps(field_x, i00, 4), _mm256_i32gather_ps(field_x, i10, 4), s),
+						lerp8(_mm256_i32gather_ps(field_x, i01, 4), _mm256_i32gather_ps(field_x, i11, 4), s), t);
+					const __m256 direction_y = lerp8(
+						lerp8(_mm256_i32gather_ps(field_y, i00, 4), _mm256_i32gather_ps(field_y, i10, 4), s),
+						lerp8(_mm256_i32gather_ps(field_y, i01, 4), _mm256_i32gather_ps(field_y, i11, 4), s), t);
+
+					vx = _mm256_add_ps(vx, _mm256_and_ps(turbulence_on, _mm256_mul_ps(turbulence_gain, direction_x)));
+					vy = _mm256_add_ps(vy, _mm256_and_ps(turbulence_on, _mm256_mul_ps(turbulence_gain, direction_y)));
+				}
+			}
+
+			const __m256 decay = _mm256_loadu_ps(velocity_decay + i);
+			vx = _mm256_mul_ps(vx, decay);
+			vy = _mm256_mul_ps(vy, decay);
+
+			const __m256 animation_8 = _mm256_loadu_ps(animation_timer + i);
+			const __m256 animation_next = _mm256_add_ps(animation_8, animation_dt);
+			const __m256 animation_on = _mm256_cmp_ps(animation_next, _mm256_loadu_ps(animation_limit + i), _CMP_LE_OQ);
+			_mm256_storeu_ps(animation_timer + i, _mm256_blendv_ps(animation_8, animation_next, animation_on));
+
+			_mm256_storeu_ps(position_x + i, px);
+			_mm256_storeu_ps(position_y + i, py);
+			_mm256_storeu_ps(velocity_x + i, vx);
+			_mm256_storeu_ps(velocity_y + i, vy);
+		}
+
+		return block_end;
+	}
+
+	const bool avx2_available = cpu_supports_avx2();
+#endif
+}
+
+void step_particles(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead) {
+	step_particles_range(pool, params, dead, 0, pool.size());
+}
+
+void step_particles_range(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead, int begin, int end) {
+	int first = begin;
+#if PARTICLE_KERNEL_X86
+	if (avx2_available) {
+		first = step_particles_avx2(pool, params, dead, begin, end);
+	}
+#endif
+	for (int i = first; i < end; i++) {
+		step_particle(pool, i, params, dead);
+	}
+}
+
+void step_particles_scalar(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead) {
+	for (int i = 0; i < pool.size(); i++) {
+		step_particle(pool, i, params, dead);
+	}
+}
+
+void step_particles_parallel(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead,
+	WorkerPool& workers, std::vector<std::vector<int>>& chunk_deaths) {
+	const int count = pool.size();
+	const int chunk_count = (count + PARTICLE_UPDATE_CHUNK - 1) / PARTICLE_UPDATE_CHUNK;
+	if ((int)chunk_deaths.size() < chunk_count) {
+		chunk_deaths.resize(chunk_count);
+	}
+
+	workers.run(chunk_count, [&](int chunk) {
+		const int begin = chunk * PARTICLE_UPDATE_CHUNK;
+		const int end = min(begin + PARTICLE_UPDATE_CHUNK, count);
+		step_particles_range(pool, params, dead, begin, end);
+
+		std::vector<int>& deaths = chunk_deaths[chunk];
+		deaths.clear();
+		for (int i = begin; i < end; i++) {
+			if (dead[i]) {
+				deaths.push_back(i);
+			}
+		}
+	});
+
+	// Highest slot first, so a removal only moves in a particle that is known to be alive
+	for (int chunk = chunk_count - 1; chunk >= 0; chunk--) {
+		const std::vector<int>& deaths = chunk_deaths[chunk];
+		for (auto death = deaths.rbegin(); death != deaths.rend(); ++death) {
+			pool.remove(*death);
+		}
+	}
+}
+
+const char* particle_kernel_name() {
+#if PARTICLE_KERNEL_X86
+	if (avx2_available) {
+		return "AVX2";
+	}
+#endif
+	return "scalar";
+}
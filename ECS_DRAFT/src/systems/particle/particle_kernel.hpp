@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../../common.hpp"
+#include "../../worker_pool.hpp"
+#include "particle_pool.hpp"
+#include "turbulence_field.hpp"
+
+// Everything the update kernel reads besides the pool, resolved once per frame
+struct ParticleStepParams {
+	float time_change_s = 0.0f;
+	float animation_elapsed_ms = 0.0f;	// animation clips run on real time
+
+	bool cull_by_camera = false;
+	vec2 camera_position = { 0.0f, 0.0f };
+
+	vec2 wind_field = { 0.0f, 0.0f };
+	vec2 gravity_field = { 0.0f, 0.0f };
+
+	// Turbulence is skipped entirely when field is null
+	const TurbulenceField* field = nullptr;
+	float turbulence_strength = 0.0f;
+	float field_cells_per_pixel = 1.0f;
+};
+
+// Integrates every particle in the pool and flags the ones that died this frame in dead
+// (one byte per slot); removal is left to the caller so slots stay put during the update
+void step_particles(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead);
+
+// Same, restricted to slots [begin, end); disjoint ranges can be stepped concurrently
+void step_particles_range(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead, int begin, int end);
+
+// Steps the pool in PARTICLE_UPDATE_CHUNK jobs on the workers, each gathering its deaths into its
+// own queue, then removes every dead particle in one pass. Chunks depend only on the pool size,
+// so the result is the same for any number of threads.
+void step_particles_parallel(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead,
+	WorkerPool& workers, std::vector<std::vector<int>>& chunk_deaths);
+
+// Same as step_particles but forces the portable path, for comparison
+void step_particles_scalar(ParticlePool& pool, const ParticleStepParams& params, uint8_t* dead);
+
+// "AVX2" or "scalar", whichever step_particles dispatches to on this machine
+const char* particle_kernel_name();
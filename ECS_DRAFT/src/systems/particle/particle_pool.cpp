@@ -0,0 +1,133 @@
+#include "particle_pool.hpp"
+
+namespace {
+	const unsigned int HANDLE_INDEX_MASK = (1u << PARTICLE_HANDLE_INDEX_BITS) - 1;
+}
+
+void ParticlePool::reserve(int capacity)
+{
+	assert(capacity < (int)HANDLE_INDEX_MASK);
+
+	max_count = capacity;
+	type.resize(capacity);
+	effect.resize(capacity);
+	for (std::vector<float>* field : {
+		&position_x, &position_y, &velocity_x, &velocity_y, &angle, &angular_velocity,
+		&scale_x, &scale_y, &life, &timer, &alpha, &fade_in, &fade_out, &shrink_in, &shrink_out,
+		&wind_influence, &gravity_influence, &turbulence_influence, &animation_timer,
+		&velocity_decay, &cull_distance_sq, &animation_limit }) {
+		field->resize(capacity);
+	}
+	color.resize(capacity);
+
+	slot_handles.resize(capacity);
+	handle_slots.assign(capacity, -1);
+	handle_generations.assign(capacity, 0);
+	clear();
+}
+
+int ParticlePool::add()
+{
+	if (count >= max_count) {
+		return -1;
+	}
+
+	const int slot = count++;
+	const unsigned int index = free_handles.back();
+	free_handles.pop_back();
+
+	handle_slots[index] = slot;
+	slot_handles[slot] = (handle_generations[index] << PARTICLE_HANDLE_INDEX_BITS) | (index + 1);
+
+	type[slot] = PARTICLE_ID::COLORED;
+	effect[slot] = PARTICLE_EFFECT_ID::AMBIENT;
+	position_x[slot] = position_y[slot] = 0.f;
+	velocity_x[slot] = velocity_y[slot] = 0.f;
+	angle[slot] = angular_velocity[slot] = 0.f;
+	scale_x[slot] = scale_y[slot] = 0.f;
+	life[slot] = timer[slot] = 0.f;
+	alpha[slot] = 1.f;
+	fade_in[slot] = fade_out[slot] = 0.f;
+	shrink_in[slot] = shrink_out[slot] = 0.f;
+	wind_influence[slot] = gravity_influence[slot] = turbulence_influence[slot] = 0.f;
+	animation_timer[slot] = 0.f;
+	color[slot] = vec3(0.f);
+	velocity_decay[slot] = 1.f;
+	cull_distance_sq[slot] = MAX_CAMERA_DISTANCE * MAX_CAMERA_DISTANCE;
+	animation_limit[slot] = -1.f;
+
+	return slot;
+}
+
+void ParticlePool::remove(int slot)
+{
+	assert(slot >= 0 && slot < count);
+
+	const unsigned int index = (slot_handles[slot] & HANDLE_INDEX_MASK) - 1;
+	handle_slots[index] = -1;
+	handle_generations[index] = (handle_generations[index] + 1) & (~0u >> PARTICLE_HANDLE_INDEX_BITS);
+	free_handles.push_back(index);
+
+	const int last = --count;
+	if (slot != last) {
+		move(last, slot);
+	}
+}
+
+void ParticlePool::clear()
+{
+	for (int slot = 0; slot < count; slot++) {
+		const unsigned int index = (slot_handles[slot] & HANDLE_INDEX_MASK) - 1;
+		handle_slots[index] = -1;
+		handle_generations[index] = (handle_generations[index] + 1) & (~0u >> PARTICLE_HANDLE_INDEX_BITS);
+	}
+	count = 0;
+
+	// hand out low indices first
+	free_handles.resize(max_count);
+	for (int i = 0; i < max_count; i++) {
+		free_handles[i] = max_count - 1 - i;
+	}
+}
+
+int ParticlePool::slot(unsigned int handle) const
+{
+	const unsigned int index = (handle & HANDLE_INDEX_MASK) - 1;
+	if (handle == 0 || index >= (unsigned int)max_count ||
+		handle_generations[index] != (handle >> PARTICLE_HANDLE_INDEX_BITS)) {
+		return -1;
+	}
+	return handle_slots[index];
+}
+
+void ParticlePool::move(int from, int to)
+{
+	type[to] = type[from];
+	effect[to] = effect[from];
+	position_x[to] = position_x[from];
+	position_y[to] = position_y[from];
+	velocity_x[to] = velocity_x[from];
+	velocity_y[to] = velocity_y[from];
+	angle[to] = angle[from];
+	angular_velocity[to] = angular_velocity[from];
+	scale_x[to] = scale_x[from];
+	scale_y[to] = scale_y[from];
+	life[to] = life[from];
+	timer[to] = timer[from];
+	alpha[to] = alpha[from];
+	fade_in[to] = fade_in[from];
+	fade_out[to] = fade_out[from];
+	shrink_in[to] = shrink_in[from];
+	shrink_out[to] = shrink_out[from];
+	wind_influence[to] = wind_influence[from];
+	gravity_influence[to] = gravity_influence[from];
+	turbulence_influence[to] = turbulence_influence[from];
+	animation_timer[to] = animation_timer[from];
+	color[to] = color[from];
+	velocity_decay[to] = velocity_decay[from];
+	cull_distance_sq[to] = cull_distance_sq[from];
+	animation_limit[to] = animation_limit[from];
+
+	slot_handles[to] = slot_handles[from];
+	handle_slots[(slot_handles[to] & HANDLE_INDEX_MASK) - 1] = to;
+}
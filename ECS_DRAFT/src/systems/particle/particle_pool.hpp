@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include "../../common.hpp"
+#include "../../tinyECS/components.hpp"
+
+// Preallocated structure-of-arrays storage for every live particle. Live particles are packed
+// into slots [0, size()); removing one moves the last particle into its slot. Slots therefore
+// change over time, handles do not: a handle stays valid until its particle is removed.
+class ParticlePool {
+public:
+	void reserve(int capacity);
+
+	int size() const { return count; }
+	int capacity() const { return max_count; }
+
+	// Returns the slot of a new particle with zeroed fields, or -1 when the pool is full
+	int add();
+	void remove(int slot);
+	void clear();
+
+	unsigned int handle(int slot) const { return slot_handles[slot]; }
+	// Slot currently holding the particle, or -1 if it has been removed
+	int slot(unsigned int handle) const;
+
+	// Motion properties are isolated from Physics system to avoid sub-stepping particles
+	std::vector<PARTICLE_ID> type;
+	std::vector<PARTICLE_EFFECT_ID> effect;
+	std::vector<float> position_x, position_y;
+	std::vector<float> velocity_x, velocity_y;
+	std::vector<float> angle, angular_velocity;
+	std::vector<float> scale_x, scale_y;
+	std::vector<float> life, timer, alpha;
+	std::vector<float> fade_in, fade_out;
+	std::vector<float> shrink_in, shrink_out;
+	// Wind -> constant addition to velocity
+	// Gravity -> contant acceleration
+	// Turbulence -> randomized acceleration
+	std::vector<float> wind_influence, gravity_influence, turbulence_influence;
+	std::vector<float> animation_timer;
+	std::vector<vec3> color;
+
+	// Per-type behaviour copied in at spawn so the update kernel needs no type lookups
+	std::vector<float> velocity_decay;
+	std::vector<float> cull_distance_sq;	// squared camera distance beyond which the particle dies
+	std::vector<float> animation_limit;		// animation_timer only advances while it stays below this
+
+private:
+	void move(int from, int to);
+
+	int count = 0;
+	int max_count = 0;
+
+	// Handle = generation in the high bits, handle index + 1 in the low PARTICLE_HANDLE_INDEX_BITS
+	std::vector<unsigned int> slot_handles;
+	std::vector<int> handle_slots;
+	std::vector<unsigned int> handle_generations;
+	std::vector<unsigned int> free_handles;
+};
@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include "particle_system.hpp"
+#include "systems/animation/animation_system.hpp"
+#include "../../mapped_file.hpp"
 
 void ParticleSystem::init(GLFWwindow* window) {
 	this->window = window;
@@ -9,6 +13,98 @@ void ParticleSystem::init(GLFWwindow* window) {
 	//state.wind_field = {350.0, -50.0};
 	state.turbulence_strength = 150.0f;
 	state.turbulence_scale = TURBULENCE_GRID_SIZE;
+
+	pool.reserve(PARTICLE_COUNT_LIMIT);
+	gpu_staging.reserve(1);
+	dead_particles.resize(PARTICLE_COUNT_LIMIT);
+	gpu_slots.resize(GPU_PARTICLE_CAPACITY);
+	reset_gpu_slots();
+	workers.start(clamp((int)std::thread::hardware_concurrency(), 1, PARTICLE_WORKER_LIMIT));
+	turbulence_field.generate(turbulence_time());
+
+	// Emitter descriptors
+	auto fragments = [](ANIMATION_ID animation) {
+		ParticleTypeDescriptor type;
+		type.animation = animation;
+		type.overrides_gravity = true;
+		type.gravity_influence = 0.5f;
+		type.randomizes_angle = true;
+		type.angle_range = { -15.0f, 15.0f };
+		type.angular_velocity_range = { -50.0f, 50.0f };
+		return type;
+	};
+	particle_types.fill(ParticleTypeDescriptor());
+
+	particle_types[(int)PARTICLE_ID::BREAKABLE_FRAGMENTS] = fragments(ANIMATION_ID::BREAKABLE_FRAGMENTS);
+	particle_types[(int)PARTICLE_ID::SCREW_FRAGMENTS] = fragments(ANIMATION_ID::SCREW_FRAGMENTS);
+	particle_types[(int)PARTICLE_ID::HEX_FRAGMENTS] = fragments(ANIMATION_ID::HEX_FRAGMENTS);
+
+	ParticleTypeDescriptor& coyote = particle_types[(int)PARTICLE_ID::COYOTE_PARTICLES];
+	coyote.animation = ANIMATION_ID::COYOTE_PARTICLES;
+	coyote.velocity_decay = 0.9f;
+
+	ParticleTypeDescriptor& cracking_radial = particle_types[(int)PARTICLE_ID::CRACKING_RADIAL];
+	cracking_radial.animation = ANIMATION_ID::CRACKING_RADIAL;
+	cracking_radial.expires = false;
+	cracking_radial.randomizes_angle = true;
+	cracking_radial.angle_range = { 0.0f, 360.0f };
+	cracking_radial.angle_snap = 90.0f;
+
+	particle_types[(int)PARTICLE_ID::CRACKING_DOWNWARD].animation = ANIMATION_ID::CRACKING_DOWNWARD;
+
+	ParticleTypeDescriptor& exhale = particle_types[(int)PARTICLE_ID::EXHALE];
+	exhale.animation = ANIMATION_ID::EXHALE;
+	exhale.overrides_gravity = true;
+	exhale.gravity_influence = -0.05f;
+	exhale.randomizes_angle = true;
+	exhale.angle_range = { 0.0f, 360.0f };
+	exhale.angular_velocity_range = { 10.0f, 20.0f };
+	exhale.spins_with_velocity = true;
+
+	ParticleTypeDescriptor& broken_parts = particle_types[(int)PARTICLE_ID::BROKEN_PARTS];
+	broken_parts.animation = ANIMATION_ID::BROKEN_PARTS;
+	broken_parts.overrides_gravity = true;
+	broken_parts.gravity_influence = 0.3f;
+	broken_parts.randomizes_angle = true;
+	broken_parts.angle_range = { 0.0f, 360.0f };
+	broken_parts.angular_velocity_range = { -20.0f, 20.0f };
+
+	ParticleTypeDescriptor& cross_star = particle_types[(int)PARTICLE_ID::CROSS_STAR];
+	cross_star.randomizes_angle = true;
+	cross_star.angle_range = { 0.0f, 360.0f };
+	cross_star.angular_velocity_range = { -180.0f, 180.0f };
+
+	// Effect priorities; thinnable effects are cosmetic and give way first
+	particle_effects[(int)PARTICLE_EFFECT_ID::AMBIENT] = { "ambient", 0, true };
+	particle_effects[(int)PARTICLE_EFFECT_ID::PLAYER_TRAIL] = { "player trail", 1, true };
+	particle_effects[(int)PARTICLE_EFFECT_ID::DECELERATION] = { "deceleration", 1, true };
+	particle_effects[(int)PARTICLE_EFFECT_ID::BOSS_AURA] = { "boss aura", 1, true };
+	particle_effects[(int)PARTICLE_EFFECT_ID::SPAWNPOINT] = { "spawnpoint", 2, true };
+	particle_effects[(int)PARTICLE_EFFECT_ID::IMPACT] = { "impact", 2, true };
+	particle_effects[(int)PARTICLE_EFFECT_ID::CANNON_FIRE] = { "cannon fire", 2, true };
+	particle_effects[(int)PARTICLE_EFFECT_ID::PLAYER_FEEDBACK] = { "player feedback", 3, false };
+	particle_effects[(int)PARTICLE_EFFECT_ID::HAZARD_WARNING] = { "hazard warning", 4, false };
+	particle_effects[(int)PARTICLE_EFFECT_ID::BOSS_TELEGRAPH] = { "boss telegraph", 4, false };
+	particle_effects[(int)PARTICLE_EFFECT_ID::BOSS_DAMAGE] = { "boss damage", 4, false };
+	particle_effects[(int)PARTICLE_EFFECT_ID::CRACKS] = { "cracks", 5, false };
+
+	int priority_levels = 0;
+	for (const ParticleEffectDescriptor& effect : particle_effects) {
+		priority_levels = max(priority_levels, effect.priority + 1);
+	}
+	pool_victims.assign(priority_levels, {});
+	gpu_victims.assign(priority_levels, {});
+
+	for (ParticleTypeDescriptor& type : particle_types) {
+		if (type.animation == ANIMATION_ID::ANIMATION_COUNT) {
+			continue;
+		}
+		const AnimationConfig& config = AnimationSystem::animation_config(type.animation);
+		type.animation_type = config.animation_type;
+		type.frame_count = config.frame_count;
+		type.duration_ms = config.duration_ms;
+		type.ms_per_frame = config.ms_per_frame;
+	}
 }
 
 void ParticleSystem::step(float elapsed_ms) {
@@ -20,65 +116,191 @@ void ParticleSystem::step(float elapsed_ms) {
 
 	const ParticleSystemState& system_state = registry.particleSystemStates.components[0];
 
+	turbulence_field.regenerate_slice(turbulence_time());
 
-	// Get current system time: https://www.geeksforgeeks.org/how-to-get-time-in-milliseconds-in-cpp/
-	auto time_passage = std::chrono::system_clock::now().time_since_epoch();
-	float system_time = (float)std::chrono::duration_cast<std::chrono::milliseconds>(time_passage).count() * TURBULENCE_EVOLUTION_SPEED;
+	ParticleStepParams params;
+	params.time_change_s = time_factor * elapsed_ms * 0.001f;
+	params.animation_elapsed_ms = elapsed_ms;
+	params.wind_field = system_state.wind_field;
+	params.gravity_field = system_state.gravity_field;
 
-	for (int i = registry.particles.size() - 1; i >= 0; i--) {
-		const Entity entity = registry.particles.entities[i];
-		Particle &particle = registry.particles.components[i];
+	// Eliminate if out of camera range
+	params.cull_by_camera = registry.cameras.size() > 0 && registry.motions.has(registry.cameras.entities[0]);
+	if (params.cull_by_camera) {
+		params.camera_position = registry.motions.get(registry.cameras.entities[0]).position;
+	}
 
-		const float time_change_s = time_factor * elapsed_ms * 0.001f;
+	if (system_state.turbulence_strength > 1e-4 && system_state.turbulence_scale > 1e-2) {
+		params.field = &turbulence_field;
+		params.turbulence_strength = system_state.turbulence_strength;
+		params.field_cells_per_pixel = TURBULENCE_FIELD_CELLS_PER_NOISE / system_state.turbulence_scale;
+	}
 
-		if (particle.particle_id != PARTICLE_ID::CRACKING_RADIAL) {
-			// Eliminate if out of camera range
-			vec2 camera_pos = registry.motions.get(registry.cameras.entities[0]).position;
-			if (glm::length(particle.position - camera_pos) > MAX_CAMERA_DISTANCE) {
-				registry.remove_all_components_of(entity);
-			}
+	if (gpu_simulation) {
+		gpu_step_params = params;
+		gpu_step_pending = true;
 
-			particle.timer += time_change_s * 1000.0f;
+		// the GPU kills a particle on the step its timer passes its life
+		gpu_clock_ms += params.time_change_s * 1000.0;
+		while (!gpu_expiries.empty() && gpu_expiries.front().first < gpu_clock_ms) {
+			const unsigned int handle = gpu_expiries.front().second;
+			std::pop_heap(gpu_expiries.begin(), gpu_expiries.end(), std::greater<>());
+			gpu_expiries.pop_back();
 
-			// Eliminate if dead
-			if (particle.timer > particle.life) {
-				registry.remove_all_components_of(entity);
+			const int ring_slot = gpu_slot(handle);
+			if (ring_slot >= 0) {
+				retire_gpu_slot(ring_slot);
 			}
 		}
+	}
 
-		// Update motion
-		particle.position += (time_change_s * particle.velocity);
-		particle.angle += (time_change_s * particle.ang_velocity);
-		particle.angle = fmod(fmod(particle.angle, 360.0f) + 360.0f, 360.0f);
+	auto update_start = std::chrono::high_resolution_clock::now();
+	step_particles_parallel(pool, params, dead_particles.data(), workers, chunk_deaths);
+	auto update_end = std::chrono::high_resolution_clock::now();
+
+	// Telemetry
+	for (ParticleEffectStats& effect_stats : stats) {
+		effect_stats.live = 0;
+	}
+	for (int i = 0; i < pool.size(); i++) {
+		stats[(int)pool.effect[i]].live++;
+	}
+	// The kernel steps the pool as a whole, so the per effect share is only an estimate
+	const double update_ms = std::chrono::duration<double, std::milli>(update_end - update_start).count();
+	for (ParticleEffectStats& effect_stats : stats) {
+		effect_stats.update_ms += pool.size() > 0 ? update_ms * effect_stats.live / pool.size() : 0.0;
+	}
+	stepped_frames++;
 
-		if (abs(particle.wind_influence) > 1e-4) {
-			particle.position += (time_change_s * system_state.wind_field * particle.wind_influence);
+	std::vector<int> pool_live(pool_victims.size(), 0);
+	std::vector<int> gpu_live(gpu_victims.size(), 0);
+	for (int i = 0; i < particle_effect_count; i++) {
+		pool_live[particle_effects[i].priority] += stats[i].live;
+		gpu_live[particle_effects[i].priority] += stats[i].gpu_live;
+	}
+	for (size_t priority = 0; priority < pool_victims.size(); priority++) {
+		trim_victims(pool_victims[priority], pool_live[priority], false);
+		trim_victims(gpu_victims[priority], gpu_live[priority], true);
+	}
+
+	telemetry_timer_ms += elapsed_ms;
+	if (telemetry_enabled && telemetry_timer_ms >= PARTICLE_TELEMETRY_INTERVAL_MS) {
+		telemetry_timer_ms = 0.0f;
+		print_telemetry();
+	}
+}
+
+void ParticleSystem::print_telemetry() {
+	printf("Particles: %d live in the CPU pool (capacity %d), %d on the GPU (capacity %d), %d frames\n",
+		pool.size(), pool.capacity(), gpu_live_count, GPU_PARTICLE_CAPACITY, stepped_frames);
+	printf("  %-16s %4s %7s %7s %9s %8s %8s %8s %14s\n", "effect", "prio", "live", "gpu", "spawned", "thinned", "dropped", "evicted", "~cpu ms/frame");
+	for (int i = 0; i < particle_effect_count; i++) {
+		const ParticleEffectStats& effect_stats = stats[i];
+		printf("  %-16s %4d %7d %7d %9d %8d %8d %8d %14.4f\n", particle_effects[i].name, particle_effects[i].priority,
+			effect_stats.live, effect_stats.gpu_live, effect_stats.spawned, effect_stats.thinned, effect_stats.dropped, effect_stats.evicted,
+			stepped_frames > 0 ? effect_stats.update_ms / stepped_frames : 0.0);
+	}
+	printf("  ~cpu ms/frame splits the measured CPU update by live count; GPU time is not measured\n");
+}
+
+bool ParticleSystem::admit_spawn(vec2 pos, bool on_gpu) {
+	const ParticleEffectDescriptor& effect = particle_effects[(int)current_effect];
+	ParticleEffectStats& effect_stats = stats[(int)current_effect];
+
+	if (effect.thinnable) {
+		float rate = 1.0f;
+
+		// Distance LOD
+		if (registry.cameras.size() > 0 && registry.motions.has(registry.cameras.entities[0])) {
+			const float distance = glm::length(pos - registry.motions.get(registry.cameras.entities[0]).position);
+			const float t = clamp((distance - PARTICLE_LOD_NEAR_DISTANCE) / (MAX_CAMERA_DISTANCE - PARTICLE_LOD_NEAR_DISTANCE), 0.0f, 1.0f);
+			rate = mix(1.0f, PARTICLE_LOD_FAR_RATE, t);
 		}
 
-		if (abs(particle.gravity_influence) > 1e-4) {
-			particle.velocity += (time_change_s * system_state.gravity_field * particle.gravity_influence);
+		// Back off as the pool fills up
+		const float fill = on_gpu ? (float)gpu_live_count / (float)GPU_PARTICLE_CAPACITY :
+			(float)pool.size() / (float)pool.capacity();
+		if (fill > PARTICLE_LOD_PRESSURE_START) {
+			rate *= max(0.0f, 1.0f - (fill - PARTICLE_LOD_PRESSURE_START) / (1.0f - PARTICLE_LOD_PRESSURE_START));
 		}
 
-		if (abs(particle.turbulence_influence) > 1e-4 && system_state.turbulence_strength > 1e-4 && system_state.turbulence_scale > 1e-2) {
-			particle.velocity += 
-				(time_change_s * system_state.turbulence_strength * angle_to_direction(
-					M_PI * 2.0f * sample_from_turbulence(vec3(particle.position / system_state.turbulence_scale, system_time))));
+		// Error diffusion instead of rand(), so thinning does not shift gameplay randomness
+		float& accumulator = lod_accumulators[(int)current_effect];
+		accumulator += rate;
+		if (accumulator < 1.0f) {
+			effect_stats.thinned++;
+			return false;
 		}
+		accumulator -= 1.0f;
+	}
+
+	const bool full = on_gpu ? gpu_live_count >= GPU_PARTICLE_CAPACITY : pool.size() >= pool.capacity();
+	if (full && !evict_below(effect.priority, on_gpu)) {
+		effect_stats.dropped++;
+		return false;
+	}
+	return true;
+}
 
-		// Handle different particles
-		switch (particle.particle_id)
-		{
-			case PARTICLE_ID::COYOTE_PARTICLES:
-				// Velocity decay
-				particle.velocity *= 0.9f;
-				break;
-			default:
-				break;
+bool ParticleSystem::evict_below(int priority, bool on_gpu) {
+	// Oldest first from the lowest priority that still has a live particle; owned ones are never queued
+	std::vector<std::deque<unsigned int>>& victims = on_gpu ? gpu_victims : pool_victims;
+	for (int victim_priority = 0; victim_priority < min(priority, (int)victims.size()); victim_priority++) {
+		std::deque<unsigned int>& queue = victims[victim_priority];
+		int evicted = 0;
+		while (!queue.empty() && evicted < PARTICLE_EVICTION_BATCH) {
+			const unsigned int handle = queue.front();
+			queue.pop_front();
+
+			if (on_gpu) {
+				// a handle can outlive its particle long enough for the slot's generation to wrap
+				const int ring_slot = gpu_slot(handle);
+				if (ring_slot < 0 || particle_effects[(int)gpu_slots[ring_slot].effect].priority != victim_priority) {
+					continue;
+				}
+				stats[(int)gpu_slots[ring_slot].effect].evicted++;
+				kill_gpu_slot(ring_slot);
+			}
+			else {
+				const int slot = pool.slot(handle);
+				if (slot < 0 || pool.life[slot] == INFINITY ||
+					particle_effects[(int)pool.effect[slot]].priority != victim_priority) {
+					continue;
+				}
+				stats[(int)pool.effect[slot]].evicted++;
+				pool.remove(slot);
+			}
+			evicted++;
 		}
+		if (evicted > 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ParticleSystem::trim_victims(std::deque<unsigned int>& victims, int live, bool on_gpu) {
+	auto dead = [on_gpu](unsigned int handle) {
+		return on_gpu ? gpu_slot(handle) < 0 : pool.slot(handle) < 0;
+	};
+
+	// the oldest die first, so most dead handles sit at the front
+	while (!victims.empty() && dead(victims.front())) {
+		victims.pop_front();
+	}
+	if ((int)victims.size() > 2 * live + PARTICLE_EVICTION_BATCH) {
+		victims.erase(std::remove_if(victims.begin(), victims.end(), dead), victims.end());
 	}
 }
 
+float ParticleSystem::turbulence_time() {
+	// Get current system time: https://www.geeksforgeeks.org/how-to-get-time-in-milliseconds-in-cpp/
+	auto time_passage = std::chrono::system_clock::now().time_since_epoch();
+	return (float)std::chrono::duration_cast<std::chrono::milliseconds>(time_passage).count() * TURBULENCE_EVOLUTION_SPEED;
+}
+
 void ParticleSystem::late_step(float elapsed_ms) {
+	(void)elapsed_ms;
 }
 
 // Spawn with arbitrary particle id
@@ -89,27 +311,29 @@ unsigned int ParticleSystem::spawn_particle(
 	float alpha, vec2 fade_in_out, vec2 shrink_in_out,
 	float wind_influence, float gravity_influence, float turbulence_influence) {
 
-	if (registry.particles.size() > PARTICLE_COUNT_LIMIT) {
-		return false;
+	if ((int)particle_id < 0 || particle_id >= PARTICLE_ID::PARTICLE_TYPE_COUNT) {
+		return 0;
 	}
 
 	if (fade_in_out[0] < 0 || fade_in_out[1] < 0 || (fade_in_out[0] + fade_in_out[1] > life) ||
 		shrink_in_out[0] < 0 || shrink_in_out[1] < 0 || (shrink_in_out[0] + shrink_in_out[1] > life)) {
-		return false;
+		return 0;
 	}
 
-	Entity entity = set_basic_particle(
-		particle_id,
+	ParticlePool& target = spawn_pool(particle_id, life);
+	int slot = set_basic_particle(
+		target, particle_id,
 		pos, angle, scale, velocity,
 		life,
 		alpha, fade_in_out, shrink_in_out,
 		wind_influence, gravity_influence, turbulence_influence);
-	
-	if (handle_particle_type(entity, particle_id)) {
-		return entity.id();
+
+	if (slot < 0) {
+		return 0;
 	}
 
-	return 0;
+	handle_particle_type(target, slot, particle_id);
+	return finish_spawn(target, slot);
 }
 
 // Spawn with color
@@ -120,205 +344,278 @@ unsigned int ParticleSystem::spawn_particle(
 	float alpha, vec2 fade_in_out, vec2 shrink_in_out,
 	float wind_influence, float gravity_influence, float turbulence_influence) {
 
-	if (registry.particles.size() > PARTICLE_COUNT_LIMIT) {
-		return false;
-	}
-
 	if (registry.cameras.size() <= 0 || !registry.motions.has(registry.cameras.entities[0])) {
-		return false;
+		return 0;
 	}
 
 	const vec2 cam_pos = registry.motions.get(registry.cameras.entities[0]).position;
 	if (glm::length(cam_pos - pos) > MAX_CAMERA_DISTANCE) {
-		return false;
+		return 0;
 	}
 
 	if (fade_in_out[0] < 0 || fade_in_out[1] < 0 || (fade_in_out[0] + fade_in_out[1] > life) ||
 		shrink_in_out[0] < 0 || shrink_in_out[1] < 0 || (shrink_in_out[0] + shrink_in_out[1] > life)) {
-		return false;
+		return 0;
 	}
 
-	Entity entity = set_basic_particle(
-		PARTICLE_ID::COLORED,
+	ParticlePool& target = spawn_pool(PARTICLE_ID::COLORED, life);
+	int slot = set_basic_particle(
+		target, PARTICLE_ID::COLORED,
 		pos, angle, scale, velocity,
 		life,
 		alpha, fade_in_out, shrink_in_out,
 		wind_influence, gravity_influence, turbulence_influence);
 
-	registry.colors.emplace(entity, color);
+	if (slot < 0) {
+		return 0;
+	}
+
+	target.color[slot] = color;
+	return finish_spawn(target, slot);
+}
 
-	return entity.id();
+ParticlePool& ParticleSystem::spawn_pool(PARTICLE_ID particle_id, float life) {
+	return gpu_simulation && particle_types[(int)particle_id].expires && life != INFINITY ? gpu_staging : pool;
 }
 
-Entity ParticleSystem::set_basic_particle(
-	PARTICLE_ID particle_id,
+int ParticleSystem::set_basic_particle(
+	ParticlePool& target, PARTICLE_ID particle_id,
 	vec2 pos, float angle, vec2 scale, vec2 velocity,
 	float life,
 	float alpha, vec2 fade_in_out, vec2 shrink_in_out,
 	float wind_influence, float gravity_influence, float turbulence_influence) {
 
-	Entity entity = Entity();
+	if (!admit_spawn(pos, &target == &gpu_staging)) {
+		return -1;
+	}
 
-	Particle& particle = registry.particles.emplace(entity);
-	particle.particle_id = particle_id;
-	particle.alpha = alpha;
-	particle.life = life;
-	particle.timer = 0;
-	particle.fade_in_out = fade_in_out;
-	particle.shrink_in_out = shrink_in_out;
-	particle.wind_influence = wind_influence;
-	particle.gravity_influence = gravity_influence;
-	particle.turbulence_influence = turbulence_influence;
-
-	particle.angle = angle;
-	particle.position = pos;
-	particle.scale = scale;
-	particle.velocity = velocity;
-
-	return entity;
-}
-
-bool ParticleSystem::handle_particle_type(Entity entity, PARTICLE_ID particle_id) {
-	bool success = true;
-
-	switch(particle_id) {
-		case PARTICLE_ID::COLORED:
-			registry.colors.emplace(entity, vec3(0.0));
-			break;
-		case PARTICLE_ID::SAMPLED_TEXTURE:
-			break;
-		case PARTICLE_ID::BREAKABLE_FRAGMENTS:
-		{
-			Particle& par = registry.particles.get(entity);
-			par.gravity_influence = 0.5f;
-			par.angle = rand_float(-15.f, 15.f);
-			par.ang_velocity = rand_float(-50.f, 50.f);
-
-			registry.animateRequests.emplace(entity).used_animation = ANIMATION_ID::BREAKABLE_FRAGMENTS;
-			break;
-		}
-		case PARTICLE_ID::SCREW_FRAGMENTS:
-		{
-			Particle& par = registry.particles.get(entity);
-			par.gravity_influence = 0.5f;
-			par.angle = rand_float(-15.f, 15.f);
-			par.ang_velocity = rand_float(-50.f, 50.f);
-
-			registry.animateRequests.emplace(entity).used_animation = ANIMATION_ID::SCREW_FRAGMENTS;
-			break;
-		}
-		case PARTICLE_ID::HEX_FRAGMENTS:
-		{
-			Particle& par = registry.particles.get(entity);
-			par.gravity_influence = 0.5f;
-			par.angle = rand_float(-15.f, 15.f);
-			par.ang_velocity = rand_float(-50.f, 50.f);
-
-			registry.animateRequests.emplace(entity).used_animation = ANIMATION_ID::HEX_FRAGMENTS;
-			break;
-		}
-		case PARTICLE_ID::COYOTE_PARTICLES: {
-			registry.animateRequests.emplace(entity).used_animation = ANIMATION_ID::COYOTE_PARTICLES;
-			break;
-		}
-		case PARTICLE_ID::CRACKING_RADIAL: {
-			Particle& par = registry.particles.get(entity);
-			par.angle = (int)(rand_float(0.0, 4.0)) * 90.0f;
+	int slot = target.add();
+	if (slot < 0) {
+		stats[(int)current_effect].dropped++;
+		return -1;
+	}
+	stats[(int)current_effect].spawned++;
+
+	target.type[slot] = particle_id;
+	target.effect[slot] = current_effect;
+	target.alpha[slot] = alpha;
+	target.life[slot] = life;
+	target.timer[slot] = 0;
+	target.fade_in[slot] = fade_in_out[0];
+	target.fade_out[slot] = fade_in_out[1];
+	target.shrink_in[slot] = shrink_in_out[0];
+	target.shrink_out[slot] = shrink_in_out[1];
+	target.wind_influence[slot] = wind_influence;
+	target.gravity_influence[slot] = gravity_influence;
+	target.turbulence_influence[slot] = turbulence_influence;
+
+	target.angle[slot] = angle;
+	target.position_x[slot] = pos.x;
+	target.position_y[slot] = pos.y;
+	target.scale_x[slot] = scale.x;
+	target.scale_y[slot] = scale.y;
+	target.velocity_x[slot] = velocity.x;
+	target.velocity_y[slot] = velocity.y;
+
+	return slot;
+}
 
-			registry.animateRequests.emplace(entity).used_animation = ANIMATION_ID::CRACKING_RADIAL;
-			break;
-		}
-		case PARTICLE_ID::CRACKING_DOWNWARD: {
-			registry.animateRequests.emplace(entity).used_animation = ANIMATION_ID::CRACKING_DOWNWARD;
-			break;
-		}
-		case PARTICLE_ID::EXHALE: {
-			Particle& par = registry.particles.get(entity);
-			par.angle = rand_float(0.0f, 360.0f);
-			par.ang_velocity = rand_float(10.0, 20.0f) * glm::sign(par.velocity.x);
-			par.gravity_influence = -0.05f;
-
-			registry.animateRequests.emplace(entity).used_animation = ANIMATION_ID::EXHALE;
-			break;
+void ParticleSystem::handle_particle_type(ParticlePool& target, int slot, PARTICLE_ID particle_id) {
+	const ParticleTypeDescriptor& type = particle_types[(int)particle_id];
+
+	target.velocity_decay[slot] = type.velocity_decay;
+	if (!type.expires) {
+		target.life[slot] = INFINITY;
+		target.cull_distance_sq[slot] = INFINITY;
+	}
+
+	if (type.overrides_gravity) {
+		target.gravity_influence[slot] = type.gravity_influence;
+	}
+
+	if (type.randomizes_angle) {
+		float angle = rand_float(type.angle_range[0], type.angle_range[1]);
+		if (type.angle_snap > 0.0f) {
+			angle = (int)(angle / type.angle_snap) * type.angle_snap;
 		}
-		case PARTICLE_ID::BROKEN_PARTS: {
-			Particle& par = registry.particles.get(entity);
-			par.angle = rand_float(0.0f, 360.0f);
-			par.ang_velocity = rand_float(-20.0f, 20.0f);
-			par.gravity_influence = 0.3f;
-
-			registry.animateRequests.emplace(entity).used_animation = ANIMATION_ID::BROKEN_PARTS;
-			break;
+		target.angle[slot] = angle;
+	}
+
+	if (type.angular_velocity_range[0] != 0.0f || type.angular_velocity_range[1] != 0.0f) {
+		float angular_velocity = rand_float(type.angular_velocity_range[0], type.angular_velocity_range[1]);
+		if (type.spins_with_velocity) {
+			angular_velocity *= glm::sign(target.velocity_x[slot]);
 		}
-		case PARTICLE_ID::CROSS_STAR: {
-			Particle& par = registry.particles.get(entity);
-			par.angle = rand_float(0.0f, 360.0f);
-			par.ang_velocity = rand_float(-180.0f, 180.0f);
-			break;
+		target.angular_velocity[slot] = angular_velocity;
+	}
+
+	if (type.animation != ANIMATION_ID::ANIMATION_COUNT && type.animation_type == ANIMATION_TYPE_ID::FREEZE_ON_RANDOM) {
+		target.animation_timer[slot] = rand_float(1e-4f, type.duration_ms);
+	}
+	else if (type.animation != ANIMATION_ID::ANIMATION_COUNT && type.animation_type == ANIMATION_TYPE_ID::FREEZE_ON_LAST) {
+		target.animation_limit[slot] = type.duration_ms + type.ms_per_frame;
+	}
+	else if (type.animation != ANIMATION_ID::ANIMATION_COUNT && type.animation_type == ANIMATION_TYPE_ID::CYCLE) {
+		// an unbounded timer, wrapped onto the frames when they are picked
+		target.animation_limit[slot] = INFINITY;
+	}
+}
+
+unsigned int ParticleSystem::finish_spawn(ParticlePool& target, int slot) {
+	const int priority = particle_effects[(int)target.effect[slot]].priority;
+	if (&target == &pool) {
+		if (target.life[slot] != INFINITY) {
+			pool_victims[priority].push_back(target.handle(slot));
 		}
-		default:
-			success = false;
-			break;
+		return target.handle(slot);
+	}
+
+	const ParticleTypeDescriptor& type = particle_types[(int)target.type[slot]];
+
+	// admit_spawn made room in the ring
+	assert(!gpu_free_slots.empty());
+	std::pop_heap(gpu_free_slots.begin(), gpu_free_slots.end(), std::greater<>());
+	const int ring_slot = gpu_free_slots.back();
+	gpu_free_slots.pop_back();
+
+	GpuSlot& record = gpu_slots[ring_slot];
+	record.live = true;
+	record.effect = target.effect[slot];
+	record.expires_at_ms = gpu_clock_ms + target.life[slot] - target.timer[slot];
+	gpu_live_count++;
+	stats[(int)record.effect].gpu_live++;
+
+	const unsigned int handle = gpu_handle(ring_slot);
+	gpu_expiries.push_back({ record.expires_at_ms, handle });
+	std::push_heap(gpu_expiries.begin(), gpu_expiries.end(), std::greater<>());
+	gpu_victims[priority].push_back(handle);
+
+	GpuParticleState state;
+	state.motion = { target.position_x[slot], target.position_y[slot], target.velocity_x[slot], target.velocity_y[slot] };
+	state.spin = { target.angle[slot], target.angular_velocity[slot], target.scale_x[slot], target.scale_y[slot] };
+	state.lifetime = { target.life[slot], target.timer[slot], target.alpha[slot], target.velocity_decay[slot] };
+	state.envelope = { target.fade_in[slot], target.fade_out[slot], target.shrink_in[slot], target.shrink_out[slot] };
+	state.influence = { target.wind_influence[slot], target.gravity_influence[slot], target.turbulence_influence[slot], target.cull_distance_sq[slot] };
+	state.animation = { target.animation_timer[slot], target.animation_limit[slot], (float)type.frame_count, type.ms_per_frame };
+	state.appearance = vec4(target.color[slot], (float)target.type[slot]);
+	gpu_spawns.push_back({ ring_slot, state });
+
+	target.remove(slot);
+	return handle;
+}
+
+static_assert(PARTICLE_COUNT_LIMIT + GPU_PARTICLE_CAPACITY < (1 << PARTICLE_HANDLE_INDEX_BITS),
+	"GPU particle handles need index room past the pool's");
+
+unsigned int ParticleSystem::gpu_handle(int ring_slot) {
+	return (gpu_slots[ring_slot].generation << PARTICLE_HANDLE_INDEX_BITS) | (unsigned int)(pool.capacity() + ring_slot + 1);
+}
+
+int ParticleSystem::gpu_slot(unsigned int handle) {
+	const int ring_slot = (int)(handle & ((1u << PARTICLE_HANDLE_INDEX_BITS) - 1)) - 1 - pool.capacity();
+	if (ring_slot < 0 || ring_slot >= (int)gpu_slots.size() || !gpu_slots[ring_slot].live ||
+		gpu_slots[ring_slot].generation != (handle >> PARTICLE_HANDLE_INDEX_BITS)) {
+		return -1;
 	}
+	return ring_slot;
+}
 
-	if (success) {
-		registry.renderRequests.insert(entity, {
-			TEXTURE_ASSET_ID::BLACK,
-			EFFECT_ASSET_ID::PARTICLE_INSTANCED,
-			GEOMETRY_BUFFER_ID::SPRITE});
+void ParticleSystem::reset_gpu_slots() {
+	for (GpuSlot& record : gpu_slots) {
+		if (record.live) {
+			record.live = false;
+			record.generation = (record.generation + 1) & (~0u >> PARTICLE_HANDLE_INDEX_BITS);
+		}
+	}
+	// ascending order is already a valid min-heap
+	gpu_free_slots.resize(gpu_slots.size());
+	for (int i = 0; i < (int)gpu_free_slots.size(); i++) {
+		gpu_free_slots[i] = i;
 	}
-	else {
-		registry.remove_all_components_of(entity);
+	gpu_expiries.clear();
+	gpu_live_count = 0;
+	for (ParticleEffectStats& effect_stats : stats) {
+		effect_stats.gpu_live = 0;
 	}
+	for (std::deque<unsigned int>& victims : gpu_victims) {
+		victims.clear();
+	}
+}
 
-	return success;
+void ParticleSystem::retire_gpu_slot(int ring_slot) {
+	GpuSlot& record = gpu_slots[ring_slot];
+	record.live = false;
+	record.generation = (record.generation + 1) & (~0u >> PARTICLE_HANDLE_INDEX_BITS);
+	gpu_live_count--;
+	stats[(int)record.effect].gpu_live--;
+
+	gpu_free_slots.push_back(ring_slot);
+	std::push_heap(gpu_free_slots.begin(), gpu_free_slots.end(), std::greater<>());
 }
 
-// GPU-styled turbulence generation
-vec3 ParticleSystem::seeded_pseudo_random(vec3 input) {
-	// If you sense magical numbers here, we do exactly need them
-	vec3 raw_result = 11.464f * vec3{ 
-		abs(sinf(glm::dot(input, vec3{63.36f, -95.52f, 12.41f}))),
-		abs(sinf(glm::dot(input, vec3{84.14f, 18.63f, 84.48f}))),
-		abs(sinf(glm::dot(input, vec3{98.61f, 36.813f, 48.351f})))};
+void ParticleSystem::kill_gpu_slot(int ring_slot) {
+	GpuParticleState dead = {};
+	dead.lifetime = { -1.0f, 0.0f, 0.0f, 1.0f };
+	gpu_spawns.push_back({ ring_slot, dead });
+	retire_gpu_slot(ring_slot);
+}
 
-	return glm::fract(raw_result) * 2.0f - 1.0f;
+void ParticleSystem::take_gpu_spawns(std::vector<GpuParticleSpawn>& spawns, bool& cleared) {
+	spawns.clear();
+	std::swap(spawns, gpu_spawns);
+	cleared = gpu_cleared;
+	gpu_cleared = false;
 }
 
-float ParticleSystem::sample_from_gradient_noise(vec3 input) {
-	vec3 grid_int = glm::floor(input);
-	vec3 grid_frac = input - grid_int;
+bool ParticleSystem::take_gpu_step(ParticleStepParams& params) {
+	if (!gpu_step_pending) {
+		return false;
+	}
+	params = gpu_step_params;
+	gpu_step_pending = false;
+	return true;
+}
 
-	// 8 grid points
-	float grid_000 = glm::dot(seeded_pseudo_random(grid_int), grid_frac);
-	float grid_100 = glm::dot(seeded_pseudo_random(grid_int + vec3{ 1.0f, 0.0f, 0.0f }), grid_frac - vec3{ 1.0f, 0.0f, 0.0f });
-	float grid_010 = glm::dot(seeded_pseudo_random(grid_int + vec3{ 0.0f, 1.0f, 0.0f }), grid_frac - vec3{ 0.0f, 1.0f, 0.0f });
-	float grid_110 = glm::dot(seeded_pseudo_random(grid_int + vec3{ 1.0f, 1.0f, 0.0f }), grid_frac - vec3{ 1.0f, 1.0f, 0.0f });
-	float grid_001 = glm::dot(seeded_pseudo_random(grid_int + vec3{ 0.0f, 0.0f, 0.1f }), grid_frac - vec3{ 0.0f, 0.0f, 0.1f });
-	float grid_101 = glm::dot(seeded_pseudo_random(grid_int + vec3{ 1.0f, 0.0f, 0.1f }), grid_frac - vec3{ 1.0f, 0.0f, 0.1f });
-	float grid_011 = glm::dot(seeded_pseudo_random(grid_int + vec3{ 0.0f, 1.0f, 0.1f }), grid_frac - vec3{ 0.0f, 1.0f, 0.1f });
-	float grid_111 = glm::dot(seeded_pseudo_random(grid_int + vec3{ 1.0f, 1.0f, 0.1f }), grid_frac - vec3{ 1.0f, 1.0f, 0.1f });
+vec2 ParticleSystem::animation_u_range(int slot) {
+	const ParticleTypeDescriptor& type = particle_types[(int)pool.type[slot]];
+	if (type.animation == ANIMATION_ID::ANIMATION_COUNT) {
+		return { 0.0f, 1.0f };
+	}
 
-	// The GLSL smoothstep function: https://registry.khronos.org/OpenGL-Refpages/gl4/html/smoothstep.xhtml
-	vec3 factor = grid_frac * grid_frac * (3.0f - 2.0f * grid_frac);
+	int frame = (int)(pool.animation_timer[slot] / type.ms_per_frame);
+	frame = type.animation_type == ANIMATION_TYPE_ID::CYCLE ? frame % type.frame_count : min(frame, type.frame_count - 1);
+	float start_u_coord = (float)frame / (float)type.frame_count;
+	return { start_u_coord, start_u_coord + 1.0f / type.frame_count };
+}
 
-	return lerpToTarget(
-		lerpToTarget(lerpToTarget(grid_000, grid_100, factor.x), lerpToTarget(grid_010, grid_110, factor.x), factor.y),
-		lerpToTarget(lerpToTarget(grid_001, grid_101, factor.x), lerpToTarget(grid_011, grid_111, factor.x), factor.y), factor.z);
+void ParticleSystem::set_animation_timer(unsigned int handle, float timer) {
+	int slot = pool.slot(handle);
+	if (slot >= 0) {
+		pool.animation_timer[slot] = timer;
+	}
 }
 
-float ParticleSystem::sample_from_turbulence(vec3 coord) {
-	float result = 0.0;
-	float amplitude = 4.0;
+void ParticleSystem::remove_particle(unsigned int handle) {
+	int slot = pool.slot(handle);
+	if (slot >= 0) {
+		pool.remove(slot);
+		return;
+	}
 
-	for (int i = 0; i < TURBULENCE_OCTAVES; i++) {
-		// absolute ensures turbulencer behavior: https://thebookofshaders.com/13/
-		result += (amplitude * abs(sample_from_gradient_noise(coord)));
-		coord *= 0.5f;
-		amplitude *= 2.0f;
+	const int ring_slot = gpu_slot(handle);
+	if (ring_slot >= 0) {
+		kill_gpu_slot(ring_slot);
 	}
+}
 
-	return result;
+void ParticleSystem::clear_particles() {
+	pool.clear();
+	for (std::deque<unsigned int>& victims : pool_victims) {
+		victims.clear();
+	}
+	reset_gpu_slots();
+	gpu_spawns.clear();
+	gpu_cleared = true;
 }
 
 void ParticleSystem::set_wind(float strength, vec2 direction) {
@@ -346,4 +643,131 @@ void ParticleSystem::emit_elliptical_particles(vec2 center, vec2 dimension, floa
 			vec2(size), velocity,
 			life, 1.0f, { 0.0f, 0.35f * life }, { 0.1f * life, 0.35f * life });
 	}
-}
\ No newline at end of file
+}
+
+namespace {
+	ParticleStepParams benchmark_step_params(const TurbulenceField& field) {
+		ParticleStepParams params;
+		params.time_change_s = 1.0f / 60.0f;
+		params.animation_elapsed_ms = 1000.0f / 60.0f;
+		params.cull_by_camera = true;
+		params.gravity_field = { 0.0f, GRAVITY };
+		params.field = &field;
+		params.turbulence_strength = 150.0f;
+		params.field_cells_per_pixel = TURBULENCE_FIELD_CELLS_PER_NOISE / TURBULENCE_GRID_SIZE;
+		return params;
+	}
+
+	// Nothing dies, so every frame updates the full pool
+	void fill_benchmark_pool(ParticlePool& bench_pool, int particle_count) {
+		bench_pool.clear();
+		for (int i = 0; i < particle_count; i++) {
+			const int slot = bench_pool.add();
+			bench_pool.position_x[slot] = rand_float(-0.5f, 0.5f) * MAX_CAMERA_DISTANCE;
+			bench_pool.position_y[slot] = rand_float(-0.5f, 0.5f) * MAX_CAMERA_DISTANCE;
+			bench_pool.velocity_x[slot] = rand_float(-50.0f, 50.0f);
+			bench_pool.velocity_y[slot] = rand_float(-50.0f, 50.0f);
+			bench_pool.angular_velocity[slot] = rand_float(-180.0f, 180.0f);
+			bench_pool.life[slot] = INFINITY;
+			bench_pool.cull_distance_sq[slot] = INFINITY;
+			bench_pool.gravity_influence[slot] = 0.1f;
+			bench_pool.turbulence_influence[slot] = 1.0f;
+		}
+	}
+
+	// Steps a pool seeded with seed, where particles die along the way, on thread_count workers and
+	// returns a checksum of the particles left
+	uint64_t run_seeded_parallel(ParticlePool& bench_pool, int particle_count, int frames, unsigned int seed,
+		int thread_count, const ParticleStepParams& params, double& ms_per_frame)
+	{
+		WorkerPool bench_workers;
+		bench_workers.start(thread_count);
+		std::vector<std::vector<int>> deaths;
+		std::vector<uint8_t> dead(particle_count);
+
+		srand(seed);
+		fill_benchmark_pool(bench_pool, particle_count);
+		for (int i = 0; i < particle_count; i++) {
+			bench_pool.life[i] = rand_float(0.0f, 2.0f * frames * params.time_change_s * 1000.0f);
+		}
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			step_particles_parallel(bench_pool, params, dead.data(), bench_workers, deaths);
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		ms_per_frame = std::chrono::duration<double, std::milli>(end - start).count() / frames;
+
+		return content_hash(bench_pool.position_x.data(), bench_pool.size() * sizeof(float)) ^
+			content_hash(bench_pool.velocity_y.data(), bench_pool.size() * sizeof(float));
+	}
+}
+
+void ParticleSystem::run_benchmark(int particle_count, int frames) {
+	TurbulenceField field;
+	field.generate(turbulence_time());
+
+	ParticlePool bench_pool;
+	bench_pool.reserve(particle_count);
+	std::vector<uint8_t> dead(particle_count);
+	const ParticleStepParams params = benchmark_step_params(field);
+
+	auto time_kernel = [&](void (*kernel)(ParticlePool&, const ParticleStepParams&, uint8_t*)) {
+		fill_benchmark_pool(bench_pool, particle_count);
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			kernel(bench_pool, params, dead.data());
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::nano>(end - start).count() / ((double)frames * particle_count);
+	};
+
+	const double scalar_ns = time_kernel(step_particles_scalar);
+	const double dispatched_ns = time_kernel(step_particles);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int frame = 0; frame < frames; frame++) {
+		field.regenerate_slice(turbulence_time());
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	const double slice_ms = std::chrono::duration<double, std::milli>(end - start).count() / frames;
+
+	printf("Particle kernel benchmark: %d particles, %d frames\n", particle_count, frames);
+	printf("  scalar: %.2f ns/particle (%.3f ms/frame)\n", scalar_ns, scalar_ns * particle_count * 1e-6);
+	printf("  %s: %.2f ns/particle (%.3f ms/frame)\n", particle_kernel_name(), dispatched_ns, dispatched_ns * particle_count * 1e-6);
+	printf("  turbulence slice: %.3f ms/frame\n", slice_ms);
+
+	for (int thread_count = 1; thread_count <= PARTICLE_WORKER_LIMIT; thread_count *= 2) {
+		double ms_per_frame;
+		const uint64_t checksum = run_seeded_parallel(bench_pool, particle_count, frames, 1, thread_count, params, ms_per_frame);
+		printf("  parallel, %d threads: %.3f ms/frame, %d left, checksum %016llx\n", thread_count,
+			ms_per_frame, bench_pool.size(), (unsigned long long)checksum);
+	}
+}
+
+bool ParticleSystem::verify_determinism(int particle_count, int frames) {
+	TurbulenceField field;
+	field.generate(0.0f);
+	const ParticleStepParams params = benchmark_step_params(field);
+	ParticlePool bench_pool;
+	bench_pool.reserve(particle_count);
+
+	// the same seed has to leave the same pool on every run and for any thread count
+	uint64_t reference = 0;
+	bool deterministic = true;
+	for (int thread_count = 1; thread_count <= PARTICLE_WORKER_LIMIT; thread_count *= 2) {
+		for (int run = 0; run < 2; run++) {
+			double ms_per_frame;
+			const uint64_t checksum = run_seeded_parallel(bench_pool, particle_count, frames, 1, thread_count, params, ms_per_frame);
+			if (thread_count == 1 && run == 0) {
+				reference = checksum;
+			}
+			const bool same = checksum == reference;
+			deterministic &= same;
+			printf("  %d threads, run %d: checksum %016llx %s\n", thread_count, run + 1,
+				(unsigned long long)checksum, same ? "matches" : "DIFFERS");
+		}
+	}
+	printf("Particle determinism: %s\n", deterministic ? "ok" : "FAILED");
+	return deterministic;
+}
@@ -1,14 +1,87 @@
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <deque>
+#include <utility>
+#include <vector>
 
 #include "../../common.hpp"
 #include "../../tinyECS/component_container.hpp"
 #include "../../tinyECS/components.hpp"
 #include "../../tinyECS/registry.hpp"
 #include "systems/ISystem.hpp"
+#include "particle_kernel.hpp"
+#include "particle_pool.hpp"
+#include "turbulence_field.hpp"
+
+// Emitter descriptor of one particle type: what a spawn overrides and how the particle evolves
+struct ParticleTypeDescriptor {
+	ANIMATION_ID animation = ANIMATION_ID::ANIMATION_COUNT;	// ANIMATION_COUNT when not animated
+	bool expires = true;			// false when the owner removes the particle (e.g. cracks)
+
+	bool overrides_gravity = false;
+	float gravity_influence = 0.0f;
+
+	bool randomizes_angle = false;
+	vec2 angle_range = { 0.0f, 0.0f };
+	float angle_snap = 0.0f;		// degrees, 0 for continuous
+	vec2 angular_velocity_range = { 0.0f, 0.0f };
+	bool spins_with_velocity = false;	// angular velocity takes the sign of velocity.x
+
+	float velocity_decay = 1.0f;	// per step
+
+	// Filled from the animation clip at init
+	ANIMATION_TYPE_ID animation_type = ANIMATION_TYPE_ID::FREEZE;
+	int frame_count = 1;
+	float duration_ms = 1.0f;
+	float ms_per_frame = 1.0f;
+};
+
+// How a gameplay effect competes for the particle budget
+struct ParticleEffectDescriptor {
+	const char* name = "";
+	int priority = 0;		// a spawn may cull live particles of lower priority when the pool is full
+	bool thinnable = false;	// cosmetic: spawn rate drops with camera distance and pool pressure
+};
+
+// Per effect telemetry; counters accumulate from startup
+struct ParticleEffectStats {
+	int live = 0;			// in the CPU pool after the last step
+	int gpu_live = 0;		// in the GPU ring, by expiry
+	int spawned = 0;
+	int thinned = 0;		// skipped by LOD
+	int dropped = 0;		// no room and nothing of lower priority to cull
+	int evicted = 0;		// culled to make room for a higher priority spawn
+	double update_ms = 0.0;	// estimate: the measured CPU update time split by live count
+};
+
+// Initial state of a particle handed to the GPU backend, packed as the vertex attributes of
+// its simulation pass
+struct GpuParticleState {
+	vec4 motion;		// position.xy, velocity.xy
+	vec4 spin;			// angle, angular velocity, scale.xy
+	vec4 lifetime;		// life, timer, alpha, velocity decay
+	vec4 envelope;		// fade in, fade out, shrink in, shrink out
+	vec4 influence;		// wind, gravity, turbulence, cull distance squared
+	vec4 animation;		// timer, limit, frame count, ms per frame
+	vec4 appearance;	// color.rgb, particle id
+};
+
+// A state to write into one slot of the GPU ring; a negative life overwrites the slot with a
+// dead particle
+struct GpuParticleSpawn {
+	int slot;
+	GpuParticleState state;
+};
 
 // Particle System
+// Particles live in a pooled SoA buffer instead of the ECS; the spawn functions return a handle
+// that stays valid until the particle dies or is removed.
+// With GPU simulation on, expiring particles are queued for the render system's transform
+// feedback backend instead; only owned particles (cracks) stay in the pool. Their ring slots are
+// handed out here, so they go through the same LOD and budget as pooled particles and their
+// handles work with remove_particle (set_animation_timer has no effect on them).
 class ParticleSystem : public ISystem
 {
 public:
@@ -17,9 +90,9 @@ public:
 	void late_step(float elapsed_ms) override;
 
 	static unsigned int spawn_particle(
-		PARTICLE_ID particle_id, 
-		vec2 pos, float angle, vec2 scale, vec2 velocity, 
-		float life, 
+		PARTICLE_ID particle_id,
+		vec2 pos, float angle, vec2 scale, vec2 velocity,
+		float life,
 		float alpha = 1.0, vec2 fade_in_out = vec2{ 0.0, 0.0 }, vec2 shrink_in_out = vec2{ 0.0, 0.0 },
 		float wind_influence = 0.0, float gravity_influence = 0.0, float turbulence_influence = 0.0);
 
@@ -34,22 +107,131 @@ public:
 
 	static void emit_elliptical_particles(vec2 center, vec2 dimension, float angle_rad, int count, float local_speed, vec2 global_velocity, vec3 color, float size, float life);
 
+	// Drives the animation of a particle whose clip is frozen (e.g. crack progress)
+	static void set_animation_timer(unsigned int handle, float timer);
+	static void remove_particle(unsigned int handle);
+	static void clear_particles();
+
+	// Effect the following spawns are attributed to; see ParticleEffectScope
+	static void set_current_effect(PARTICLE_EFFECT_ID effect) { current_effect = effect; }
+	static PARTICLE_EFFECT_ID get_current_effect() { return current_effect; }
+
+	static const std::array<ParticleEffectStats, particle_effect_count>& effect_stats() { return stats; }
+	static void set_telemetry(bool enabled) { telemetry_enabled = enabled; }
+	static void print_telemetry();
+
+	static const ParticlePool& particles() { return pool; }
+	static vec2 animation_u_range(int slot);
+
+	// Times the update kernel on a synthetic pool and prints ns per particle
+	static void run_benchmark(int particle_count, int frames);
+	// Runs the same seeded parallel update twice for each thread count; false if any checksum differs
+	static bool verify_determinism(int particle_count, int frames);
+
+	static void set_gpu_simulation(bool enabled) { gpu_simulation = enabled; }
+	static bool uses_gpu_simulation() { return gpu_simulation; }
+	static const ParticleTypeDescriptor& particle_type(PARTICLE_ID particle_id) { return particle_types[(int)particle_id]; }
+
+	// Consumed by the GPU backend once per frame: the spawns queued since the last call, whether
+	// the particles were cleared in between, and the parameters of the latest step (false when
+	// no step ran, e.g. while paused)
+	static void take_gpu_spawns(std::vector<GpuParticleSpawn>& spawns, bool& cleared);
+	static bool take_gpu_step(ParticleStepParams& params);
+
 	ParticleSystem()
 	{
 	}
 private:
 	GLFWwindow* window = nullptr;
 
-	static Entity set_basic_particle(
-		PARTICLE_ID particle_id,
+	inline static ParticlePool pool;
+	// Single-slot record a GPU spawn is set up in before it moves to the ring, so GPU spawns
+	// never compete with CPU particles for pool slots
+	inline static ParticlePool gpu_staging;
+	inline static std::array<ParticleTypeDescriptor, particle_type_count> particle_types;
+	inline static TurbulenceField turbulence_field;
+	inline static std::vector<uint8_t> dead_particles;
+	inline static WorkerPool workers;
+	inline static std::vector<std::vector<int>> chunk_deaths;
+
+	inline static std::array<ParticleEffectDescriptor, particle_effect_count> particle_effects;
+	inline static PARTICLE_EFFECT_ID current_effect = PARTICLE_EFFECT_ID::AMBIENT;
+	inline static std::array<float, particle_effect_count> lod_accumulators = {};
+	inline static std::array<ParticleEffectStats, particle_effect_count> stats;
+	inline static bool telemetry_enabled = false;
+	inline static float telemetry_timer_ms = 0.0f;
+	inline static int stepped_frames = 0;
+
+	inline static bool gpu_simulation = false;
+	inline static std::vector<GpuParticleSpawn> gpu_spawns;
+	inline static bool gpu_cleared = false;
+	inline static ParticleStepParams gpu_step_params;
+	inline static bool gpu_step_pending = false;
+
+	// Nothing is read back from the GPU, so its ring slots are tracked here and retired once
+	// their particle's life has run out in simulated time (camera culling on the GPU goes unseen,
+	// which only makes the count conservative)
+	struct GpuSlot {
+		double expires_at_ms = 0.0;
+		PARTICLE_EFFECT_ID effect = PARTICLE_EFFECT_ID::AMBIENT;
+		unsigned int generation = 0;
+		bool live = false;
+	};
+	inline static std::vector<GpuSlot> gpu_slots;
+	inline static std::vector<int> gpu_free_slots;		// min-heap, keeps the live slots packed at the front
+	inline static std::vector<std::pair<double, unsigned int>> gpu_expiries;	// min-heap of (expiry, handle)
+	inline static double gpu_clock_ms = 0.0;
+	inline static int gpu_live_count = 0;
+
+	// Handles of expiring particles per priority, oldest first, so eviction never scans the pool.
+	// Particles that died on their own stay queued until they come up or the queue is trimmed.
+	inline static std::vector<std::deque<unsigned int>> pool_victims;
+	inline static std::vector<std::deque<unsigned int>> gpu_victims;
+
+	static float turbulence_time();
+
+	// Pool a new particle is set up in: the pool itself or the GPU staging record
+	static ParticlePool& spawn_pool(PARTICLE_ID particle_id, float life);
+	static int set_basic_particle(
+		ParticlePool& target, PARTICLE_ID particle_id,
 		vec2 pos, float angle, vec2 scale, vec2 velocity,
 		float life,
 		float alpha = 1.0, vec2 fade_in_out = vec2{ 0.0, 0.0 }, vec2 shrink_in_out = vec2{0.0, 0.0},
 		float wind_influence = 0.0, float gravity_influence = 0.0, float turbulence_influence = 0.0);
 
-	static bool handle_particle_type(Entity entity, PARTICLE_ID particle_id);
+	// Applies LOD and the budget of the backend the spawn goes to; false if it should be skipped
+	static bool admit_spawn(vec2 pos, bool on_gpu);
+	// Culls a batch of the lowest priority particles below priority; false if there are none
+	static bool evict_below(int priority, bool on_gpu);
+	// Drops the handles of dead particles once they outnumber the live ones
+	static void trim_victims(std::deque<unsigned int>& victims, int live, bool on_gpu);
 
-	static vec3 seeded_pseudo_random(vec3 input);
-	static float sample_from_gradient_noise(vec3 input);
-	static float sample_from_turbulence(vec3 coord);
-};
\ No newline at end of file
+	// GPU handles continue the pool's handle indices past its capacity
+	static unsigned int gpu_handle(int ring_slot);
+	static int gpu_slot(unsigned int handle);
+	static void reset_gpu_slots();
+	static void retire_gpu_slot(int ring_slot);
+	// Overwrites the slot with a dead particle and retires it
+	static void kill_gpu_slot(int ring_slot);
+
+	static void handle_particle_type(ParticlePool& target, int slot, PARTICLE_ID particle_id);
+	// Moves a particle set up in the GPU staging record to a ring slot; returns its handle either way
+	static unsigned int finish_spawn(ParticlePool& target, int slot);
+};
+
+// Attributes every particle spawned during its lifetime to an effect:
+//   ParticleEffectScope effect(PARTICLE_EFFECT_ID::BOSS_DAMAGE);
+class ParticleEffectScope {
+public:
+	explicit ParticleEffectScope(PARTICLE_EFFECT_ID effect) : previous(ParticleSystem::get_current_effect())
+	{
+		ParticleSystem::set_current_effect(effect);
+	}
+	~ParticleEffectScope() { ParticleSystem::set_current_effect(previous); }
+
+	ParticleEffectScope(const ParticleEffectScope&) = delete;
+	ParticleEffectScope& operator=(const ParticleEffectScope&) = delete;
+
+private:
+	PARTICLE_EFFECT_ID previous;
+};
@@ -0,0 +1,105 @@
+#include "turbulence_field.hpp"
+
+void TurbulenceField::generate(float time) {
+	const int resolution = TURBULENCE_FIELD_RESOLUTION;
+	field_x.resize(resolution * resolution);
+	field_y.resize(resolution * resolution);
+
+	for (int row = 0; row < resolution; row++) {
+		generate_row(row, time);
+	}
+	next_row = 0;
+}
+
+void TurbulenceField::regenerate_slice(float time) {
+	generate_row(next_row, time);
+	next_row = (next_row + 1) % TURBULENCE_FIELD_RESOLUTION;
+}
+
+void TurbulenceField::generate_row(int row, float time) {
+	const int resolution = TURBULENCE_FIELD_RESOLUTION;
+	for (int column = 0; column < resolution; column++) {
+		const vec3 coord = { column / TURBULENCE_FIELD_CELLS_PER_NOISE, row / TURBULENCE_FIELD_CELLS_PER_NOISE, time };
+		const vec2 direction = angle_to_direction(M_PI * 2.0f * sample_from_turbulence(coord, resolution / TURBULENCE_FIELD_CELLS_PER_NOISE));
+		field_x[row * resolution + column] = direction.x;
+		field_y[row * resolution + column] = direction.y;
+	}
+}
+
+vec2 TurbulenceField::sample(float u, float v) const {
+	const int mask = TURBULENCE_FIELD_RESOLUTION - 1;
+	const float u_floor = floorf(u);
+	const float v_floor = floorf(v);
+	const float s = u - u_floor;
+	const float t = v - v_floor;
+
+	// the resolution is a power of two, so masking wraps negative cells too
+	const int x0 = (int)u_floor & mask;
+	const int y0 = (int)v_floor & mask;
+	const int x1 = (x0 + 1) & mask;
+	const int y1 = (y0 + 1) & mask;
+
+	const int i00 = y0 * TURBULENCE_FIELD_RESOLUTION + x0;
+	const int i10 = y0 * TURBULENCE_FIELD_RESOLUTION + x1;
+	const int i01 = y1 * TURBULENCE_FIELD_RESOLUTION + x0;
+	const int i11 = y1 * TURBULENCE_FIELD_RESOLUTION + x1;
+
+	return {
+		lerpToTarget(lerpToTarget(field_x[i00], field_x[i10], s), lerpToTarget(field_x[i01], field_x[i11], s), t),
+		lerpToTarget(lerpToTarget(field_y[i00], field_y[i10], s), lerpToTarget(field_y[i01], field_y[i11], s), t)
+	};
+}
+
+// GPU-styled turbulence generation
+vec3 TurbulenceField::seeded_pseudo_random(vec3 input) {
+	// If you sense magical numbers here, we do exactly need them
+	vec3 raw_result = 11.464f * vec3{ 
+		abs(sinf(glm::dot(input, vec3{63.36f, -95.52f, 12.41f}))),
+		abs(sinf(glm::dot(input, vec3{84.14f, 18.63f, 84.48f}))),
+		abs(sinf(glm::dot(input, vec3{98.61f, 36.813f, 48.351f})))};
+
+	return glm::fract(raw_result) * 2.0f - 1.0f;
+}
+
+// Wraps a lattice point's x and y into [0, period) so the noise tiles with the field
+vec3 TurbulenceField::wrap_lattice(vec3 lattice, float period) {
+	return { lattice.x - period * floorf(lattice.x / period), lattice.y - period * floorf(lattice.y / period), lattice.z };
+}
+
+float TurbulenceField::sample_from_gradient_noise(vec3 input, float period) {
+	vec3 grid_int = glm::floor(input);
+	vec3 grid_frac = input - grid_int;
+
+	// 8 grid points
+	float grid_000 = glm::dot(seeded_pseudo_random(wrap_lattice(grid_int, period)), grid_frac);
+	float grid_100 = glm::dot(seeded_pseudo_random(wrap_lattice(grid_int + vec3{ 1.0f, 0.0f, 0.0f }, period)), grid_frac - vec3{ 1.0f, 0.0f, 0.0f });
+	float grid_010 = glm::dot(seeded_pseudo_random(wrap_lattice(grid_int + vec3{ 0.0f, 1.0f, 0.0f }, period)), grid_frac - vec3{ 0.0f, 1.0f, 0.0f });
+	float grid_110 = glm::dot(seeded_pseudo_random(wrap_lattice(grid_int + vec3{ 1.0f, 1.0f, 0.0f }, period)), grid_frac - vec3{ 1.0f, 1.0f, 0.0f });
+	float grid_001 = glm::dot(seeded_pseudo_random(wrap_lattice(grid_int + vec3{ 0.0f, 0.0f, 0.1f }, period)), grid_frac - vec3{ 0.0f, 0.0f, 0.1f });
+	float grid_101 = glm::dot(seeded_pseudo_random(wrap_lattice(grid_int + vec3{ 1.0f, 0.0f, 0.1f }, period)), grid_frac - vec3{ 1.0f, 0.0f, 0.1f });
+	float grid_011 = glm::dot(seeded_pseudo_random(wrap_lattice(grid_int + vec3{ 0.0f, 1.0f, 0.1f }, period)), grid_frac - vec3{ 0.0f, 1.0f, 0.1f });
+	float grid_111 = glm::dot(seeded_pseudo_random(wrap_lattice(grid_int + vec3{ 1.0f, 1.0f, 0.1f }, period)), grid_frac - vec3{ 1.0f, 1.0f, 0.1f });
+
+	// The GLSL smoothstep function: https://registry.khronos.org/OpenGL-Refpages/gl4/html/smoothstep.xhtml
+	vec3 factor = grid_frac * grid_frac * (3.0f - 2.0f * grid_frac);
+
+	return lerpToTarget(
+		lerpToTarget(lerpToTarget(grid_000, grid_100, factor.x), lerpToTarget(grid_010, grid_110, factor.x), factor.y),
+		lerpToTarget(lerpToTarget(grid_001, grid_101, factor.x), lerpToTarget(grid_011, grid_111, factor.x), factor.y), factor.z);
+}
+
+float TurbulenceField::sample_from_turbulence(vec3 coord, float period) {
+	float result = 0.0;
+	float amplitude = 4.0;
+
+	for (int i = 0; i < TURBULENCE_OCTAVES; i++) {
+		// absolute ensures turbulencer behavior: https://thebookofshaders.com/13/
+		result += (amplitude * abs(sample_from_gradient_noise(coord, period)));
+		// the period halves with the coordinates, so it stays a whole number of lattice cells
+		coord *= 0.5f;
+		period *= 0.5f;
+		amplitude *= 2.0f;
+	}
+
+	return result;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "../../common.hpp"
+
+// Low-resolution flow field of turbulence directions, sampled bilinearly instead of evaluating
+// gradient noise per particle. The field covers TURBULENCE_FIELD_RESOLUTION^2 cells in noise space
+// and repeats beyond that, with noise that tiles at the same period; one row is re-evaluated per frame so the field follows the noise time.
+class TurbulenceField {
+public:
+	// Evaluates every cell; used once at startup
+	void generate(float time);
+	// Re-evaluates the next row
+	void regenerate_slice(float time);
+
+	// Unit direction at a position in field cells
+	vec2 sample(float u, float v) const;
+
+	const float* direction_x() const { return field_x.data(); }
+	const float* direction_y() const { return field_y.data(); }
+
+private:
+	void generate_row(int row, float time);
+
+	static float sample_from_turbulence(vec3 coord, float period);
+	static vec3 seeded_pseudo_random(vec3 input);
+	static vec3 wrap_lattice(vec3 lattice, float period);
+	static float sample_from_gradient_noise(vec3 input, float period);
+
+	std::vector<float> field_x;
+	std::vector<float> field_y;
+	int next_row = 0;
+};
@@ -10,7 +10,8 @@ void compute_platform_verticies(Motion& motion, Entity& e, float& angle_cos, flo
 	const float total_tiles = geo.num_tiles;
 	const float platform_center_offset = total_tiles * 0.5f * TILE_TO_PIXELS;
 
-	std::vector<vec2> platform_vertices;
+	FrameVector<vec2> platform_vertices;
+	platform_vertices.reserve(edge_mesh->vertices.size() * 2 + 4);
 
 	// left edge
 	for (auto& v : edge_mesh->vertices) {
@@ -387,6 +388,9 @@ void collision_check(Entity& entity_i, Motion& motion_i, Entity& entity_j) {
 	// before expensive SAT collision check, cheaply verify that the objects are even overlapping first...
 	if (!compute_AABB_collision(motion_i, motion_j)) return;
 
+	// parked entities stay where they were destroyed
+	if (!is_active(entity_j)) return;
+
 	Collision result = compute_sat_collision(motion_i, motion_j, entity_i, entity_j);
 
 	if (result.normal != vec2{0, 0}) {
@@ -3,6 +3,7 @@
 //
 
 #include "collision_handlers.h"
+#include "../world/entity_pool.hpp"
 #include <iostream>
 
 void handle_player_ladder_collision(Entity& player_entity, Entity& ladder_entity, int step_seconds) {
@@ -43,6 +44,9 @@ void drop_bolt_when_player_near(float dist_threshold) {
 
 	for (Entity& bolt : registry.bolts.entities)
 	{
+		// parked bolts keep their components until the pool hands them out again
+		if (!is_active(bolt)) continue;
+
 		Motion& bolt_motion = registry.motions.get(bolt);
 		vec2 dist_to_bolt = abs(bolt_motion.position - player_motion.position);
 
@@ -22,7 +22,7 @@ void handle_rotational_dynamics(Entity& object_entity, Entity& other_entity, con
 	vec2 platform_pos = other_motion.position;
 
 	// get all the verticies (including for composite meshes)
-	std::vector<vec2> object_vertices;
+	FrameVector<vec2> object_vertices;
 	if (registry.compositeMeshes.has(object_entity)) {
 		CompositeMesh& composite = registry.compositeMeshes.get(object_entity);
 		for (SubMesh& submesh : composite.meshes) {
@@ -31,13 +31,13 @@ void handle_rotational_dynamics(Entity& object_entity, Entity& other_entity, con
 			}
 		}
 	} else {
-		object_vertices = obj_motion.cached_vertices;
+		object_vertices.assign(obj_motion.cached_vertices.begin(), obj_motion.cached_vertices.end());
 	}
 
 
 	// determine candidate contact points
 	const float contact_threshold = 8.0f; // pixel threshold to find more ontacts
-	std::vector<vec2> contact_points;
+	FrameVector<vec2> contact_points;
 	for (const vec2& obj_v : object_vertices) {
 		float min_dist = FLT_MAX;
 		const std::vector<vec2>& platform_verts = other_motion.cached_vertices;
@@ -66,11 +66,11 @@ void handle_rotational_dynamics(Entity& object_entity, Entity& other_entity, con
 		return dot(a - platform_pos, platform_normal) < dot(b - platform_pos, platform_normal);
 	};
 
-	std::vector<vec2> sorted_contacts = contact_points;
+	FrameVector<vec2> sorted_contacts = contact_points;
 	std::sort(sorted_contacts.begin(), sorted_contacts.end(), cmp);
 
 	// Select up to two deepest contact points (those with the smallest projection values)
-	std::vector<vec2> selected_contacts;
+	FrameVector<vec2> selected_contacts;
 	for (size_t i = 0; i < std::min(sorted_contacts.size(), size_t(2)); i++) {
 		selected_contacts.push_back(sorted_contacts[i]);
 	}
@@ -135,7 +135,7 @@ void handle_rotational_dynamics(Entity& object_entity, Entity& other_entity, con
 
 // Handles collision between two PhysicsObject entities.
 // TODO, this method is long. should split up and document better
-void handle_physics_collision(float step_seconds, Entity& entityA, Entity& entityB, Collision& collision, std::vector<unsigned int>& grounded)
+void handle_physics_collision(float step_seconds, Entity& entityA, Entity& entityB, Collision& collision, FrameVector<unsigned int>& grounded)
 {
 	Motion& motionA = registry.motions.get(entityA);
 	Motion& motionB = registry.motions.get(entityB);
@@ -5,7 +5,7 @@
 #include "./physics_utils.h"
 
 void handle_rotational_dynamics(Entity& object_entity, Entity& other_entity, const vec2& collision_normal, float step_seconds);
-void handle_physics_collision(float step_seconds, Entity& entityA, Entity& entityB, Collision& collision, std::vector<unsigned int>& grounded);
+void handle_physics_collision(float step_seconds, Entity& entityA, Entity& entityB, Collision& collision, FrameVector<unsigned int>& grounded);
 void apply_air_resistance(Entity& entity, Motion& motion, float step_seconds);
 void apply_gravity(Entity& entity, Motion& motion, float step_seconds);
 void rotate_projectile(Entity& entity, Motion& motion, float step_seconds);
@@ -41,6 +41,10 @@ void PhysicsSystem::step(float elapsed_ms) {
 		Motion& motion = motion_registry.components[i];
 		Entity& entity = motion_registry.entities[i];
 
+		if (!is_active(entity)) {
+			continue;
+		}
+
 		// we handle the pendulum motion separately
 	if (registry.pendulums.has(entity)) {
 			continue;
@@ -111,7 +115,7 @@ void PhysicsSystem::step(float elapsed_ms) {
 
 	for (Entity entity : registry.motions.entities) {
 		Motion& motion = registry.motions.get(entity);
-		if (motion.cache_invalidated) {
+		if (motion.cache_invalidated && is_active(entity)) {
 			compute_vertices(motion, entity);
 			compute_axes(motion, motion.cached_vertices);
 			motion.cache_invalidated = false; // Reset flag
@@ -137,6 +141,8 @@ void PhysicsSystem::detect_collisions() {
 		// only check collsions between objects and platforms (no need for platform-platform collisions)
 		if (platform_container.has(entity_i)) continue;
 
+		if (!is_active(entity_i)) continue;
+
 		Motion& motion_i = registry.motions.get(entity_i);
 
 		// check between each object and each platform
@@ -167,7 +173,7 @@ void PhysicsSystem::detect_collisions() {
 void PhysicsSystem::handle_collisions(float elapsed_ms) {
 	ComponentContainer<Collision>& collision_container = registry.collisions;
 
-	std::vector<unsigned int> groundedEntities = {};
+	FrameVector<unsigned int> groundedEntities;
 	float step_seconds = elapsed_ms / 1000.0f;
 
 	bool player_ladder_collision = false;
@@ -178,6 +184,11 @@ void PhysicsSystem::handle_collisions(float elapsed_ms) {
 		Collision& collision = collision_container.components[i];
 		Entity other = Entity(collision.other_id);
 
+		// an earlier collision this step may have parked either entity
+		if (!is_active(one) || !is_active(other)) {
+			continue;
+		}
+
 		// do not collide with anything if no clip is on
 		bool no_clip = registry.flags.components[0].no_clip;
 		if (no_clip && (registry.players.has(one) || registry.players.has(other))) {
@@ -262,10 +273,10 @@ void PhysicsSystem::handle_collisions(float elapsed_ms) {
 
 	//		bolts break on spikes
 		if (registry.bolts.has(one) && registry.spikes.has(other)) {
-			registry.remove_all_components_of(one);
+			EntityPools::destroy(one);
 		}
 		if (registry.bolts.has(other) && registry.spikes.has(one)) {
-			registry.remove_all_components_of(other);
+			EntityPools::destroy(other);
 		}
 
 		if (registry.players.has(one) && registry.ladders.has(other)) {
@@ -290,7 +301,7 @@ void PhysicsSystem::handle_collisions(float elapsed_ms) {
 	for (int i = 0; i < registry.physicsObjects.entities.size(); i++){
 		Entity& entity = registry.physicsObjects.entities[i];
 
-		if(!in(groundedEntities, entity.id())) {
+		if(!in(groundedEntities, entity.id()) && is_active(entity)) {
 			registry.onGrounds.remove(entity);
 			Motion& motion = registry.motions.get(entity);
 			apply_air_resistance(entity, motion, step_seconds);
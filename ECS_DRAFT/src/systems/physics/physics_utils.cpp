@@ -70,7 +70,7 @@ float clampToTarget(float value, float change, float target) {
 }
 
 // Helper function to check if an entity id is within a vector.
-bool in(std::vector<unsigned int>& vec, unsigned int id) {
+bool in(FrameVector<unsigned int>& vec, unsigned int id) {
 	return std::find(vec.begin(), vec.end(), id) != vec.end();
 }
 
@@ -4,13 +4,15 @@
 #include "../../tinyECS/component_container.hpp"
 #include "../../tinyECS/components.hpp"
 #include "../../tinyECS/registry.hpp"
+#include "../../frame_arena.hpp"
+#include "../world/entity_pool.hpp"
 
 float lerp(float a, float b, float t);
 float calculate_moment_of_inertia(Entity& entity);
 vec2 closest_point_on_segment(const vec2& p, const vec2& a, const vec2& b);
 bool is_on_ground(float normal_y);
 float clampToTarget(float value, float change, float target);
-bool in(std::vector<unsigned int>& vec, unsigned int id);
+bool in(FrameVector<unsigned int>& vec, unsigned int id);
 bool is_collision_between_player_and_boundary(Entity& one, Entity& other);
 bool is_collision_between_player_and_spike(Entity& one, Entity& other);
 bool player_harmful_collision(Entity& one, Entity& other);
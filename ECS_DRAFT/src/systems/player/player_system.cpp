@@ -85,6 +85,7 @@ void PlayerSystem::generate_player_particles()
 
 		float rand_factor = rand_float();
 		if (rand_factor > rand_threshold) {
+			ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::PLAYER_TRAIL);
 			ParticleSystem::spawn_particle(vec3{ 0.35f, 0.35f, 0.35f },
 				random_sample_rectangle(registry.motions.get(player_entity).position + vec2{ 0.0f, PLAYER_SCALE.y * 0.35f }, { PLAYER_SCALE.x * 0.65f, 2.0f }),
 				0.0f, vec2{ 1.5f, 1.5f } *(1.0f + 0.25f * rand_factor), rand_direction() * 20.0f, 1000.0, 0.8f, { 50.0f, 200.0f });
@@ -131,6 +132,7 @@ void PlayerSystem::set_jumping_validity(bool can_jump) {
 		if (JUMPING_VALID_TIME_MS - player.jumping_valid_time > 25.0f) {
 			const int particles_count = 3 + (rand() % 3);
 			for (int i = 0; i < particles_count; i++) {
+				ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::PLAYER_FEEDBACK);
 				ParticleSystem::spawn_particle(PARTICLE_ID::COYOTE_PARTICLES,
 					random_sample_rectangle(registry.motions.get(player_entity).position + vec2{ 0.0f, PLAYER_SCALE.y * 0.35f }, { PLAYER_SCALE.x * 0.65f, 2.0f }),
 					0.0f, vec2(10.0f) * rand_float(1.0f, 1.25f), 
@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cstddef>
+
+#include "gpu_particle_backend.hpp"
+#include "render_system.hpp"
+
+namespace {
+	// Must follow the member order of GpuParticleVertex
+	const std::vector<const char*> FEEDBACK_VARYINGS = {
+		"out_motion", "out_spin", "out_lifetime", "out_envelope", "out_influence", "out_animation", "out_appearance",
+		"global_pos", "rotation", "scale", "color_info", "atlas_info"
+	};
+
+	const int STATE_ATTRIBUTE_COUNT = sizeof(GpuParticleState) / sizeof(vec4);
+
+	GLuint createFieldTexture()
+	{
+		GLuint texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, TURBULENCE_FIELD_RESOLUTION, TURBULENCE_FIELD_RESOLUTION, 0, GL_RED, GL_FLOAT, nullptr);
+		// bilinear and wrapping, like TurbulenceField::sample
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		return texture;
+	}
+}
+
+bool GpuParticleBackend::init(int capacity, GLuint sprite_vbo, GLuint sprite_ibo)
+{
+	static_assert(sizeof(GpuParticleState) == 7 * sizeof(vec4), "GpuParticleState must stay a list of vec4");
+	static_assert(sizeof(GpuParticleVertex) == sizeof(GpuParticleState) + sizeof(ParticleInstancedNode), "GpuParticleVertex must be packed");
+
+	if (!loadEffectFromFile(shader_path("particle_simulate") + ".vs.glsl", shader_path("particle_simulate") + ".fs.glsl",
+		program, FEEDBACK_VARYINGS)) {
+		program = 0;
+		return false;
+	}
+
+	this->capacity = capacity;
+	const GLsizei VERTEX_SIZE = sizeof(GpuParticleVertex);
+
+	glGenBuffers(2, buffers.data());
+	glGenVertexArrays(2, simulate_vaos.data());
+	glGenVertexArrays(2, draw_vaos.data());
+	for (int i = 0; i < 2; i++) {
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)capacity * VERTEX_SIZE, nullptr, GL_DYNAMIC_COPY);
+
+		// Simulation reads the state, one vertex per particle
+		glBindVertexArray(simulate_vaos[i]);
+		for (int attribute = 0; attribute < STATE_ATTRIBUTE_COUNT; attribute++) {
+			glEnableVertexAttribArray(attribute);
+			glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*)(attribute * sizeof(vec4)));
+		}
+
+		// Drawing instances the sprite quad over the node attributes, same locations as the CPU path
+		glBindVertexArray(draw_vaos[i]);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sprite_ibo);
+		glBindBuffer(GL_ARRAY_BUFFER, sprite_vbo);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)sizeof(vec3));
+
+		const size_t node = offsetof(GpuParticleVertex, node);
+		glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*)(node + offsetof(ParticleInstancedNode, global_pos)));
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*)(node + offsetof(ParticleInstancedNode, rotation)));
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*)(node + offsetof(ParticleInstancedNode, scale)));
+		glEnableVertexAttribArray(5);
+		glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*)(node + offsetof(ParticleInstancedNode, color_info)));
+		glEnableVertexAttribArray(6);
+		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, VERTEX_SIZE, (void*)(node + offsetof(ParticleInstancedNode, atlas_info)));
+		for (int attribute = 2; attribute <= 6; attribute++) {
+			glVertexAttribDivisor(attribute, 1);
+		}
+	}
+	glBindVertexArray(0);
+	gl_has_errors();
+
+	field_x_texture = createFieldTexture();
+	field_y_texture = createFieldTexture();
+	gl_has_errors();
+
+	clear();
+	return true;
+}
+
+void GpuParticleBackend::destroy()
+{
+	if (program == 0) {
+		return;
+	}
+	glDeleteProgram(program);
+	glDeleteBuffers(2, buffers.data());
+	glDeleteVertexArrays(2, simulate_vaos.data());
+	glDeleteVertexArrays(2, draw_vaos.data());
+	glDeleteTextures(1, &field_x_texture);
+	glDeleteTextures(1, &field_y_texture);
+	glDeleteTextures(1, &frame_table_texture);
+	program = 0;
+}
+
+void GpuParticleBackend::buildFrameTable(const TextureAtlas& atlas, const std::array<TEXTURE_ASSET_ID, particle_type_count>& textures)
+{
+	int max_frames = 1;
+	for (int id = 0; id < particle_type_count; id++) {
+		max_frames = std::max(max_frames, ParticleSystem::particle_type((PARTICLE_ID)id).frame_count);
+	}
+
+	// Row per particle type, two texels per frame: (u_min, u_max, layer, 0), (v_min, v_max, 0, 0)
+	const int width = 2 * max_frames;
+	std::vector<vec4> table(width * particle_type_count, vec4(0.f));
+	for (int id = 0; id < particle_type_count; id++) {
+		if (textures[id] == TEXTURE_ASSET_ID::TEXTURE_COUNT) {
+			continue;
+		}
+
+		const int frame_count = ParticleSystem::particle_type((PARTICLE_ID)id).frame_count;
+		for (int frame = 0; frame < frame_count; frame++) {
+			const float start_u_coord = (float)frame / (float)frame_count;
+			AtlasSample sample;
+			if (!atlas.lookup(textures[id], { start_u_coord, start_u_coord + 1.0f / frame_count }, sample)) {
+				fprintf(stderr, "GPU particles: frame %d of particle type %d is not in the atlas\n", frame, id);
+				continue;
+			}
+			table[id * width + 2 * frame] = vec4(sample.u_range, sample.layer, 0.f);
+			table[id * width + 2 * frame + 1] = vec4(sample.v_range, 0.f, 0.f);
+		}
+	}
+
+	if (frame_table_texture == 0) {
+		glGenTextures(1, &frame_table_texture);
+	}
+	glBindTexture(GL_TEXTURE_2D, frame_table_texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, width, particle_type_count, 0, GL_RGBA, GL_FLOAT, table.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	gl_has_errors();
+}
+
+void GpuParticleBackend::emit(const std::vector<GpuParticleSpawn>& spawns)
+{
+	if (spawns.empty()) {
+		return;
+	}
+
+	staging.resize(spawns.size());
+	for (size_t i = 0; i < spawns.size(); i++) {
+		const GpuParticleState& state = spawns[i].state;
+		staging[i].state = state;
+		staging[i].node = ParticleInstancedNode();
+		// time left, since the spawn may already have run part of its life
+		live_until_ms = std::max(live_until_ms, simulated_ms + state.lifetime.x - state.lifetime.y);
+	}
+
+	// Writes go in queue order, so a slot killed and reused in the same frame ends up with the spawn
+	const GLsizeiptr VERTEX_SIZE = sizeof(GpuParticleVertex);
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[source]);
+	size_t first = 0;
+	while (first < spawns.size()) {
+		size_t end = first + 1;
+		while (end < spawns.size() && spawns[end].slot == spawns[end - 1].slot + 1) {
+			end++;
+		}
+		const int slot = spawns[first].slot;
+		assert(slot >= 0 && slot + (int)(end - first) <= capacity);
+		glBufferSubData(GL_ARRAY_BUFFER, slot * VERTEX_SIZE, (GLsizeiptr)(end - first) * VERTEX_SIZE, staging.data() + first);
+		active_count = std::max(active_count, slot + (int)(end - first));
+		first = end;
+	}
+	gl_has_errors();
+}
+
+void GpuParticleBackend::clear()
+{
+	active_count = 0;
+	live_until_ms = simulated_ms;
+}
+
+void GpuParticleBackend::simulate(const ParticleStepParams& params)
+{
+	// Everything in the ring has expired; start over from the front
+	if (simulated_ms > live_until_ms) {
+		clear();
+	}
+	simulated_ms += params.time_change_s * 1000.0f;
+
+	if (active_count <= 0) {
+		return;
+	}
+
+	glUseProgram(program);
+	glUniform1f(glGetUniformLocation(program, "time_change_s"), params.time_change_s);
+	glUniform1f(glGetUniformLocation(program, "animation_elapsed_ms"), params.animation_elapsed_ms);
+	glUniform1i(glGetUniformLocation(program, "cull_by_camera"), params.cull_by_camera);
+	glUniform2fv(glGetUniformLocation(program, "camera_position"), 1, (float*)&params.camera_position);
+	glUniform2fv(glGetUniformLocation(program, "wind_field"), 1, (float*)&params.wind_field);
+	glUniform2fv(glGetUniformLocation(program, "gravity_field"), 1, (float*)&params.gravity_field);
+	glUniform1i(glGetUniformLocation(program, "turbulence_enabled"), params.field != nullptr);
+	glUniform1f(glGetUniformLocation(program, "turbulence_strength"), params.turbulence_strength);
+	glUniform1f(glGetUniformLocation(program, "field_cells_per_pixel"), params.field_cells_per_pixel);
+	gl_has_errors();
+
+	// The field changes a row per step; re-sending both components whole is 128 KB
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, field_x_texture);
+	if (params.field != nullptr) {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TURBULENCE_FIELD_RESOLUTION, TURBULENCE_FIELD_RESOLUTION, GL_RED, GL_FLOAT, params.field->direction_x());
+	}
+	glUniform1i(glGetUniformLocation(program, "field_x"), 0);
+
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, field_y_texture);
+	if (params.field != nullptr) {
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, TURBULENCE_FIELD_RESOLUTION, TURBULENCE_FIELD_RESOLUTION, GL_RED, GL_FLOAT, params.field->direction_y());
+	}
+	glUniform1i(glGetUniformLocation(program, "field_y"), 1);
+
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_2D, frame_table_texture);
+	glUniform1i(glGetUniformLocation(program, "frame_table"), 2);
+	glActiveTexture(GL_TEXTURE0);
+	gl_has_errors();
+
+	// Ping-pong: read the current buffer, capture into the other
+	const int target = 1 - source;
+	glBindVertexArray(simulate_vaos[source]);
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, buffers[target]);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, active_count);
+	glEndTransformFeedback();
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glDisable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(0);
+	gl_has_errors();
+
+	source = target;
+}
+
+void GpuParticleBackend::draw() const
+{
+	if (active_count <= 0) {
+		return;
+	}
+
+	glBindVertexArray(draw_vaos[source]);
+	// 6 indices for sprite
+	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0, active_count);
+	glBindVertexArray(0);
+	gl_has_errors();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "../../common.hpp"
+#include "../../tinyECS/components.hpp"
+#include "systems/particle/particle_system.hpp"
+#include "texture_atlas.hpp"
+
+// Per-instance attributes of a particle, streamed into the particle instance ring by the CPU
+// path and written by the simulation pass on the GPU path
+struct ParticleInstancedNode {
+	vec2 global_pos;
+	float rotation;
+	vec2 scale;
+	vec4 color_info;
+	vec4 atlas_info;
+};
+
+// One slot of the GPU particle buffers, in transform feedback output order
+struct GpuParticleVertex {
+	GpuParticleState state;
+	ParticleInstancedNode node;
+};
+
+// Optional particle simulation on the GPU. Particles live in two vertex buffers that a transform
+// feedback pass ping-pongs between; each pass also writes the instance attributes of
+// particle_instanced, so the buffer just written is drawn as is. Spawns go to the ring slots the
+// particle system assigned them, which also keeps the budget; nothing is read back.
+class GpuParticleBackend {
+public:
+	// False if the simulation program cannot be built; the caller keeps the CPU path
+	bool init(int capacity, GLuint sprite_vbo, GLuint sprite_ibo);
+	void destroy();
+	bool isReady() const { return program != 0; }
+
+	// Atlas placement of every frame of every textured particle type
+	void buildFrameTable(const TextureAtlas& atlas, const std::array<TEXTURE_ASSET_ID, particle_type_count>& textures);
+
+	// Writes the spawns into their slots, one upload per run of consecutive slots
+	void emit(const std::vector<GpuParticleSpawn>& spawns);
+	void clear();
+
+	// Advances every slot that may still hold a live particle by one particle step
+	void simulate(const ParticleStepParams& params);
+	// Draws the latest state; expects particle_instanced in use with the atlas bound
+	void draw() const;
+
+	int activeCount() const { return active_count; }
+
+private:
+	GLuint program = 0;
+	std::array<GLuint, 2> buffers = {};
+	std::array<GLuint, 2> simulate_vaos = {};
+	std::array<GLuint, 2> draw_vaos = {};
+	GLuint field_x_texture = 0;
+	GLuint field_y_texture = 0;
+	GLuint frame_table_texture = 0;
+
+	int capacity = 0;
+	int source = 0;			// buffer holding the current state
+	int active_count = 0;	// slots [0, active_count) may hold live particles
+
+	// Simulated time against the expiry of the longest lived spawn, so an idle ring is not
+	// simulated forever
+	double simulated_ms = 0.0;
+	double live_until_ms = 0.0;
+
+	std::vector<GpuParticleVertex> staging;
+};
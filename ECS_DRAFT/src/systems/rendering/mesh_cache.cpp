@@ -0,0 +1,118 @@
+#include <cstring>
+#include <filesystem>
+
+#include "mesh_cache.hpp"
+
+namespace {
+	const char COOKED_MESH_MAGIC[4] = { 'M', 'E', 'S', 'H' };
+	const uint32_t COOKED_MESH_VERSION = 1;
+}
+
+std::string MeshCache::cookedPath(const std::string& source_path)
+{
+	// flatten the path below the project root into a single file name
+	std::string name = source_path;
+	const std::string root = PROJECT_SOURCE_DIR;
+	if (name.compare(0, root.size(), root) == 0) {
+		name = name.substr(root.size());
+	}
+	for (char& c : name) {
+		if (!isalnum((unsigned char)c)) {
+			c = '_';
+		}
+	}
+	return cooked_path(name + ".mesh");
+}
+
+bool MeshCache::load(const std::string& source_path, Mesh& mesh)
+{
+	MappedFile source;
+	if (!source.open(source_path)) {
+		fprintf(stderr, "Could not open mesh %s\n", source_path.c_str());
+		return false;
+	}
+
+	const uint64_t source_hash = content_hash(source.data(), source.size());
+	if (loadCooked(source_path, source_hash, mesh)) {
+		return true;
+	}
+
+	printf("Cooking OBJ file %s...\n", source_path.c_str());
+	mesh.vertices.clear();
+	mesh.vertex_indices.clear();
+	if (!Mesh::loadFromOBJData((const char*)source.data(), source.size(), mesh.vertices, mesh.vertex_indices, mesh.original_size)) {
+		fprintf(stderr, "Could not read mesh %s\n", source_path.c_str());
+		return false;
+	}
+	if (!store(source_path, source_hash, mesh)) {
+		fprintf(stderr, "Could not cook %s\n", source_path.c_str());
+	}
+	return true;
+}
+
+bool MeshCache::loadCooked(const std::string& source_path, uint64_t source_hash, Mesh& mesh)
+{
+	MappedFile cooked;
+	if (!cooked.open(cookedPath(source_path))) {
+		return false;
+	}
+
+	CookedMeshHeader header;
+	if (cooked.size() < sizeof(header)) {
+		return false;
+	}
+	memcpy(&header, cooked.data(), sizeof(header));
+	const size_t vertex_bytes = (size_t)header.vertex_count * sizeof(ColoredVertex);
+	const size_t index_bytes = (size_t)header.index_count * sizeof(uint16_t);
+	if (memcmp(header.magic, COOKED_MESH_MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != COOKED_MESH_VERSION ||
+		header.source_hash != source_hash ||
+		cooked.size() != sizeof(header) + vertex_bytes + index_bytes) {
+		return false;
+	}
+
+	const unsigned char* vertices = cooked.data() + sizeof(header);
+	mesh.original_size = header.original_size;
+	mesh.vertices.resize(header.vertex_count);
+	memcpy(mesh.vertices.data(), vertices, vertex_bytes);
+	mesh.vertex_indices.resize(header.index_count);
+	memcpy(mesh.vertex_indices.data(), vertices + vertex_bytes, index_bytes);
+	return true;
+}
+
+bool MeshCache::store(const std::string& source_path, uint64_t source_hash, const Mesh& mesh)
+{
+	const std::string path = cookedPath(source_path);
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+	CookedMeshHeader header;
+	memcpy(header.magic, COOKED_MESH_MAGIC, sizeof(header.magic));
+	header.version = COOKED_MESH_VERSION;
+	header.source_hash = source_hash;
+	header.original_size = mesh.original_size;
+	header.vertex_count = (uint32_t)mesh.vertices.size();
+	header.index_count = (uint32_t)mesh.vertex_indices.size();
+
+	// write to a temporary name first so a concurrent reader never maps a half-written file
+	const std::string file_path = temporary_path(path);
+	std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)mesh.vertices.data(), (std::streamsize)(mesh.vertices.size() * sizeof(ColoredVertex)));
+	file.write((const char*)mesh.vertex_indices.data(), (std::streamsize)(mesh.vertex_indices.size() * sizeof(uint16_t)));
+	file.close();
+	if (!file) {
+		std::filesystem::remove(file_path, error);
+		return false;
+	}
+
+	std::filesystem::rename(file_path, path, error);
+	if (error) {
+		std::filesystem::remove(file_path, error);
+		return false;
+	}
+	return true;
+}
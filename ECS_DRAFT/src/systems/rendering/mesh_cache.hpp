@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "../../common.hpp"
+#include "../../mapped_file.hpp"
+#include "../../tinyECS/components.hpp"
+
+// File layout: header, then vertex_count ColoredVertex entries, then index_count uint16_t indices
+struct CookedMeshHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t source_hash;
+	vec2 original_size;
+	uint32_t vertex_count;
+	uint32_t index_count;
+};
+
+// Loaded copies of the OBJ meshes, written through cooked_path() to the per-user cache directory
+// alongside the cooked textures. A cooked file holds the vertices and indices as the OBJ loader
+// leaves them (normalized, y and z swapped for flat meshes), so a mesh is only parsed once per
+// change of its source.
+class MeshCache {
+public:
+	static std::string cookedPath(const std::string& source_path);
+
+	// Fills mesh from the cooked copy of source_path, cooking it from the OBJ first when the copy is
+	// missing or out of date
+	static bool load(const std::string& source_path, Mesh& mesh);
+
+private:
+	static bool loadCooked(const std::string& source_path, uint64_t source_hash, Mesh& mesh);
+	static bool store(const std::string& source_path, uint64_t source_hash, const Mesh& mesh);
+};
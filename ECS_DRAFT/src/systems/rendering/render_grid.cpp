@@ -0,0 +1,37 @@
+#include "render_grid.hpp"
+
+void RenderGrid::clear() {
+	cells.clear();
+	count = 0;
+}
+
+ivec2 RenderGrid::cellOf(vec2 position) const {
+	return ivec2(floor(position.x / cell_size), floor(position.y / cell_size));
+}
+
+void RenderGrid::insert(unsigned int index, const RenderBounds& bounds) {
+	const ivec2 lo = cellOf(bounds.min);
+	const ivec2 hi = cellOf(bounds.max);
+
+	for (int y = lo.y; y <= hi.y; y++) {
+		for (int x = lo.x; x <= hi.x; x++) {
+			cells[cellKey(x, y)].push_back(index);
+		}
+	}
+	count++;
+}
+
+void RenderGrid::query(const RenderBounds& bounds, FrameVector<unsigned int>& out) const {
+	const ivec2 lo = cellOf(bounds.min);
+	const ivec2 hi = cellOf(bounds.max);
+
+	for (int y = lo.y; y <= hi.y; y++) {
+		for (int x = lo.x; x <= hi.x; x++) {
+			auto it = cells.find(cellKey(x, y));
+			if (it == cells.end()) {
+				continue;
+			}
+			out.insert(out.end(), it->second.begin(), it->second.end());
+		}
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "../../common.hpp"
+#include "../../frame_arena.hpp"
+
+// Axis-aligned bounds in world pixels
+struct RenderBounds {
+	vec2 min = { 0.f, 0.f };
+	vec2 max = { 0.f, 0.f };
+
+	bool overlaps(const RenderBounds& other) const {
+		return min.x <= other.max.x && max.x >= other.min.x &&
+			min.y <= other.max.y && max.y >= other.min.y;
+	}
+};
+
+// Placement of a gridded tile's parent when the grid was built; any later change to it
+// (physics pushes, gears, level edits) means the cells of its tiles are stale
+struct RenderGridAnchor {
+	unsigned int parent_id = 0;
+	vec2 position = { 0.f, 0.f };
+	vec2 scale = { 0.f, 0.f };
+};
+
+// Uniform grid over render bounds, used to cull static render entities against the camera view.
+// Stores arbitrary indices (the render system uses the index into registry.layers)
+class RenderGrid {
+public:
+	RenderGrid(float cell_size = RENDER_GRID_CELL_SIZE) : cell_size(cell_size) {}
+
+	void clear();
+	void insert(unsigned int index, const RenderBounds& bounds);
+
+	// Appends every index whose cells intersect the query; an index spanning several cells
+	// may be appended more than once
+	void query(const RenderBounds& bounds, FrameVector<unsigned int>& out) const;
+
+	size_t size() const { return count; }
+
+private:
+	float cell_size;
+	size_t count = 0;
+	std::unordered_map<long long, std::vector<unsigned int>> cells;
+
+	ivec2 cellOf(vec2 position) const;
+	static long long cellKey(int x, int y) { return (long long)(((unsigned long long)(unsigned int)x << 32) | (unsigned int)y); }
+};
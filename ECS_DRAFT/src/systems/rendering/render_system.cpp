@@ -63,6 +63,10 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 	gl_has_errors();
 
 
+	// Sprites sample the atlas when their texture was packed into it
+	AtlasSample atlas_sample;
+	bool sampled_from_atlas = false;
+
 	// texture-mapped entities - use data location as in the vertex buffer
 	if (render_request.used_effect == EFFECT_ASSET_ID::TEXTURED ||
 		render_request.used_effect == EFFECT_ASSET_ID::FILL)
@@ -83,15 +87,25 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 			(void*)sizeof(
 				vec3)); // note the stride to skip the preceeding vertex position
 
-		// Enabling and binding texture to slot 0
+		vec2 tex_u_range;
+		setURange(entity, tex_u_range);
+		atlas_sample.u_range = tex_u_range;
+		sampled_from_atlas = texture_atlas.lookup(render_request.used_texture, tex_u_range, atlas_sample);
+		assert(sampled_from_atlas || texture_atlas.needsStandalone(render_request.used_texture));
+
+		// Standalone texture in slot 0, atlas in slot 1
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, sampled_from_atlas ? 0 : texture_gl_handles[(GLuint)render_request.used_texture]);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, texture_atlas.handle());
 		glActiveTexture(GL_TEXTURE0);
 		gl_has_errors();
 
-		assert(registry.renderRequests.has(entity));
-		GLuint texture_id =
-			texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
-
-		glBindTexture(GL_TEXTURE_2D, texture_id);
+		glUniform1i(glGetUniformLocation(program, "sampler0"), 0);
+		glUniform1i(glGetUniformLocation(program, "atlas"), 1);
+		glUniform1f(glGetUniformLocation(program, "atlas_layer"), sampled_from_atlas ? atlas_sample.layer : -1.0f);
+		glUniform2fv(glGetUniformLocation(program, "tex_v_range"), 1, (float*)&atlas_sample.v_range);
+		glUniform4fv(glGetUniformLocation(program, "uv_bounds"), 1, (float*)&atlas_sample.bounds);
 		gl_has_errors();
 
 		if (render_request.used_effect == EFFECT_ASSET_ID::TEXTURED) {
@@ -265,13 +279,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
 	// Setting uniform values to the currently bound program
 	GLint depth_uloc = glGetUniformLocation(program, "depth");
-	LAYER_ID layer = registry.layers.get(entity).layer;
-	float depth = (
-		layer == LAYER_ID::PARALLAXBACKGROUND ? PARALLAXBACKGROUND_DEPTH : (
-			layer == LAYER_ID::BACKGROUND ? BACKGROUND_DEPTH : (
-				layer == LAYER_ID::MIDGROUND ? MIDGROUND_DEPTH : (
-					layer == LAYER_ID::MENU_AND_PAUSE ? MIDGROUND_DEPTH : (
-						layer == LAYER_ID::CUTSCENE ? STANDARD_DEPTH : FOREGROUND_DEPTH)))));
+	float depth = getLayerDepth(registry.layers.get(entity).layer);
 	glUniform1fv(depth_uloc, 1, (float*)&depth);
 	gl_has_errors();
 
@@ -282,6 +290,9 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 		vec2 tex_u_range;
 
 		setURange(entity, tex_u_range);
+		if (sampled_from_atlas) {
+			tex_u_range = atlas_sample.u_range;
+		}
 
 		glUniform2fv(tex_u_range_loc, 1, (float*)&tex_u_range);
 		gl_has_errors();
@@ -502,7 +513,20 @@ void RenderSystem::updateAccelerationFactor(GameState& gameState, ScreenState& s
 }
 
 void RenderSystem::late_step(float elapsed_ms) {
+	// only the menu may run with textures still streaming in
+	const bool in_menu = registry.gameStates.components.empty() ||
+		registry.gameStates.components[0].game_running_state == GAME_RUNNING_STATE::MENU;
+	streamTextures(!in_menu);
+
+	// a minimized window reports a zero framebuffer; keep the old targets until it comes back
+	ivec2 framebuffer_size;
+	glfwGetFramebufferSize(window, &framebuffer_size.x, &framebuffer_size.y);
+	if (framebuffer_size != screen_texture_size && framebuffer_size.x > 0 && framebuffer_size.y > 0) {
+		resizeScreenTextures(framebuffer_size);
+	}
+
 	this->projection_matrix = createProjectionMatrix();
+	updateViewBounds();
 	draw();
 };
 
@@ -528,34 +552,32 @@ void RenderSystem::draw()
 
 	// Assort rendering tasks according to layers
 
-	std::vector<Entity> parallaxbackgrounds;
+	FrameVector<Entity> parallaxbackgrounds;
 
-	std::vector<Entity> backgrounds;
+	FrameVector<Entity> backgrounds;
 
-	std::vector<Entity> midgrounds;
+	FrameVector<Entity> midgrounds;
 
-	std::vector<Entity> foregrounds;
+	FrameVector<Entity> foregrounds;
 
-	std::vector<Entity> menu_and_pause;
+	FrameVector<Entity> menu_and_pause;
 
-	std::vector<Entity> cutscenes;
+	FrameVector<Entity> cutscenes;
 
-	for (Entity entity : registry.layers.entities)
+	// Only entities overlapping the camera view are drawn
+	FrameVector<unsigned int> visible_indices;
+	collectVisibleRenderIndices(visible_indices);
+
+	for (unsigned int index : visible_indices)
 	{
+		Entity entity = registry.layers.entities[index];
+
 		// Check for rendering necessity
 		if (!registry.renderRequests.has(entity) || (!registry.motions.has(entity) && !registry.tiles.has(entity)))
 			continue;
 
-		// TODO: this could be somewhere else, but idk how to get the mesh pointer without increased system coupling...
-		// Keep track of pointer to any custom mesh in the registry for use in other systems
-		if (!registry.meshPtrs.has(entity)) {
-			RenderRequest request = registry.renderRequests.get(entity);
-			if (request.used_geometry == GEOMETRY_BUFFER_ID::HEX || 
-				request.used_geometry == GEOMETRY_BUFFER_ID::OCTA) {
-				Mesh& mesh = getMesh(request.used_geometry);
-				registry.meshPtrs.emplace(entity, &mesh);
-			}
-		}
+		if (registry.inactives.has(entity))
+			continue;
 
 		switch (registry.layers.get(entity).layer)
 		{
@@ -588,10 +610,7 @@ void RenderSystem::draw()
 
 	glBindVertexArray(vao_general);
 
-	// Render Halo
-	bindFrameBuffer(FRAME_BUFFER_ID::BLUR_BUFFER_1);
-
-	std::vector<Entity> halo_entities;
+	FrameVector<Entity> halo_entities;
 	if (registry.bosses.size() > 0) {
 		halo_entities.push_back(registry.bosses.entities[0]);
 	}
@@ -608,30 +627,33 @@ void RenderSystem::draw()
 		halo_entities.push_back(registry.decelerationBars.entities[0]);
 	}
 
-	for (const Entity halo_entity : halo_entities) {
-		drawFilledMesh(halo_entity, this->projection_matrix);
-	}
-
-	// Prepare halo effect
-	for (int i = 6; i >= 0; i--) {
-		// Pass-catch
-
-		// Render to blur 2
-		bindFrameBuffer(FRAME_BUFFER_ID::BLUR_BUFFER_2);
-		drawBlurredLayer(blur_buffer_color_1, BLUR_MODE::HORIZONTAL, 1.75f, 1.45f);
-
-		// Render to blur 1
+	// Render Halo to blur 1, then blur it down the pyramid; skipped when nothing feeding it changed
+	size_t halo_signature = 0;
+	const bool halo_signed = computeBlurSignature(halo_entities, halo_signature);
+	if (!halo_signed || !halo_blur_valid || halo_signature != halo_blur_signature) {
 		bindFrameBuffer(FRAME_BUFFER_ID::BLUR_BUFFER_1);
-		drawBlurredLayer(blur_buffer_color_2, BLUR_MODE::VERTICAL, 1.75f, 1.45f);
+		for (const Entity halo_entity : halo_entities) {
+			drawFilledMesh(halo_entity, this->projection_matrix);
+		}
+		drawDualFilterBlur(blur_buffer_color_1, halo_pyramid, 1.45f);
+
+		halo_blur_signature = halo_signature;
+		halo_blur_valid = halo_signed;
 	}
 
-	// Halo effects in blur 1
+	// Render foreground to blur 2, same caching as the halo
+	size_t foreground_signature = 0;
+	const bool foreground_signed = computeBlurSignature(foregrounds, foreground_signature);
+	if (!foreground_signed || !foreground_blur_valid || foreground_signature != foreground_blur_signature) {
+		bindFrameBuffer(FRAME_BUFFER_ID::BLUR_BUFFER_2);
+		for (Entity entity : foregrounds)
+		{
+			drawTexturedMesh(entity, this->projection_matrix);
+		}
+		drawDualFilterBlur(blur_buffer_color_2, foreground_pyramid, 1.0f);
 
-	// Render foreground to blur 2
-	bindFrameBuffer(FRAME_BUFFER_ID::BLUR_BUFFER_2);
-	for (Entity entity : foregrounds)
-	{
-		drawTexturedMesh(entity, this->projection_matrix);
+		foreground_blur_signature = foreground_signature;
+		foreground_blur_valid = foreground_signed;
 	}
 
 	// Start rendering to intermediate buffer
@@ -655,7 +677,7 @@ void RenderSystem::draw()
 		drawTexturedMesh(entity, this->projection_matrix);
 	}
 
-	drawBlurredLayer(blur_buffer_color_1, BLUR_MODE::TWO_D, 1.5f, 1.2f);
+	drawBlurredLayer(halo_pyramid.color_textures[0], BLUR_MODE::KAWASE_UP, KAWASE_BLUR_OFFSET, 1.2f);
 
 	for (Entity entity : halo_entities)
 	{
@@ -665,13 +687,14 @@ void RenderSystem::draw()
 
 	glBindVertexArray(vao_particles);
 	// Potentially aim for multi-layers
-	instancedRenderParticles(registry.particles.entities, MIDGROUND_DEPTH);
+	instancedRenderParticles(MIDGROUND_DEPTH);
+	renderGpuParticles(MIDGROUND_DEPTH);
 
 	glBindVertexArray(0);
 
 	glBindVertexArray(vao_general);
 	// Render foreground
-	drawBlurredLayer(blur_buffer_color_2, BLUR_MODE::TWO_D, 1.5f, 1.2f);
+	drawBlurredLayer(foreground_pyramid.color_textures[0], BLUR_MODE::KAWASE_UP, KAWASE_BLUR_OFFSET, 1.2f);
 
 	// draw menus over everything else
 	for (Entity entity : menu_and_pause) {
@@ -736,4 +759,23 @@ mat3 RenderSystem::createProjectionMatrix()
 		{0.f,  sy, 0.f},
 		{ tx,  ty, 1.f}
 	};
+}
+void RenderSystem::updateViewBounds()
+{
+	if (registry.cameras.entities.size() < 1) {
+		view_center = { WINDOW_WIDTH_PX / 2.0f, WINDOW_HEIGHT_PX / 2.0f };
+		view_half_extents = { WINDOW_WIDTH_PX / 2.0f, WINDOW_HEIGHT_PX / 2.0f };
+		return;
+	}
+
+	const Motion& camera_motion = registry.motions.get(registry.cameras.entities[0]);
+	view_center = camera_motion.position;
+	view_half_extents = CameraSystem::get_camera_offsets(camera_motion.scale);
+}
+
+// The vertex shaders write depth to w, so a layer at depth d sees d times the camera extents
+RenderBounds RenderSystem::getViewBounds(float depth) const
+{
+	const vec2 half_extents = view_half_extents * depth + vec2(RENDER_CULLING_MARGIN);
+	return { view_center - half_extents, view_center + half_extents };
 }
\ No newline at end of file
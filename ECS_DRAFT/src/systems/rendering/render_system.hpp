@@ -1,15 +1,30 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <unordered_set>
 #include <utility>
 #include <glm/trigonometric.hpp>
 
 #include "../../common.hpp"
 #include "../../tinyECS/components.hpp"
 #include "../../tinyECS/component_container.hpp"
+#include "../../frame_arena.hpp"
 #include "systems/ISystem.hpp"
 
 #include "systems/camera/camera_system.hpp"
+#include "systems/particle/particle_system.hpp"
+#include "gpu_particle_backend.hpp"
+#include "render_grid.hpp"
+#include "texture_atlas.hpp"
+#include "texture_loader.hpp"
+
+// Downsampled render targets for the dual filter blur; level i is 1/2^(i+1) of the blur buffer
+struct BlurPyramid {
+	std::vector<GLuint> frame_buffers;
+	std::vector<GLuint> color_textures;
+	std::vector<ivec2> sizes;
+};
 
 // System responsible for setting up OpenGL and for rendering all the
 // visual entities in the game
@@ -179,6 +194,56 @@ class RenderSystem : public ISystem {
 
 	};
 
+	// Textures sampled by effects that do not read the atlas (tile, hex, matte, screen)
+	const std::vector<TEXTURE_ASSET_ID> standalone_textures = {
+		TEXTURE_ASSET_ID::TILE,
+		TEXTURE_ASSET_ID::HEX,
+		TEXTURE_ASSET_ID::BOLT2,
+		TEXTURE_ASSET_ID::BOLT3,
+		TEXTURE_ASSET_ID::BREAKABLE,
+		TEXTURE_ASSET_ID::LOADING_SCREEN,
+	};
+
+	// Sprite sheet of each particle type, indexed by PARTICLE_ID (COLORED has none)
+	const std::array<TEXTURE_ASSET_ID, particle_type_count> particle_textures = {
+		TEXTURE_ASSET_ID::TEXTURE_COUNT,
+		TEXTURE_ASSET_ID::GREY_CIRCLE,
+		TEXTURE_ASSET_ID::BREAKABLE_FRAGMENTS,
+		TEXTURE_ASSET_ID::COYOTE_PARTICLES,
+		TEXTURE_ASSET_ID::SCREW_FRAGMENTS,
+		TEXTURE_ASSET_ID::HEX_FRAGMENTS,
+		TEXTURE_ASSET_ID::CRACKING_RADIAL,
+		TEXTURE_ASSET_ID::CRACKING_DOWNWARD,
+		TEXTURE_ASSET_ID::EXHALE,
+		TEXTURE_ASSET_ID::BROKEN_PARTS,
+		TEXTURE_ASSET_ID::CROSS_STAR,
+	};
+
+	TextureAtlas texture_atlas;
+
+	// Decoded and uploaded before init returns so the menu can show; the rest streams in afterwards
+	const std::vector<TEXTURE_ASSET_ID> startup_textures = {
+		TEXTURE_ASSET_ID::LOADING_SCREEN,
+		TEXTURE_ASSET_ID::SCREEN,
+		TEXTURE_ASSET_ID::KEY,
+		TEXTURE_ASSET_ID::COVER,
+		TEXTURE_ASSET_ID::START_SELECTED,
+		TEXTURE_ASSET_ID::EXIT_SELECTED,
+		TEXTURE_ASSET_ID::MENU,
+		TEXTURE_ASSET_ID::MENU_SELECTED,
+		TEXTURE_ASSET_ID::RESUME,
+		TEXTURE_ASSET_ID::RESUME_SELECTED,
+		TEXTURE_ASSET_ID::FADE,
+	};
+
+	TextureLoader texture_loader;
+	bool textures_resident = false;
+	int textures_uploaded = 0;
+	std::array<float, texture_count> texture_decode_ms;
+	std::array<float, texture_count> texture_upload_ms;
+	std::array<bool, texture_count> texture_cooked;
+	std::chrono::high_resolution_clock::time_point texture_load_start;
+
 	std::array<GLuint, effect_count> effects;
 
 	// Make sure these paths remain in sync with the associated enumerators.
@@ -210,6 +275,10 @@ public:
 	void initializeVAOs();
 
 	void initializeGlTextures();
+	void uploadDecodedTexture(DecodedTexture& decoded);
+
+	// Uploads textures decoded since the last call, or blocks until all are resident if finish is set
+	void streamTextures(bool finish);
 
 	void initializeGlEffects();
 
@@ -223,6 +292,9 @@ public:
 	// The draw loop first renders to this texture, then it is used for the screen shader
 	bool initScreenTexture();
 
+	// Reallocate the intermediate and blur targets once the framebuffer no longer matches them
+	void resizeScreenTextures(ivec2 framebuffer_size);
+
 	// Destroy resources associated to one or all entities created by the system
 	~RenderSystem();
 
@@ -231,6 +303,10 @@ public:
 
 	mat3 createProjectionMatrix();
 
+	// Camera view in world pixels, kept in sync with the projection matrix
+	void updateViewBounds();
+	RenderBounds getViewBounds(float depth) const;
+
 	Entity get_screen_state_entity() { return screen_state_entity; }
 
 	// Approximate Gaussian blur kernel
@@ -252,6 +328,13 @@ private:
 	void drawFilledMesh(Entity entity, const mat3& projection);
 
 	void drawBlurredLayer(GLuint source_texture, BLUR_MODE mode, float width_factor, float strength);
+	void drawDualFilterBlur(GLuint source_texture, const BlurPyramid& pyramid, float strength);
+	void initBlurPyramid(BlurPyramid& pyramid, int levels, ivec2 base_size);
+	void deleteBlurPyramid(BlurPyramid& pyramid);
+
+	// Hash of everything feeding a blur buffer, so unchanged frames can reuse last frame's blur;
+	// false when no signature can be taken and the blur has to be redrawn
+	bool computeBlurSignature(const FrameVector<Entity>& entities, size_t& signature);
 	void drawToScreen();
 
 	GLuint useShader(EFFECT_ASSET_ID shader_id);
@@ -264,10 +347,20 @@ private:
 	void updateAccelerationFactor(GameState& gameState, ScreenState& screen, float elapsed_ms);
 
 	// Helpers for setting up shader parameters
-	void instancedRenderParticles(const std::vector<Entity>& particles, float depth);
+	void instancedRenderParticles(float depth);
+	// Hands queued spawns to the GPU backend, runs its simulation pass and draws the result
+	void renderGpuParticles(float depth);
 	//void setupTextured(const std::vector<Entity>& entities, GLuint program);
 	//void setupTile(const std::vector<Entity>& entities, GLuint program);
 
+	// View culling
+	static float getLayerDepth(LAYER_ID layer);
+	bool getRenderBounds(Entity entity, RenderBounds& bounds) const;
+	bool isStaticRenderEntity(Entity entity) const;
+	bool renderGridAnchorsMoved();
+	void refreshRenderGrid();
+	void collectVisibleRenderIndices(FrameVector<unsigned int>& visible_indices);
+
 	void setTransform(Entity entity, glm::mat3& transform);
 	void setFColor(Entity entity, vec3& fcolor);
 	void setURange(Entity entity, vec2 &uRange);
@@ -289,16 +382,52 @@ private:
 	GLuint blur_buffer_color_2;
 	GLuint blur_buffer_depth_2;
 
+	BlurPyramid halo_pyramid;
+	BlurPyramid foreground_pyramid;
+
+	// framebuffer size the screen and blur targets were allocated for
+	ivec2 screen_texture_size = { 0, 0 };
+
+	bool halo_blur_valid = false;
+	bool foreground_blur_valid = false;
+	size_t halo_blur_signature = 0;
+	size_t foreground_blur_signature = 0;
+
 	// This may not be a good practice; buffers for instanced rendering
 	//GLuint instanced_vbo_static_tiles;
 	GLuint vao_particles;
 	GLuint vao_general;
+	// Ring of PARTICLE_INSTANCE_RING_SEGMENTS segments, each large enough for every particle; a
+	// segment is only rewritten once the fence of the frame that last drew from it has signalled
 	GLuint instanced_vbo_particles;
+	std::array<GLsync, PARTICLE_INSTANCE_RING_SEGMENTS> particle_ring_fences = {};
+	int particle_ring_segment = 0;
+
+	// Only initialized when the particle system runs with GPU simulation
+	GpuParticleBackend gpu_particles;
+	std::vector<GpuParticleSpawn> gpu_particle_spawns;
 
 	Entity screen_state_entity;
 
 	mat3 projection_matrix;
+
+	vec2 view_center = { WINDOW_WIDTH_PX / 2.0f, WINDOW_HEIGHT_PX / 2.0f };
+	vec2 view_half_extents = { WINDOW_WIDTH_PX / 2.0f, WINDOW_HEIGHT_PX / 2.0f };
+
+	// Static tiles are indexed by their position in registry.layers; the grid is rebuilt
+	// whenever the layered entity set changes or one of the anchored parents moved
+	RenderGrid static_render_grid;
+	std::vector<RenderBounds> static_render_bounds;
+	std::vector<RenderGridAnchor> render_grid_anchors;
+	// parents seen moving after the grid was built; their tiles are culled per frame from then on
+	std::unordered_set<unsigned int> render_grid_moving_parents;
+	std::vector<unsigned int> dynamic_render_indices;
+	float static_render_max_depth = STANDARD_DEPTH;
+	size_t render_grid_layer_count = 0;
+	unsigned int render_grid_last_entity = 0;
 };
 
+// feedback_varyings, when given, are captured interleaved through transform feedback
 bool loadEffectFromFile(
-	const std::string& vs_path, const std::string& fs_path, GLuint& out_program);
+	const std::string& vs_path, const std::string& fs_path, GLuint& out_program,
+	const std::vector<const char*>& feedback_varyings = {});
@@ -3,11 +3,16 @@
 #include <sstream>
 #include <array>
 #include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 // internal
 #include "../../../ext/stb_image/stb_image.h"
 #include "render_system.hpp"
+#include "mesh_cache.hpp"
 #include "../../tinyECS/registry.hpp"
+#include "systems/animation/animation_system.hpp"
 
 
 // Render initialization
@@ -40,6 +45,8 @@ void RenderSystem::init(GLFWwindow* window_arg)
 
 	glGenBuffers(1, &instanced_vbo_particles);
 	glBindBuffer(GL_ARRAY_BUFFER, instanced_vbo_particles);
+	glBufferData(GL_ARRAY_BUFFER,
+		(GLsizeiptr)PARTICLE_INSTANCE_RING_SEGMENTS * PARTICLE_COUNT_LIMIT * sizeof(ParticleInstancedNode), nullptr, GL_STREAM_DRAW);
 	gl_has_errors();
 
 
@@ -74,6 +81,20 @@ void RenderSystem::init(GLFWwindow* window_arg)
     initializeGlTextures();
 	initializeGlEffects();
 	initializeGlGeometryBuffers();
+
+	if (ParticleSystem::uses_gpu_simulation()) {
+		const GLuint sprite_vbo = vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE];
+		const GLuint sprite_ibo = index_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE];
+		if (gpu_particles.init(GPU_PARTICLE_CAPACITY, sprite_vbo, sprite_ibo)) {
+			gpu_particles.buildFrameTable(texture_atlas, particle_textures);
+			printf("Particles: simulating expiring particles on the GPU (ring of %d)\n", GPU_PARTICLE_CAPACITY);
+		}
+		else {
+			fprintf(stderr, "Particles: GPU simulation unavailable, staying on the CPU\n");
+			ParticleSystem::set_gpu_simulation(false);
+		}
+	}
+	glBindVertexArray(vao_general);
 }
 
 void RenderSystem::initializeVAOs() {
@@ -88,32 +109,146 @@ void RenderSystem::initializeGlTextures()
 	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
 	printf("Maximum texture size: %d\n", maxTextureSize);
 
+	GLint maxArrayLayers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxArrayLayers);
+
     glGenTextures((GLsizei)texture_gl_handles.size(), texture_gl_handles.data());
 
-    for(uint i = 0; i < texture_paths.size(); i++)
-    {
-		const std::string& path = texture_paths[i];
+	// Pack the atlas from the image headers so it can be allocated before decoding anything
+	for (uint i = 0; i < texture_paths.size(); i++)
+	{
 		ivec2& dimensions = texture_dimensions[i];
+		if (!stbi_info(texture_paths[i].c_str(), &dimensions.x, &dimensions.y, NULL)) {
+			dimensions = { 0, 0 };
+		}
+	}
+	const int atlas_layer_size = min(ATLAS_LAYER_SIZE, maxTextureSize);
+	const int atlas_budget_layers = max(ATLAS_MEMORY_BUDGET_BYTES / (atlas_layer_size * atlas_layer_size * 4), 1);
+	texture_atlas.pack(texture_dimensions, AnimationSystem::texture_frame_counts(), standalone_textures,
+		atlas_layer_size, min(min(ATLAS_MAX_LAYERS, atlas_budget_layers), maxArrayLayers));
+	texture_atlas.allocate();
+	texture_decode_ms.fill(0.f);
+	texture_upload_ms.fill(-1.f);
+	texture_cooked.fill(false);
+
+	// Decode on the worker pool, menu textures first, so the menu can be shown before the rest is resident
+	std::vector<int> load_order;
+	for (TEXTURE_ASSET_ID id : startup_textures) {
+		load_order.push_back((int)id);
+	}
+	for (int i = 0; i < texture_count; i++) {
+		if (std::find(startup_textures.begin(), startup_textures.end(), (TEXTURE_ASSET_ID)i) == startup_textures.end()) {
+			load_order.push_back(i);
+		}
+	}
 
-		stbi_uc* data;
-		data = stbi_load(path.c_str(), &dimensions.x, &dimensions.y, NULL, 4);
-
-		if (data == NULL)
-		{
-			const std::string message = "Could not load the file " + path + ".";
-			fprintf(stderr, "%s", message.c_str());
-			assert(false); 
+	const int worker_count = max((int)std::thread::hardware_concurrency() - 1, 1);
+	texture_load_start = std::chrono::high_resolution_clock::now();
+	texture_loader.start(std::vector<std::string>(texture_paths.begin(), texture_paths.end()), load_order, worker_count);
+	textures_uploaded = 0;
+	textures_resident = false;
+
+	// Whatever finishes alongside the startup set is uploaded too, in completion order
+	auto startup_pending = [&]() {
+		for (TEXTURE_ASSET_ID id : startup_textures) {
+			if (texture_upload_ms[(int)id] < 0.f) {
+				return true;
+			}
 		}
-		glBindTexture(GL_TEXTURE_2D, texture_gl_handles[i]);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dimensions.x, dimensions.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		return false;
+	};
+	DecodedTexture decoded;
+	while (startup_pending() && texture_loader.wait(decoded)) {
+		uploadDecodedTexture(decoded);
+	}
+	gl_has_errors();
+
+	printf("Texture loading: %d startup textures resident, decoding the rest on %d workers\n",
+		textures_uploaded, worker_count);
+}
+
+void RenderSystem::uploadDecodedTexture(DecodedTexture& decoded)
+{
+	const std::string& path = texture_paths[decoded.index];
+	ivec2& dimensions = texture_dimensions[decoded.index];
+
+	if (decoded.data == NULL)
+	{
+		const std::string message = "Could not load the file " + path + ".";
+		fprintf(stderr, "%s", message.c_str());
+		assert(false);
+		return;
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	dimensions = decoded.dimensions;
+
+	if (texture_atlas.contains((TEXTURE_ASSET_ID)decoded.index)) {
+		texture_atlas.upload((TEXTURE_ASSET_ID)decoded.index, decoded.data, dimensions);
+	}
+	if (texture_atlas.needsStandalone((TEXTURE_ASSET_ID)decoded.index)) {
+		glBindTexture(GL_TEXTURE_2D, texture_gl_handles[decoded.index]);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dimensions.x, dimensions.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, decoded.data);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
 		gl_has_errors();
-		stbi_image_free(data);
-    }
-	gl_has_errors();
+	}
+	decoded.release();
+
+	auto end = std::chrono::high_resolution_clock::now();
+	texture_decode_ms[decoded.index] = decoded.decode_ms;
+	texture_upload_ms[decoded.index] = std::chrono::duration<float, std::milli>(end - start).count();
+	texture_cooked[decoded.index] = decoded.cooked;
+	textures_uploaded++;
+}
+
+void RenderSystem::streamTextures(bool finish)
+{
+	if (textures_resident) {
+		return;
+	}
+
+	DecodedTexture decoded;
+	if (finish) {
+		while (texture_loader.wait(decoded)) {
+			uploadDecodedTexture(decoded);
+		}
+	}
+	else {
+		for (int i = 0; i < TEXTURE_UPLOADS_PER_FRAME && texture_loader.poll(decoded); i++) {
+			uploadDecodedTexture(decoded);
+		}
+	}
+	if (!texture_loader.done()) {
+		return;
+	}
+
+	texture_loader.stop();
+	textures_resident = true;
+
+	auto end = std::chrono::high_resolution_clock::now();
+	float decode_total = 0.f;
+	float upload_total = 0.f;
+	int cooked_count = 0;
+	for (int i = 0; i < texture_count; i++) {
+		printf("  %-60s %s %7.2f ms, upload %6.2f ms\n", texture_paths[i].c_str(),
+			texture_cooked[i] ? "cached" : "decode", texture_decode_ms[i], texture_upload_ms[i]);
+		decode_total += texture_decode_ms[i];
+		upload_total += texture_upload_ms[i];
+		cooked_count += texture_cooked[i] ? 1 : 0;
+	}
+	printf("Texture loading: %d textures (%d from cache), decode %.1f ms (summed over workers), upload %.1f ms, %.1f ms wall\n",
+		textures_uploaded, cooked_count, decode_total, upload_total,
+		std::chrono::duration<float, std::milli>(end - texture_load_start).count());
+	printf("Texture atlas: %d textures in %d layers, %d standalone\n",
+		texture_atlas.packedCount(), texture_atlas.layerCount(), texture_count - texture_atlas.packedCount());
+
+	// particles only sample the atlas
+	for (TEXTURE_ASSET_ID particle_texture : particle_textures) {
+		assert(particle_texture == TEXTURE_ASSET_ID::TEXTURE_COUNT || texture_atlas.contains(particle_texture));
+	}
 }
 
 void RenderSystem::initializeGlEffects()
@@ -150,10 +285,13 @@ void RenderSystem::initializeGlMeshes()
 		// Initialize meshes
 		GEOMETRY_BUFFER_ID geom_index = mesh_paths[i].first;
 		std::string name = mesh_paths[i].second;
-		Mesh::loadFromOBJFile(name,
-			meshes[(int)geom_index].vertices,
-			meshes[(int)geom_index].vertex_indices,
-			meshes[(int)geom_index].original_size);
+		if (!MeshCache::load(name, meshes[(int)geom_index]))
+		{
+			const std::string message = "Could not load the mesh " + name + ".";
+			fprintf(stderr, "%s", message.c_str());
+			assert(false);
+			continue;
+		}
 
 		//std::cout << "Loaded " << name << " with " << meshes[(int)geom_index].vertices.size() << " vertices." << std::endl;
 		//for (ColoredVertex& vertex : meshes[(int)geom_index].vertices)
@@ -239,8 +377,15 @@ RenderSystem::~RenderSystem()
 	glDeleteBuffers((GLsizei)index_buffers.size(), index_buffers.data());
 	//glDeleteBuffers(1, &instanced_vbo_static_tiles);
 	glDeleteBuffers(1, &instanced_vbo_particles);
+	for (GLsync fence : particle_ring_fences) {
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+		}
+	}
+	gpu_particles.destroy();
 
 	glDeleteTextures((GLsizei)texture_gl_handles.size(), texture_gl_handles.data());
+	texture_atlas.destroy();
 
 	glDeleteTextures(1, &off_screen_render_buffer_color);
 	glDeleteRenderbuffers(1, &off_screen_render_buffer_depth);
@@ -257,6 +402,8 @@ RenderSystem::~RenderSystem()
 	glDeleteFramebuffers(1, &frame_buffer);
 	glDeleteFramebuffers(1, &blur_buffer_1);
 	glDeleteFramebuffers(1, &blur_buffer_2);
+	deleteBlurPyramid(halo_pyramid);
+	deleteBlurPyramid(foreground_pyramid);
 	gl_has_errors();
 
 	// remove all entities created by the render system
@@ -342,9 +489,87 @@ bool RenderSystem::initScreenTexture()
 	assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
+	// Dual filter pyramids below the blur buffers
+	initBlurPyramid(halo_pyramid, HALO_BLUR_LEVELS, { blurbuffer_width, blurbuffer_height });
+	initBlurPyramid(foreground_pyramid, FOREGROUND_BLUR_LEVELS, { blurbuffer_width, blurbuffer_height });
+
+	screen_texture_size = { framebuffer_width, framebuffer_height };
 	return true;
 }
 
+void RenderSystem::resizeScreenTextures(ivec2 framebuffer_size)
+{
+	screen_texture_size = framebuffer_size;
+
+	glBindTexture(GL_TEXTURE_2D, off_screen_render_buffer_color);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, framebuffer_size.x, framebuffer_size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glBindRenderbuffer(GL_RENDERBUFFER, off_screen_render_buffer_depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, framebuffer_size.x, framebuffer_size.y);
+	gl_has_errors();
+
+	const ivec2 blurbuffer_size = max(ivec2(vec2(framebuffer_size) / BLUR_FACTOR), ivec2(1));
+	for (GLuint blur_buffer_color : { blur_buffer_color_1, blur_buffer_color_2 }) {
+		glBindTexture(GL_TEXTURE_2D, blur_buffer_color);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, blurbuffer_size.x, blurbuffer_size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	}
+	for (GLuint blur_buffer_depth : { blur_buffer_depth_1, blur_buffer_depth_2 }) {
+		glBindRenderbuffer(GL_RENDERBUFFER, blur_buffer_depth);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, blurbuffer_size.x, blurbuffer_size.y);
+	}
+	gl_has_errors();
+
+	// the pyramid levels are sized from the blur buffers, so rebuild them from scratch
+	deleteBlurPyramid(halo_pyramid);
+	deleteBlurPyramid(foreground_pyramid);
+	initBlurPyramid(halo_pyramid, HALO_BLUR_LEVELS, blurbuffer_size);
+	initBlurPyramid(foreground_pyramid, FOREGROUND_BLUR_LEVELS, blurbuffer_size);
+
+	// cached blurs were rendered at the old size
+	halo_blur_valid = false;
+	foreground_blur_valid = false;
+}
+
+void RenderSystem::initBlurPyramid(BlurPyramid& pyramid, int levels, ivec2 base_size)
+{
+	assert(levels >= 1);
+
+	pyramid.frame_buffers.resize(levels);
+	pyramid.color_textures.resize(levels);
+	pyramid.sizes.resize(levels);
+
+	glGenFramebuffers(levels, pyramid.frame_buffers.data());
+	glGenTextures(levels, pyramid.color_textures.data());
+	gl_has_errors();
+
+	ivec2 size = base_size;
+	for (int i = 0; i < levels; i++) {
+		size = max(size / 2, ivec2(1));
+		pyramid.sizes[i] = size;
+
+		glBindFramebuffer(GL_FRAMEBUFFER, pyramid.frame_buffers[i]);
+
+		glBindTexture(GL_TEXTURE_2D, pyramid.color_textures[i]);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, pyramid.color_textures[i], 0);
+		gl_has_errors();
+
+		assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderSystem::deleteBlurPyramid(BlurPyramid& pyramid)
+{
+	glDeleteTextures((GLsizei)pyramid.color_textures.size(), pyramid.color_textures.data());
+	glDeleteFramebuffers((GLsizei)pyramid.frame_buffers.size(), pyramid.frame_buffers.data());
+	pyramid = BlurPyramid();
+	gl_has_errors();
+}
+
 bool gl_compile_shader(GLuint shader)
 {
 	glCompileShader(shader);
@@ -369,7 +594,8 @@ bool gl_compile_shader(GLuint shader)
 }
 
 bool loadEffectFromFile(
-	const std::string& vs_path, const std::string& fs_path, GLuint& out_program)
+	const std::string& vs_path, const std::string& fs_path, GLuint& out_program,
+	const std::vector<const char*>& feedback_varyings)
 {
 	// Opening files
 	std::ifstream vs_is(vs_path);
@@ -416,6 +642,10 @@ bool loadEffectFromFile(
 	out_program = glCreateProgram();
 	glAttachShader(out_program, vertex);
 	glAttachShader(out_program, fragment);
+	// captured outputs have to be declared before linking
+	if (!feedback_varyings.empty()) {
+		glTransformFeedbackVaryings(out_program, (GLsizei)feedback_varyings.size(), feedback_varyings.data(), GL_INTERLEAVED_ATTRIBS);
+	}
 	glLinkProgram(out_program);
 	gl_has_errors();
 
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include "render_system.hpp"
 #include "../../tinyECS/registry.hpp"
@@ -177,15 +180,8 @@ void RenderSystem::setSilhouetteColor(Entity entity, vec4& silhouette_color) {
 }
 
 // Particles
-struct ParticleInstancedNode {
-	vec2 global_pos;
-	float rotation;
-	vec2 scale;
-	vec4 color_info;
-};
-
-void RenderSystem::instancedRenderParticles(const std::vector<Entity> & particles, float depth) {
-	auto particles_reg = registry.particles;
+void RenderSystem::instancedRenderParticles(float depth) {
+	const ParticlePool& particles = ParticleSystem::particles();
 	int instance_count = particles.size();
 
 	if (instance_count <= 0) {
@@ -195,27 +191,11 @@ void RenderSystem::instancedRenderParticles(const std::vector<Entity> & particle
 	// Use shader
 	GLuint curr_program = useShader(EFFECT_ASSET_ID::PARTICLE_INSTANCED);
 
-	// Bind all textures in order
-	bindTexture(GL_TEXTURE0, TEXTURE_ASSET_ID::GREY_CIRCLE);
-	bindTexture(GL_TEXTURE0 + 1, TEXTURE_ASSET_ID::BREAKABLE_FRAGMENTS);
-	bindTexture(GL_TEXTURE0 + 2, TEXTURE_ASSET_ID::COYOTE_PARTICLES);
-	bindTexture(GL_TEXTURE0 + 3, TEXTURE_ASSET_ID::SCREW_FRAGMENTS);
-	bindTexture(GL_TEXTURE0 + 4, TEXTURE_ASSET_ID::HEX_FRAGMENTS);
-	bindTexture(GL_TEXTURE0 + 5, TEXTURE_ASSET_ID::CRACKING_RADIAL);
-	bindTexture(GL_TEXTURE0 + 6, TEXTURE_ASSET_ID::CRACKING_DOWNWARD);
-	bindTexture(GL_TEXTURE0 + 7, TEXTURE_ASSET_ID::EXHALE);
-	bindTexture(GL_TEXTURE0 + 8, TEXTURE_ASSET_ID::BROKEN_PARTS);
-	bindTexture(GL_TEXTURE0 + 9, TEXTURE_ASSET_ID::CROSS_STAR);
-	glUniform1i(glGetUniformLocation(curr_program, "texture1"), 0);
-	glUniform1i(glGetUniformLocation(curr_program, "texture2"), 1);
-	glUniform1i(glGetUniformLocation(curr_program, "texture3"), 2);
-	glUniform1i(glGetUniformLocation(curr_program, "texture4"), 3);
-	glUniform1i(glGetUniformLocation(curr_program, "texture5"), 4);
-	glUniform1i(glGetUniformLocation(curr_program, "texture6"), 5);
-	glUniform1i(glGetUniformLocation(curr_program, "texture7"), 6);
-	glUniform1i(glGetUniformLocation(curr_program, "texture8"), 7);
-	glUniform1i(glGetUniformLocation(curr_program, "texture9"), 8);
-	glUniform1i(glGetUniformLocation(curr_program, "texture10"), 9);
+	// All particle sheets live in the atlas
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture_atlas.handle());
+	glUniform1i(glGetUniformLocation(curr_program, "atlas"), 0);
+	gl_has_errors();
 
 	// Set Vertex Attributes
 	const GLuint vbo = vertex_buffers[(GLuint)GEOMETRY_BUFFER_ID::SPRITE];
@@ -236,80 +216,127 @@ void RenderSystem::instancedRenderParticles(const std::vector<Entity> & particle
 		(void*)sizeof(
 			vec3)); // note the stride to skip the preceeding vertex position
 
-	// Set instanced properties
-	std::vector<ParticleInstancedNode> nodes(instance_count);
-	for (int i = 0; i < instance_count; i++) {
-		const Entity entity = particles[i];
-		const Particle &particle = particles_reg.get(entity);
+	// Claim the next ring segment, waiting only if the GPU is still drawing from it
+	const int segment = particle_ring_segment;
+	particle_ring_segment = (particle_ring_segment + 1) % PARTICLE_INSTANCE_RING_SEGMENTS;
+	if (particle_ring_fences[segment] != nullptr) {
+		glClientWaitSync(particle_ring_fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(particle_ring_fences[segment]);
+		particle_ring_fences[segment] = nullptr;
+	}
+
+	const GLsizeiptr NODE_SIZE = sizeof(ParticleInstancedNode);
+	const GLintptr segment_offset = (GLintptr)segment * PARTICLE_COUNT_LIMIT * NODE_SIZE;
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanced_vbo_particles);
+	ParticleInstancedNode* nodes = (ParticleInstancedNode*)glMapBufferRange(GL_ARRAY_BUFFER,
+		segment_offset, instance_count * NODE_SIZE,
+		GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+	if (nodes == nullptr) {
+		gl_has_errors();
+		return;
+	}
+
+	// Set instanced properties, skipping particles outside the camera view; written straight
+	// into the mapped segment, front to back
+	const RenderBounds view_bounds = getViewBounds(depth);
+	int visible_count = 0;
+	for (int j = 0; j < instance_count; j++) {
+		const vec2 position = { particles.position_x[j], particles.position_y[j] };
+		const vec2 scale = { particles.scale_x[j], particles.scale_y[j] };
+
+		const vec2 half_extents = vec2(0.5f * glm::length(scale));
+		if (!view_bounds.overlaps({ position - half_extents, position + half_extents })) {
+			continue;
+		}
+		ParticleInstancedNode node;
 
 		// Transform info
 
-		nodes[i].global_pos = particle.position;
-		nodes[i].rotation = particle.angle * M_PI / 180.0;
-		nodes[i].scale = particle.scale;
+		node.global_pos = position;
+		node.rotation = particles.angle[j] * M_PI / 180.0;
+		node.scale = scale;
+
+		const float timer = particles.timer[j];
+		const float life = particles.life[j];
 
 		// Fade in/out
 		float fade_factor = 1.0f;
-		if (particle.fade_in_out[0] > 1e-4 && particle.timer <= particle.fade_in_out[0]) {
+		if (particles.fade_in[j] > 1e-4 && timer <= particles.fade_in[j]) {
 			// Fade in
-			fade_factor = particle.timer / particle.fade_in_out[0];
+			fade_factor = timer / particles.fade_in[j];
 		}
-		else if (particle.fade_in_out[1] > 1e-4 && (particle.life - particle.timer) <= particle.fade_in_out[1]) {
+		else if (particles.fade_out[j] > 1e-4 && (life - timer) <= particles.fade_out[j]) {
 			// Fade out
-			fade_factor = (particle.life - particle.timer) / particle.fade_in_out[1];
+			fade_factor = (life - timer) / particles.fade_out[j];
 		}
 
 		// Shrink in/out
 		float shrink_factor = 1.0f;
-		if (particle.shrink_in_out[0] > 1e-4 && particle.timer <= particle.shrink_in_out[0]) {
+		if (particles.shrink_in[j] > 1e-4 && timer <= particles.shrink_in[j]) {
 			// Shrink in
-			shrink_factor = particle.timer / particle.shrink_in_out[0];
+			shrink_factor = timer / particles.shrink_in[j];
 		}
-		else if (particle.shrink_in_out[1] > 1e-4 && (particle.life - particle.timer) <= particle.shrink_in_out[1]) {
+		else if (particles.shrink_out[j] > 1e-4 && (life - timer) <= particles.shrink_out[j]) {
 			// Shrink out
-			shrink_factor = (particle.life - particle.timer) / particle.shrink_in_out[1];
+			shrink_factor = (life - timer) / particles.shrink_out[j];
 		}
 
-		nodes[i].scale *= shrink_factor;
+		node.scale *= shrink_factor;
 
 		// Color info
-		if (particle.particle_id == PARTICLE_ID::COLORED) {
-			assert(registry.colors.has(entity));
-			nodes[i].color_info = vec4(registry.colors.get(entity), cubic_interpolation(0.0, particle.alpha, fade_factor));
+		const PARTICLE_ID particle_id = particles.type[j];
+		if (particle_id == PARTICLE_ID::COLORED) {
+			node.color_info = vec4(particles.color[j], cubic_interpolation(0.0, particles.alpha[j], fade_factor));
+			node.atlas_info = vec4(0.0f);
 		}
 		else {
-			vec2 tex_u;
-			setURange(entity, tex_u);
-			nodes[i].color_info = vec4(tex_u, cubic_interpolation(0.0, particle.alpha, fade_factor), - (int)particle.particle_id);
+			AtlasSample atlas_sample;
+			texture_atlas.lookup(particle_textures[(int)particle_id], ParticleSystem::animation_u_range(j), atlas_sample);
+
+			node.color_info = vec4(atlas_sample.u_range, cubic_interpolation(0.0, particles.alpha[j], fade_factor), - (int)particle_id);
+			node.atlas_info = vec4(atlas_sample.v_range, atlas_sample.layer, 0.0f);
 		}
+
+		nodes[visible_count++] = node;
 	}
 
-	glm::size_t NODE_SIZE = sizeof(ParticleInstancedNode);
+	glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, visible_count * NODE_SIZE);
+	if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE) {
+		// the buffer contents were lost (e.g. display mode change); skip this frame
+		return;
+	}
 
-	glm::size_t new_size = instance_count * NODE_SIZE;
-	glBindBuffer(GL_ARRAY_BUFFER, instanced_vbo_particles);
-	glBufferData(GL_ARRAY_BUFFER, new_size, nodes.data(), GL_DYNAMIC_DRAW);
+	instance_count = visible_count;
+	if (instance_count <= 0) {
+		return;
+	}
 
 	// global_pos
 	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)0);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)segment_offset);
 
 	// rotation
 	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)offsetof(ParticleInstancedNode, rotation));
+	glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)(segment_offset + offsetof(ParticleInstancedNode, rotation)));
 
 	// scale
 	glEnableVertexAttribArray(4);
-	glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)offsetof(ParticleInstancedNode, scale));
+	glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)(segment_offset + offsetof(ParticleInstancedNode, scale)));
 
 	// color_info
 	glEnableVertexAttribArray(5);
-	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)offsetof(ParticleInstancedNode, color_info));
+	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)(segment_offset + offsetof(ParticleInstancedNode, color_info)));
+
+	// atlas_info
+	glEnableVertexAttribArray(6);
+	glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, NODE_SIZE, (void*)(segment_offset + offsetof(ParticleInstancedNode, atlas_info)));
 
 	glVertexAttribDivisor(2, 1);
 	glVertexAttribDivisor(3, 1);
 	glVertexAttribDivisor(4, 1);
 	glVertexAttribDivisor(5, 1);
+	glVertexAttribDivisor(6, 1);
 	gl_has_errors();
 
 	// Uniforms
@@ -325,6 +352,44 @@ void RenderSystem::instancedRenderParticles(const std::vector<Entity> & particle
 
 	// 6 indices for sprite
 	glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0, instance_count);
+	particle_ring_fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void RenderSystem::renderGpuParticles(float depth) {
+	if (!gpu_particles.isReady()) {
+		return;
+	}
+
+	bool cleared = false;
+	ParticleSystem::take_gpu_spawns(gpu_particle_spawns, cleared);
+	if (cleared) {
+		gpu_particles.clear();
+	}
+	gpu_particles.emit(gpu_particle_spawns);
+
+	// Only advance when the particle system stepped, so pausing freezes the GPU particles too
+	ParticleStepParams params;
+	if (ParticleSystem::take_gpu_step(params)) {
+		gpu_particles.simulate(params);
+	}
+
+	if (gpu_particles.activeCount() <= 0) {
+		return;
+	}
+
+	GLuint curr_program = useShader(EFFECT_ASSET_ID::PARTICLE_INSTANCED);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture_atlas.handle());
+	glUniform1i(glGetUniformLocation(curr_program, "atlas"), 0);
+
+	GLuint projection_loc = glGetUniformLocation(curr_program, "projection");
+	glUniformMatrix3fv(projection_loc, 1, GL_FALSE, (float*)&(this->projection_matrix));
+	GLuint depth_loc = glGetUniformLocation(curr_program, "depth");
+	glUniform1fv(depth_loc, 1, (float*)&depth);
+	gl_has_errors();
+
+	gpu_particles.draw();
 }
 
 
@@ -493,3 +558,278 @@ void RenderSystem::drawBlurredLayer(GLuint source_texture, BLUR_MODE mode, float
 	// no offset from the bound index buffer
 	gl_has_errors();
 }
+
+// Dual filter (Kawase) blur: downsample through the pyramid, then upsample back to its first level.
+// The result is left in pyramid.color_textures[0] for compositing
+void RenderSystem::drawDualFilterBlur(GLuint source_texture, const BlurPyramid& pyramid, float strength) {
+	const int levels = (int)pyramid.frame_buffers.size();
+	assert(levels >= 1);
+
+	// every pass overwrites its whole target
+	glDisable(GL_BLEND);
+
+	GLuint previous_texture = source_texture;
+	for (int i = 0; i < levels; i++) {
+		glBindFramebuffer(GL_FRAMEBUFFER, pyramid.frame_buffers[i]);
+		glViewport(0, 0, pyramid.sizes[i].x, pyramid.sizes[i].y);
+		drawBlurredLayer(previous_texture, BLUR_MODE::KAWASE_DOWN, KAWASE_BLUR_OFFSET, 1.0f);
+		previous_texture = pyramid.color_textures[i];
+	}
+
+	for (int i = levels - 2; i >= 0; i--) {
+		glBindFramebuffer(GL_FRAMEBUFFER, pyramid.frame_buffers[i]);
+		glViewport(0, 0, pyramid.sizes[i].x, pyramid.sizes[i].y);
+		drawBlurredLayer(pyramid.color_textures[i + 1], BLUR_MODE::KAWASE_UP, KAWASE_BLUR_OFFSET, strength);
+	}
+
+	glEnable(GL_BLEND);
+	gl_has_errors();
+}
+
+bool RenderSystem::computeBlurSignature(const FrameVector<Entity>& entities, size_t& signature) {
+	// the time control state is part of the signature, without a game state treat it as changed
+	if (registry.gameStates.size() == 0) {
+		return false;
+	}
+
+	size_t seed = 0;
+	auto combine = [&seed](size_t value) {
+		seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	};
+	auto combine_float = [&combine](float value) {
+		combine(std::hash<float>()(value));
+	};
+
+	// window and camera zoom; the camera translation only matters through where each
+	// entity lands on screen, so panning past a static scene keeps the signature
+	int w, h;
+	glfwGetFramebufferSize(window, &w, &h);
+	combine(w);
+	combine(h);
+	combine_float(projection_matrix[0][0]);
+	combine_float(projection_matrix[1][1]);
+	combine((size_t)registry.gameStates.components[0].game_time_control_state);
+
+	// screen position in quarter blur buffer texels, finer moves are invisible after blurring
+	const vec2 blur_buffer_size = vec2(w, h) / BLUR_FACTOR;
+	auto combine_screen_position = [&](vec2 world_position) {
+		const vec3 clip = projection_matrix * vec3(world_position, 1.0f);
+		const vec2 texel = (vec2(clip) * 0.5f + 0.5f) * blur_buffer_size * 4.0f;
+		combine(std::hash<int>()((int)std::round(texel.x)));
+		combine(std::hash<int>()((int)std::round(texel.y)));
+	};
+
+	for (Entity entity : entities) {
+		combine(entity.id());
+
+		if (registry.motions.has(entity)) {
+			const Motion& motion = registry.motions.get(entity);
+			combine_screen_position(motion.position);
+			combine_float(motion.angle);
+			combine_float(motion.scale.x);
+			combine_float(motion.scale.y);
+		}
+		else if (registry.tiles.has(entity) && registry.motions.has(registry.tiles.get(entity).parent_id)) {
+			const Motion& parent_motion = registry.motions.get(registry.tiles.get(entity).parent_id);
+			combine_screen_position(parent_motion.position);
+		}
+
+		const RenderRequest& render_request = registry.renderRequests.get(entity);
+		combine((size_t)render_request.used_texture);
+
+		vec2 tex_u_range;
+		setURange(entity, tex_u_range);
+		combine_float(tex_u_range[0]);
+		combine_float(tex_u_range[1]);
+
+		if (registry.haloRequests.has(entity)) {
+			const vec4& halo_color = registry.haloRequests.get(entity).halo_color;
+			for (int i = 0; i < 4; i++) {
+				combine_float(halo_color[i]);
+			}
+		}
+
+		if (registry.colors.has(entity)) {
+			const vec3& color = registry.colors.get(entity);
+			for (int i = 0; i < 3; i++) {
+				combine_float(color[i]);
+			}
+		}
+	}
+
+	signature = seed;
+	return true;
+}
+
+float RenderSystem::getLayerDepth(LAYER_ID layer) {
+	switch (layer) {
+		case LAYER_ID::PARALLAXBACKGROUND:
+			return PARALLAXBACKGROUND_DEPTH;
+		case LAYER_ID::BACKGROUND:
+			return BACKGROUND_DEPTH;
+		case LAYER_ID::MIDGROUND:
+		case LAYER_ID::MENU_AND_PAUSE:
+			return MIDGROUND_DEPTH;
+		case LAYER_ID::CUTSCENE:
+			return STANDARD_DEPTH;
+		default:
+			return FOREGROUND_DEPTH;
+	}
+}
+
+bool RenderSystem::getRenderBounds(Entity entity, RenderBounds& bounds) const {
+	if (registry.tiles.has(entity)) {
+		const Tile& tile = registry.tiles.get(entity);
+		if (!registry.motions.has(tile.parent_id)) {
+			return false;
+		}
+
+		// same placement as the tile shader
+		const Motion& parent_motion = registry.motions.get(tile.parent_id);
+		const vec2 tile_min = parent_motion.position - (parent_motion.scale / 2.0f) + tile.offset * (float)TILE_TO_PIXELS;
+		bounds = { tile_min, tile_min + vec2((float)TILE_TO_PIXELS) };
+		return true;
+	}
+
+	if (!registry.motions.has(entity)) {
+		return false;
+	}
+
+	// rotation-safe radius; pendulum arms rotate around an offset pivot
+	const Motion& motion = registry.motions.get(entity);
+	float radius = 0.5f * glm::length(motion.scale);
+	if (registry.pivotPoints.has(entity)) {
+		radius += glm::length(registry.pivotPoints.get(entity).offset);
+	}
+	bounds = { motion.position - vec2(radius), motion.position + vec2(radius) };
+	return true;
+}
+
+// Tiles of platforms that never move are indexed once; everything else is tested per frame
+bool RenderSystem::isStaticRenderEntity(Entity entity) const {
+	if (!registry.tiles.has(entity)) {
+		return false;
+	}
+
+	const LAYER_ID layer = registry.layers.get(entity).layer;
+	if (layer == LAYER_ID::MENU_AND_PAUSE || layer == LAYER_ID::CUTSCENE) {
+		return false;
+	}
+
+	const unsigned int parent_id = registry.tiles.get(entity).parent_id;
+	return registry.motions.has(parent_id) && !registry.movementPaths.has(parent_id) &&
+		render_grid_moving_parents.count(parent_id) == 0;
+}
+
+// One check per parent rather than per tile; a moved or removed parent invalidates the grid
+bool RenderSystem::renderGridAnchorsMoved() {
+	bool moved = false;
+	for (const RenderGridAnchor& anchor : render_grid_anchors) {
+		if (!registry.motions.has(anchor.parent_id)) {
+			moved = true;
+			continue;
+		}
+
+		const Motion& motion = registry.motions.get(anchor.parent_id);
+		if (motion.position != anchor.position || motion.scale != anchor.scale) {
+			// so a parent that keeps moving does not rebuild the grid every frame
+			render_grid_moving_parents.insert(anchor.parent_id);
+			moved = true;
+		}
+	}
+	return moved;
+}
+
+void RenderSystem::refreshRenderGrid() {
+	const std::vector<Entity>& layered = registry.layers.entities;
+	const unsigned int last_entity = layered.empty() ? 0 : Entity(layered.back()).id();
+
+	// swap-and-pop removal and new entity ids both show up in the size or the last entry
+	if (layered.size() == render_grid_layer_count && last_entity == render_grid_last_entity &&
+		!renderGridAnchorsMoved()) {
+		return;
+	}
+	render_grid_layer_count = layered.size();
+	render_grid_last_entity = last_entity;
+
+	static_render_grid.clear();
+	static_render_bounds.assign(layered.size(), RenderBounds());
+	render_grid_anchors.clear();
+	dynamic_render_indices.clear();
+
+	for (auto it = render_grid_moving_parents.begin(); it != render_grid_moving_parents.end();) {
+		it = registry.motions.has(*it) ? std::next(it) : render_grid_moving_parents.erase(it);
+	}
+	static_render_max_depth = 0.0f;
+
+	for (unsigned int i = 0; i < layered.size(); i++) {
+		const Entity entity = layered[i];
+		RenderBounds bounds;
+
+		if (isStaticRenderEntity(entity) && getRenderBounds(entity, bounds)) {
+			static_render_bounds[i] = bounds;
+			static_render_grid.insert(i, bounds);
+
+			// tiles of one parent are created together, so they sit next to each other in the layers
+			const unsigned int parent_id = registry.tiles.get(entity).parent_id;
+			if (render_grid_anchors.empty() || render_grid_anchors.back().parent_id != parent_id) {
+				const Motion& parent_motion = registry.motions.get(parent_id);
+				render_grid_anchors.push_back({ parent_id, parent_motion.position, parent_motion.scale });
+			}
+			static_render_max_depth = max(static_render_max_depth, getLayerDepth(registry.layers.components[i].layer));
+		}
+		else {
+			dynamic_render_indices.push_back(i);
+		}
+	}
+}
+
+void RenderSystem::collectVisibleRenderIndices(FrameVector<unsigned int>& visible_indices) {
+	refreshRenderGrid();
+
+	const std::vector<Entity>& layered = registry.layers.entities;
+
+	if (static_render_grid.size() > 0) {
+		static_render_grid.query(getViewBounds(static_render_max_depth), visible_indices);
+
+		// the grid query is coarse, refine against each layer's own view
+		size_t kept = 0;
+		for (unsigned int index : visible_indices) {
+			const LAYER_ID layer = registry.layers.components[index].layer;
+			if (static_render_bounds[index].overlaps(getViewBounds(getLayerDepth(layer)))) {
+				visible_indices[kept++] = index;
+			}
+		}
+		visible_indices.resize(kept);
+	}
+
+	for (unsigned int index : dynamic_render_indices) {
+		const Entity entity = layered[index];
+
+		// TODO: this could be somewhere else, but idk how to get the mesh pointer without increased system coupling...
+		// Keep track of pointer to any custom mesh in the registry for use in other systems (even when off-screen)
+		if (!registry.meshPtrs.has(entity) && registry.renderRequests.has(entity)) {
+			const RenderRequest& request = registry.renderRequests.get(entity);
+			if (request.used_geometry == GEOMETRY_BUFFER_ID::HEX ||
+				request.used_geometry == GEOMETRY_BUFFER_ID::OCTA) {
+				Mesh& mesh = getMesh(request.used_geometry);
+				registry.meshPtrs.emplace(entity, &mesh);
+			}
+		}
+
+		const LAYER_ID layer = registry.layers.components[index].layer;
+		if (layer == LAYER_ID::MENU_AND_PAUSE || layer == LAYER_ID::CUTSCENE) {
+			visible_indices.push_back(index);
+			continue;
+		}
+
+		RenderBounds bounds;
+		if (!getRenderBounds(entity, bounds) || bounds.overlaps(getViewBounds(getLayerDepth(layer)))) {
+			visible_indices.push_back(index);
+		}
+	}
+
+	// keep the original registry order so overlapping sprites draw as before
+	std::sort(visible_indices.begin(), visible_indices.end());
+	visible_indices.erase(std::unique(visible_indices.begin(), visible_indices.end()), visible_indices.end());
+}
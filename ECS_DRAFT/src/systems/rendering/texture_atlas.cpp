@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <set>
+
+#include "texture_atlas.hpp"
+
+namespace {
+	struct PackItem {
+		int texture;
+		AtlasRegion region;
+	};
+}
+
+void TextureAtlas::pack(const std::array<ivec2, texture_count>& dimensions,
+	const std::array<int, texture_count>& frame_counts,
+	const std::vector<TEXTURE_ASSET_ID>& excluded,
+	int layer_size, int max_layers)
+{
+	this->layer_size = layer_size;
+	this->layer_count = 0;
+	for (std::vector<AtlasRegion>& texture_regions : regions) {
+		texture_regions.clear();
+	}
+
+	// Cut every texture into the items that have to be placed
+	std::vector<PackItem> items;
+	for (int i = 0; i < texture_count; i++) {
+		const ivec2 size = dimensions[i];
+		if (size.x <= 0 || size.y <= 0 ||
+			std::find(excluded.begin(), excluded.end(), (TEXTURE_ASSET_ID)i) != excluded.end()) {
+			continue;
+		}
+
+		// Large frames gain nothing from batching and would crowd out the sprites
+		const int frames = std::max(frame_counts[i], 1);
+		const int frame_width = size.x % frames == 0 ? size.x / frames : size.x;
+		if (frame_width > ATLAS_MAX_SPRITE_SIZE || size.y > ATLAS_MAX_SPRITE_SIZE) {
+			continue;
+		}
+
+		if (size.x + ATLAS_PADDING <= layer_size && size.y + ATLAS_PADDING <= layer_size) {
+			AtlasRegion region;
+			region.size = size;
+			items.push_back({ i, region });
+			continue;
+		}
+
+		// Oversized sheets are split on frame boundaries so a single frame never straddles two strips
+		if (frames <= 1 || size.x % frames != 0) {
+			continue;
+		}
+
+		const int frames_per_strip = (layer_size - ATLAS_PADDING) / frame_width;
+		for (int frame = 0; frame < frames; frame += frames_per_strip) {
+			const int strip_frames = std::min(frames_per_strip, frames - frame);
+
+			AtlasRegion region;
+			region.size = { strip_frames * frame_width, size.y };
+			region.source_x = frame * frame_width;
+			region.u_begin = (float)frame / frames;
+			region.u_end = (float)(frame + strip_frames) / frames;
+			items.push_back({ i, region });
+		}
+	}
+
+	// Shelf packing, tallest first
+	std::stable_sort(items.begin(), items.end(), [](const PackItem& a, const PackItem& b) {
+		return a.region.size.y > b.region.size.y;
+	});
+
+	std::set<int> unplaced;
+	int layer = 0;
+	int shelf_y = 0;
+	int shelf_height = 0;
+	int cursor_x = 0;
+
+	for (PackItem& item : items) {
+		const int width = item.region.size.x + ATLAS_PADDING;
+		const int height = item.region.size.y + ATLAS_PADDING;
+
+		if (cursor_x + width > layer_size) {
+			shelf_y += shelf_height;
+			cursor_x = 0;
+			shelf_height = 0;
+		}
+		if (shelf_y + height > layer_size) {
+			layer++;
+			shelf_y = 0;
+			cursor_x = 0;
+			shelf_height = 0;
+		}
+		if (layer >= max_layers) {
+			unplaced.insert(item.texture);
+			continue;
+		}
+
+		item.region.layer = layer;
+		item.region.offset = { cursor_x, shelf_y };
+		cursor_x += width;
+		shelf_height = std::max(shelf_height, height);
+
+		regions[item.texture].push_back(item.region);
+		layer_count = layer + 1;
+	}
+
+	// A texture is only usable from the atlas if all of its strips made it in
+	for (int texture : unplaced) {
+		regions[texture].clear();
+	}
+
+	// lookup() walks strips in u order
+	for (std::vector<AtlasRegion>& texture_regions : regions) {
+		std::sort(texture_regions.begin(), texture_regions.end(), [](const AtlasRegion& a, const AtlasRegion& b) {
+			return a.u_begin < b.u_begin;
+		});
+	}
+}
+
+void TextureAtlas::allocate()
+{
+	if (layer_count == 0) {
+		return;
+	}
+
+	glGenTextures(1, &gl_handle);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, gl_handle);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layer_size, layer_size, layer_count, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	gl_has_errors();
+}
+
+void TextureAtlas::upload(TEXTURE_ASSET_ID id, const unsigned char* rgba_data, ivec2 dimensions) const
+{
+	assert(gl_handle != 0 && contains(id));
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, gl_handle);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, dimensions.x);
+
+	for (const AtlasRegion& region : regions[(int)id]) {
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS, region.source_x);
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0,
+			region.offset.x, region.offset.y, region.layer,
+			region.size.x, region.size.y, 1,
+			GL_RGBA, GL_UNSIGNED_BYTE, rgba_data);
+	}
+
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	gl_has_errors();
+}
+
+void TextureAtlas::destroy()
+{
+	if (gl_handle != 0) {
+		glDeleteTextures(1, &gl_handle);
+		gl_handle = 0;
+	}
+}
+
+int TextureAtlas::packedCount() const
+{
+	int count = 0;
+	for (const std::vector<AtlasRegion>& texture_regions : regions) {
+		count += texture_regions.empty() ? 0 : 1;
+	}
+	return count;
+}
+
+bool TextureAtlas::lookup(TEXTURE_ASSET_ID id, vec2 tex_u_range, AtlasSample& sample) const
+{
+	const std::vector<AtlasRegion>& texture_regions = regions[(int)id];
+	if (texture_regions.empty()) {
+		return false;
+	}
+
+	const float u_min = std::min(tex_u_range[0], tex_u_range[1]);
+	const float u_max = std::max(tex_u_range[0], tex_u_range[1]);
+	const float u_mid = 0.5f * (u_min + u_max);
+	const float tolerance = 1e-4f;
+
+	const AtlasRegion* region = &texture_regions.back();
+	for (const AtlasRegion& candidate : texture_regions) {
+		if (u_mid < candidate.u_end) {
+			region = &candidate;
+			break;
+		}
+	}
+	if (u_min < region->u_begin - tolerance || u_max > region->u_end + tolerance) {
+		return false;
+	}
+
+	const float inv_size = 1.0f / layer_size;
+	auto to_atlas_u = [&](float u) {
+		const float local_u = (u - region->u_begin) / (region->u_end - region->u_begin);
+		return (region->offset.x + local_u * region->size.x) * inv_size;
+	};
+
+	sample.layer = (float)region->layer;
+	sample.u_range = { to_atlas_u(tex_u_range[0]), to_atlas_u(tex_u_range[1]) };
+	sample.v_range = { region->offset.y * inv_size, (region->offset.y + region->size.y) * inv_size };
+	sample.bounds = {
+		region->offset.x * inv_size,
+		sample.v_range[0],
+		(region->offset.x + region->size.x) * inv_size,
+		sample.v_range[1]
+	};
+	return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "../../common.hpp"
+#include "../../tinyECS/components.hpp"
+
+// Part of a source texture packed into one atlas layer. Sheets wider than a layer are cut
+// into strips on frame boundaries, each strip covering [u_begin, u_end) of the source
+struct AtlasRegion {
+	int layer = 0;
+	ivec2 offset = { 0, 0 };	// in atlas texels
+	ivec2 size = { 0, 0 };
+	int source_x = 0;			// first source column of this strip
+	float u_begin = 0.f;
+	float u_end = 1.f;
+};
+
+// Where a draw should sample from once its u-range has been resolved against the atlas
+struct AtlasSample {
+	float layer = -1.f;
+	vec2 u_range = { 0.f, 1.f };
+	vec2 v_range = { 0.f, 1.f };
+	vec4 bounds = { 0.f, 0.f, 1.f, 1.f };	// (u_min, v_min, u_max, v_max) of the region
+};
+
+// Shelf-packs textures into a GL_TEXTURE_2D_ARRAY so sprites and particles can share one binding.
+// Textures that cannot be packed (excluded, frames over ATLAS_MAX_SPRITE_SIZE, or out of layers)
+// keep their own GL texture, as do sheets split into several strips since a u-range spanning
+// strips cannot be sampled from the atlas.
+class TextureAtlas {
+public:
+	// Computes the placement of every texture; nothing is uploaded yet
+	void pack(const std::array<ivec2, texture_count>& dimensions,
+		const std::array<int, texture_count>& frame_counts,
+		const std::vector<TEXTURE_ASSET_ID>& excluded,
+		int layer_size, int max_layers);
+
+	// Allocates the array texture for the packed layers
+	void allocate();
+	void upload(TEXTURE_ASSET_ID id, const unsigned char* rgba_data, ivec2 dimensions) const;
+	void destroy();
+
+	bool contains(TEXTURE_ASSET_ID id) const { return !regions[(int)id].empty(); }
+	// lookup() can only fail for these, so they also need a standalone GL texture
+	bool needsStandalone(TEXTURE_ASSET_ID id) const { return regions[(int)id].size() != 1; }
+
+	// Maps a u-range of the source texture onto the atlas; false if the texture is not packed
+	// or the range does not lie within a single strip
+	bool lookup(TEXTURE_ASSET_ID id, vec2 tex_u_range, AtlasSample& sample) const;
+
+	GLuint handle() const { return gl_handle; }
+	int layerCount() const { return layer_count; }
+	int packedCount() const;
+
+private:
+	GLuint gl_handle = 0;
+	int layer_size = 0;
+	int layer_count = 0;
+	std::array<std::vector<AtlasRegion>, texture_count> regions;
+};
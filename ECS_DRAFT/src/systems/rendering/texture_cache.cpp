@@ -0,0 +1,116 @@
+#include <cstring>
+#include <filesystem>
+
+#include "../../lz_codec.hpp"
+#include "texture_cache.hpp"
+
+namespace {
+	const char COOKED_TEXTURE_MAGIC[4] = { 'T', 'E', 'X', 'C' };
+	const uint32_t COOKED_TEXTURE_VERSION = 2;
+}
+
+std::string TextureCache::cookedPath(const std::string& source_path)
+{
+	// flatten the path below the project root into a single file name
+	std::string name = source_path;
+	const std::string root = PROJECT_SOURCE_DIR;
+	if (name.compare(0, root.size(), root) == 0) {
+		name = name.substr(root.size());
+	}
+	for (char& c : name) {
+		if (!isalnum((unsigned char)c)) {
+			c = '_';
+		}
+	}
+	return cooked_path(name + ".tex");
+}
+
+bool TextureCache::load(const std::string& source_path, uint64_t source_hash,
+	std::vector<unsigned char>& pixels, ivec2& dimensions)
+{
+	MappedFile cooked;
+	if (!cooked.open(cookedPath(source_path))) {
+		return false;
+	}
+
+	CookedTextureHeader header;
+	bool valid = cooked.size() >= sizeof(header);
+	if (valid) {
+		memcpy(&header, cooked.data(), sizeof(header));
+		valid = memcmp(header.magic, COOKED_TEXTURE_MAGIC, sizeof(header.magic)) == 0 &&
+			header.version == COOKED_TEXTURE_VERSION &&
+			header.source_hash == source_hash &&
+			header.format == COOKED_TEXTURE_FORMAT::RGBA8_LZ &&
+			header.mip_levels >= 1 &&
+			cooked.size() >= sizeof(header) + sizeof(CookedMip);
+	}
+
+	CookedMip base;
+	if (valid) {
+		memcpy(&base, cooked.data() + sizeof(header), sizeof(base));
+		valid = base.width == header.width && base.height == header.height &&
+			base.offset + base.size <= cooked.size();
+	}
+
+	if (valid) {
+		pixels.resize((size_t)base.width * base.height * 4);
+		valid = lz_decompress(cooked.data() + base.offset, (size_t)base.size, pixels.data(), pixels.size());
+	}
+
+	if (!valid) {
+		pixels.clear();
+		return false;
+	}
+
+	dimensions = { (int)header.width, (int)header.height };
+	return true;
+}
+
+bool TextureCache::store(const std::string& source_path, uint64_t source_hash,
+	const unsigned char* rgba_data, ivec2 dimensions)
+{
+	const std::string path = cookedPath(source_path);
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+	CookedTextureHeader header;
+	memcpy(header.magic, COOKED_TEXTURE_MAGIC, sizeof(header.magic));
+	header.version = COOKED_TEXTURE_VERSION;
+	header.source_hash = source_hash;
+	header.format = COOKED_TEXTURE_FORMAT::RGBA8_LZ;
+	header.width = (uint32_t)dimensions.x;
+	header.height = (uint32_t)dimensions.y;
+	header.mip_levels = 1;
+
+	const size_t pixel_bytes = (size_t)dimensions.x * dimensions.y * 4;
+	std::vector<unsigned char> compressed(lz_compress_bound(pixel_bytes));
+	compressed.resize(lz_compress(rgba_data, pixel_bytes, compressed.data()));
+
+	CookedMip base;
+	base.width = header.width;
+	base.height = header.height;
+	base.offset = sizeof(header) + sizeof(base);
+	base.size = compressed.size();
+
+	// write to a temporary name first so a concurrent reader never maps a half-written file
+	const std::string file_path = temporary_path(path);
+	std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)&base, sizeof(base));
+	file.write((const char*)compressed.data(), (std::streamsize)base.size);
+	file.close();
+	if (!file) {
+		std::filesystem::remove(file_path, error);
+		return false;
+	}
+
+	std::filesystem::rename(file_path, path, error);
+	if (error) {
+		std::filesystem::remove(file_path, error);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../common.hpp"
+#include "../../mapped_file.hpp"
+
+enum class COOKED_TEXTURE_FORMAT : uint32_t {
+	RGBA8 = 0,
+	RGBA8_LZ = 1,	// RGBA8 through lz_codec
+};
+
+// One mip level inside a cooked texture, offset from the start of the file
+struct CookedMip {
+	uint32_t width;
+	uint32_t height;
+	uint64_t offset;
+	uint64_t size;	// stored bytes, compressed for RGBA8_LZ
+};
+
+// File layout: header, then mip_levels CookedMip entries, then the pixel data of each level
+struct CookedTextureHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t source_hash;
+	COOKED_TEXTURE_FORMAT format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t mip_levels;
+};
+
+// Pre-decoded copies of the PNG textures, LZ compressed in the per-user cache directory and
+// expanded at startup. A cooked file is only used while its recorded hash matches the source.
+class TextureCache {
+public:
+	static std::string cookedPath(const std::string& source_path);
+
+	// Expands level 0 of the cooked copy of source_path into pixels
+	static bool load(const std::string& source_path, uint64_t source_hash,
+		std::vector<unsigned char>& pixels, ivec2& dimensions);
+
+	// Writes a cooked copy of an RGBA8 image decoded from source_path
+	static bool store(const std::string& source_path, uint64_t source_hash,
+		const unsigned char* rgba_data, ivec2 dimensions);
+};
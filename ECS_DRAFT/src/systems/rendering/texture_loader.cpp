@@ -0,0 +1,113 @@
+#include <chrono>
+
+#include "../../../ext/stb_image/stb_image.h"
+#include "texture_cache.hpp"
+#include "texture_loader.hpp"
+
+void DecodedTexture::release()
+{
+	if (stbi_data != nullptr) {
+		stbi_image_free(stbi_data);
+		stbi_data = nullptr;
+	}
+	cooked_pixels.reset();
+	data = nullptr;
+}
+
+void TextureLoader::start(const std::vector<std::string>& paths, const std::vector<int>& order, int worker_count)
+{
+	stop();
+
+	this->paths = paths;
+	this->order = order;
+	this->job_count = order.size();
+	this->handed_out = 0;
+	next_job = 0;
+
+	for (int i = 0; i < max(worker_count, 1); i++) {
+		workers.emplace_back(&TextureLoader::workerLoop, this);
+	}
+}
+
+void TextureLoader::stop()
+{
+	// let the workers run out of jobs, then drop anything that was never collected
+	next_job = job_count;
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+
+	std::lock_guard<std::mutex> lock(results_mutex);
+	for (DecodedTexture& decoded : results) {
+		decoded.release();
+	}
+	results.clear();
+}
+
+void TextureLoader::workerLoop()
+{
+	while (true) {
+		const size_t job = next_job++;
+		if (job >= job_count) {
+			return;
+		}
+
+		DecodedTexture decoded;
+		decoded.index = order[job];
+
+		const std::string& path = paths[decoded.index];
+
+		auto start = std::chrono::high_resolution_clock::now();
+		MappedFile source;
+		if (source.open(path)) {
+			const uint64_t source_hash = content_hash(source.data(), source.size());
+			decoded.cooked_pixels = std::make_shared<std::vector<unsigned char>>();
+			decoded.cooked = TextureCache::load(path, source_hash, *decoded.cooked_pixels, decoded.dimensions);
+			decoded.data = decoded.cooked_pixels->data();
+
+			if (!decoded.cooked) {
+				decoded.cooked_pixels.reset();
+				decoded.stbi_data = stbi_load_from_memory(source.data(), (int)source.size(),
+					&decoded.dimensions.x, &decoded.dimensions.y, NULL, 4);
+				decoded.data = decoded.stbi_data;
+				if (decoded.data != nullptr && !TextureCache::store(path, source_hash, decoded.data, decoded.dimensions)) {
+					fprintf(stderr, "Could not cook %s\n", path.c_str());
+				}
+			}
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		decoded.decode_ms = std::chrono::duration<float, std::milli>(end - start).count();
+
+		{
+			std::lock_guard<std::mutex> lock(results_mutex);
+			results.push_back(decoded);
+		}
+		results_ready.notify_one();
+	}
+}
+
+bool TextureLoader::poll(DecodedTexture& decoded)
+{
+	std::lock_guard<std::mutex> lock(results_mutex);
+	if (results.empty()) {
+		return false;
+	}
+	decoded = results.front();
+	results.pop_front();
+	handed_out++;
+	return true;
+}
+
+bool TextureLoader::wait(DecodedTexture& decoded)
+{
+	std::unique_lock<std::mutex> lock(results_mutex);
+	if (handed_out == job_count) {
+		return false;
+	}
+	results_ready.wait(lock, [this] { return !results.empty(); });
+	decoded = results.front();
+	results.pop_front();
+	handed_out++;
+	return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../common.hpp"
+
+// One image decoded by a worker, waiting to be uploaded on the GL thread
+struct DecodedTexture {
+	int index = -1;
+	const unsigned char* data = nullptr;	// RGBA8, valid until release()
+	ivec2 dimensions = { 0, 0 };
+	float decode_ms = 0.f;
+	bool cooked = false;					// read from the texture cache instead of decoded
+
+	unsigned char* stbi_data = nullptr;
+	std::shared_ptr<std::vector<unsigned char>> cooked_pixels;
+
+	void release();
+};
+
+// Decodes image files on a pool of worker threads. Jobs are taken in the given order and
+// results are handed back in completion order; GL uploads stay with the caller.
+// Images with an up-to-date cooked copy are read from it instead of decoded; the others are decoded
+// with stbi and cooked for the next launch.
+class TextureLoader {
+public:
+	~TextureLoader() { stop(); }
+
+	void start(const std::vector<std::string>& paths, const std::vector<int>& order, int worker_count);
+	void stop();
+
+	// Non-blocking; false when nothing has finished decoding yet
+	bool poll(DecodedTexture& decoded);
+	// Blocks until a result is available; false once every job has been handed out
+	bool wait(DecodedTexture& decoded);
+
+	bool done() const { return handed_out == job_count; }
+
+private:
+	void workerLoop();
+
+	std::vector<std::string> paths;
+	std::vector<int> order;
+	std::atomic<size_t> next_job{ 0 };
+	size_t job_count = 0;
+	size_t handed_out = 0;
+
+	std::mutex results_mutex;
+	std::condition_variable results_ready;
+	std::deque<DecodedTexture> results;
+
+	std::vector<std::thread> workers;
+};
@@ -71,6 +71,7 @@ void SpawnPointSystem::activate_spawnpoint(Entity entity) {
 	// Particle effects
 	const vec2& spawnpoint_pos = registry.motions.get(entity).position;
 
+	ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::SPAWNPOINT);
 	for (int i = 0; i < 30; i++) {
 		vec2 position = random_sample_ellipse(spawnpoint_pos - vec2{ 0.0f, 0.25f * SPAWNPOINT_SCALE.y }, SPAWNPOINT_SCALE * 0.5f);
 		vec2 vel = random_sample_ellipse(vec2(0.0f), vec2(1.0f)) * 100.0f;
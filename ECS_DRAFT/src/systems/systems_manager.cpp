@@ -1,5 +1,6 @@
 #include "systems_manager.hpp"
 #include "../common.hpp"
+#include "../frame_arena.hpp"
 #include <iostream>
 #include <chrono>
 
@@ -32,12 +33,19 @@ void SystemsManager::run_game_loop() {
 
 
 	while (!is_over()) {
+		// temporaries of the previous frame are dead by now
+		frame_arena.reset();
+
 		glfwPollEvents();
 
 		auto now = Clock::now();
 		float elapsed_ms = (float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count() / 1000;
 		t = now;
 
+		if (frame_stats) {
+			update_frame_stats(elapsed_ms);
+		}
+
 		GameState& gs = registry.gameStates.components[0];
 
 
@@ -124,6 +132,31 @@ void SystemsManager::run_game_loop() {
 	}
 }
 
+void SystemsManager::update_frame_stats(float elapsed_ms) {
+	if (frame_stats_frames == 0) {
+		frame_stats_heap_mark = heap_allocation_count();
+	}
+	frame_stats_frames++;
+	frame_stats_timer_ms += elapsed_ms;
+
+	if (frame_stats_timer_ms >= FRAME_STATS_INTERVAL_MS) {
+		// the marking frame is not counted, its allocations happened before the mark
+		const int frames = frame_stats_frames - 1;
+		const size_t heap_allocations = heap_allocation_count() - frame_stats_heap_mark;
+		if (heap_allocations_counted) {
+			printf("Frame: %.2f heap allocations/frame over %d frames, arena %zu of %zu bytes used\n",
+				frames > 0 ? (double)heap_allocations / frames : 0.0, frames, frame_arena.highWater(), frame_arena.capacity());
+		}
+		else {
+			printf("Frame: %d frames, arena %zu of %zu bytes used (heap allocations need TIMELOCK_FRAME_STATS)\n",
+				frames, frame_arena.highWater(), frame_arena.capacity());
+		}
+
+		frame_stats_frames = 0;
+		frame_stats_timer_ms = 0.0f;
+	}
+}
+
 void SystemsManager::register_system(ISystem* system) {
     systems.push_back(system);
     system->init(this->window);
@@ -21,8 +21,18 @@ class SystemsManager
     GLFWwindow* get_window() const {return window;};
 
     bool is_over() const;
+
+    // Prints heap allocations per frame and the frame arena's size every few seconds
+    void set_frame_stats(bool enabled) { frame_stats = enabled; }
   private:
     std::vector<ISystem*> systems;
     std::vector<ISystem*> fixed_systems;
     GLFWwindow* window = nullptr;
+
+    void update_frame_stats(float elapsed_ms);
+
+    bool frame_stats = false;
+    float frame_stats_timer_ms = 0.0f;
+    int frame_stats_frames = 0;
+    size_t frame_stats_heap_mark = 0;
 };
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "entity_pool.hpp"
+
+Entity EntityPools::acquire(ENTITY_POOL_ID pool) {
+	std::vector<unsigned int>& entities = parked[(int)pool];
+
+	while (!entities.empty()) {
+		Entity entity = Entity(entities.back());
+		entities.pop_back();
+
+		// the registry may have been flushed since the entity was parked
+		if (registry.inactives.has(entity)) {
+			activate_entity(entity);
+			return entity;
+		}
+	}
+
+	Entity entity = Entity();
+	registry.pooleds.emplace(entity, Pooled{ pool });
+	return entity;
+}
+
+void EntityPools::destroy(Entity entity) {
+	if (!registry.pooleds.has(entity)) {
+		registry.remove_all_components_of(entity);
+		return;
+	}
+	// several collisions may destroy the same entity in one step
+	if (!is_active(entity)) {
+		return;
+	}
+
+	std::vector<unsigned int>& entities = parked[(int)registry.pooleds.get(entity).pool];
+	if ((int)entities.size() >= ENTITY_POOL_CAPACITY) {
+		registry.remove_all_components_of(entity);
+		return;
+	}
+
+	deactivate_entity(entity);
+	entities.push_back(entity.id());
+}
+
+void EntityPools::clear() {
+	for (std::vector<unsigned int>& entities : parked) {
+		entities.clear();
+	}
+}
+
+void destroy_spawned_entities(Entity owner) {
+	if (registry.obstacleSpawners.has(owner)) {
+		ObstacleSpawner& spawner = registry.obstacleSpawners.get(owner);
+		for (unsigned int obstacle : { spawner.obstacle_id, spawner.parked_obstacle_id }) {
+			if (obstacle != 0) {
+				registry.remove_all_components_of(Entity(obstacle));
+			}
+		}
+		spawner.obstacle_id = 0;
+		spawner.parked_obstacle_id = 0;
+	}
+
+	if (registry.rollingThings.has(owner)) {
+		RollingThing& rolling_thing = registry.rollingThings.get(owner);
+		for (int i = 0; i < rolling_thing.platform_count; i++) {
+			EntityPools::destroy(Entity(rolling_thing.platforms[(rolling_thing.first_platform + i) % ROLLING_PLATFORM_RING_SIZE].platform));
+		}
+		rolling_thing.platform_count = 0;
+	}
+
+	// parked entities keep the owner of their last life, only live ones are still owned; backwards,
+	// as destroying one may remove it from the container
+	for (int i = (int)registry.pooleds.size() - 1; i >= 0; i--) {
+		const Entity entity = registry.pooleds.entities[i];
+		Pooled& pooled = registry.pooleds.components[i];
+		if (pooled.owner == owner.id() && is_active(entity)) {
+			pooled.owner = 0;
+			EntityPools::destroy(entity);
+		}
+	}
+}
+
+void deactivate_entity(Entity entity) {
+	if (!is_active(entity)) {
+		return;
+	}
+	registry.inactives.emplace(entity);
+
+	// state other systems attach over an entity's life
+	registry.onGrounds.remove(entity);
+	registry.delayeds.remove(entity);
+}
+
+void activate_entity(Entity entity) {
+	registry.inactives.remove(entity);
+}
+
+void reset_component(Motion& motion) {
+	std::vector<vec2> cached_vertices = std::move(motion.cached_vertices);
+	std::vector<vec2> cached_axes = std::move(motion.cached_axes);
+	cached_vertices.clear();
+	cached_axes.clear();
+
+	motion = Motion();
+	motion.cached_vertices = std::move(cached_vertices);
+	motion.cached_axes = std::move(cached_axes);
+}
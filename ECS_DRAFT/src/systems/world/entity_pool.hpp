@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "../../common.hpp"
+#include "../../tinyECS/registry.hpp"
+
+// Recycles short-lived entities. Instead of removing every component, destroy() parks a pooled
+// entity as Inactive with its components in place; acquire() hands it back to the next spawn of
+// the same kind, which resets the components through reuse_component().
+class EntityPools {
+public:
+	// A parked entity of the pool, reactivated, or a new entity tagged with the pool
+	static Entity acquire(ENTITY_POOL_ID pool);
+	// Parks pooled entities (destroys them if their pool is full); destroys anything else
+	static void destroy(Entity entity);
+
+	// Forget parked entities, e.g. after the registry was flushed
+	static void clear();
+
+private:
+	inline static std::array<std::vector<unsigned int>, entity_pool_count> parked;
+};
+
+inline bool is_active(Entity entity) {
+	return !registry.inactives.has(entity);
+}
+
+void deactivate_entity(Entity entity);
+void activate_entity(Entity entity);
+
+// Destroys what an entity spawned over its life and still owns: a spawner's obstacles, a rolling
+// thing's platforms and a cannon's bolts. Call it before removing the owner itself.
+void destroy_spawned_entities(Entity owner);
+
+template <typename Component>
+void reset_component(Component& component) {
+	component = Component();
+}
+
+// Keeps the vertex caches' storage
+void reset_component(Motion& motion);
+
+// The entity's component in its default state, reusing the one a recycled entity still has
+template <typename Component>
+Component& reuse_component(ComponentContainer<Component>& container, Entity entity) {
+	if (container.has(entity)) {
+		Component& component = container.get(entity);
+		reset_component(component);
+		return component;
+	}
+	return container.emplace(entity);
+}
@@ -0,0 +1,9 @@
+#include "prefab.hpp"
+
+unsigned int Prefab::instantiate(unsigned int count) const {
+	const unsigned int first_id = Entity::create_range(count);
+	for (const auto& stamp : stamps) {
+		stamp(first_id, count);
+	}
+	return first_id;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "../../tinyECS/registry.hpp"
+
+// Component values shared by every instance of an entity kind, defined once and stamped onto
+// new entities. instantiate(count) takes count consecutive ids and appends each component to its
+// container in one block, so a batch of tiles costs copies rather than one insert per component.
+// Per instance fields are patched afterwards through the containers' get().
+class Prefab {
+public:
+	template <typename Component>
+	Prefab& with(ComponentContainer<Component>& container, const Component& value = Component()) {
+		stamps.push_back([&container, value](unsigned int first_id, unsigned int count) {
+			container.insert_range(first_id, count, value);
+		});
+		return *this;
+	}
+
+	// Returns the id of the first new entity; the others follow it
+	unsigned int instantiate(unsigned int count) const;
+	Entity instantiate() const { return Entity(instantiate(1)); }
+
+private:
+	std::vector<std::function<void(unsigned int first_id, unsigned int count)>> stamps;
+};
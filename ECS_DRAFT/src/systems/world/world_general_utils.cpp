@@ -1,5 +1,6 @@
 #include "world_system.hpp"
 #include "world_init.hpp"
+#include "entity_pool.hpp"
 
 
 // Player motions
@@ -104,6 +105,7 @@ void WorldSystem::crack_breakable_platform(Entity entity) {
 			starting_pos = vec2{motion.position.x, motion.position.y - 0.5f * motion.scale.y + crack_size.y * 0.5f};
 		}
 
+		ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::CRACKS);
 		for (int i = 0; i < crack_count; i++) {
 			vec2 crack_pos = starting_pos + ((float)i) * advance_step;
 
@@ -120,8 +122,7 @@ void WorldSystem::crack_breakable_platform(Entity entity) {
 		// Update cracks
 		float break_progress = 1.0f - std::clamp(breakable.health/BREAKABLE_WALL_HEALTH, 0.0f, 1.0f);
 		for (unsigned int par_id : breakable.cracking_particles) {
-			AnimateRequest& anim = registry.animateRequests.get(par_id);
-			anim.timer = break_progress;
+			ParticleSystem::set_animation_timer(par_id, break_progress);
 		}
 	}
 }
@@ -132,6 +133,7 @@ void WorldSystem::destroy_breakable_platform(Entity entity) {
 	const int fragment_count = (int)(motion.scale.x * motion.scale.y / (fragment_size * fragment_size)) + 1;
 	const vec2 player_pos = registry.motions.get(registry.players.entities[0]).position;
 
+	ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::IMPACT);
 	// Fragments
 	for (int i = 0; i < fragment_count; i++) {
 		vec2 fragment_position = random_sample_rectangle(motion.position, motion.scale);
@@ -158,7 +160,7 @@ void WorldSystem::destroy_breakable_platform(Entity entity) {
 	// Clear cracks
 	Breakable& breakable = registry.breakables.get(entity);
 	for (unsigned int par_id : breakable.cracking_particles) {
-		registry.remove_all_components_of(Entity(par_id));
+		ParticleSystem::remove_particle(par_id);
 	}
 	breakable.cracking_particles.clear();
 
@@ -181,6 +183,7 @@ void WorldSystem::destroy_projectile(Entity entity) {
 		const float fragment_size = std::min(std::min(motion.scale.x, motion.scale.y), (float)TILE_TO_PIXELS);
 		const int fragment_count = (int)(motion.scale.x * motion.scale.y / (fragment_size * fragment_size)) + 1;
 
+		ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::IMPACT);
 		// Fragments
 		for (int i = 0; i < fragment_count; i++) {
 			vec2 fragment_position = random_sample_rectangle(motion.position, motion.scale);
@@ -205,5 +208,5 @@ void WorldSystem::destroy_projectile(Entity entity) {
 		}
 	}
 
-	registry.remove_all_components_of(entity);
+	EntityPools::destroy(entity);
 }
\ No newline at end of file
@@ -4,6 +4,40 @@
 #include <iostream>
 
 #include "../../tinyECS/registry.hpp"
+#include "entity_pool.hpp"
+#include "../rendering/mesh_cache.hpp"
+#include "prefab.hpp"
+
+// Tiles drawn for a parent platform, ladder or door; the parent and tile id are set per instance
+static const Prefab& tile_prefab() {
+    static const Prefab prefab = Prefab()
+        .with(registry.tiles)
+        .with(registry.renderRequests, { TEXTURE_ASSET_ID::TILE, EFFECT_ASSET_ID::TILE, GEOMETRY_BUFFER_ID::SPRITE })
+        .with(registry.layers, { LAYER_ID::MIDGROUND });
+    return prefab;
+}
+
+// A single tile that is its own collider
+static const Prefab& spike_prefab() {
+    static const Prefab prefab = Prefab()
+        .with(registry.spikes)
+        .with(registry.motions)
+        .with(registry.nonPhysicsColliders)
+        .with(registry.tiles)
+        .with(registry.renderRequests, { TEXTURE_ASSET_ID::TILE, EFFECT_ASSET_ID::TILE, GEOMETRY_BUFFER_ID::SPRITE })
+        .with(registry.layers, { LAYER_ID::MIDGROUND });
+    return prefab;
+}
+
+// A single decorative tile
+static const Prefab& partof_prefab() {
+    static const Prefab prefab = Prefab()
+        .with(registry.motions)
+        .with(registry.tiles)
+        .with(registry.renderRequests, { TEXTURE_ASSET_ID::TILE, EFFECT_ASSET_ID::TILE, GEOMETRY_BUFFER_ID::SPRITE })
+        .with(registry.layers, { LAYER_ID::MIDGROUND });
+    return prefab;
+}
 
 
 Entity create_player(vec2 position, vec2 scale) {
@@ -101,7 +135,7 @@ Entity create_physics_object(vec2 position, vec2 scale, float mass) {
     return entity;
 }
 
-Entity create_moving_platform(vec2 scale, std::vector<Path> movements, vec2 initial_position, json& tile_id_array, int stride, bool rounded) {
+Entity create_moving_platform(vec2 scale, std::vector<Path> movements, vec2 initial_position, const LevelTiles& tiles, bool rounded) {
     Entity entity = Entity();
 
     Motion& motion = registry.motions.emplace(entity);
@@ -125,23 +159,12 @@ Entity create_moving_platform(vec2 scale, std::vector<Path> movements, vec2 init
     int num_tiles = scale.x / TILE_TO_PIXELS; // only allows for 1 tile tall platforms atm
     int starting_tile_pos = initial_position.x - (0.5 * scale.x) + (0.5 * TILE_TO_PIXELS);
 
+    const unsigned int first_tile_id = tile_prefab().instantiate(num_tiles);
     for (int i = 0; i < num_tiles; i++) {
-        Entity tile_entity = Entity();
-
-        int tile_arr_index = get_tile_index(starting_tile_pos, initial_position.y, i, 0, stride);
-
-        Tile &tile_component = registry.tiles.emplace(tile_entity);
+        Tile &tile_component = registry.tiles.get(first_tile_id + i);
         tile_component.offset.x = i;
         tile_component.parent_id = entity.id();
-        tile_component.id = tile_id_array[tile_arr_index];
-
-        registry.renderRequests.insert(tile_entity, {
-                                           TEXTURE_ASSET_ID::TILE,
-                                           EFFECT_ASSET_ID::TILE,
-                                           GEOMETRY_BUFFER_ID::SPRITE
-                                       });
-
-        registry.layers.insert(tile_entity, {LAYER_ID::MIDGROUND});
+        tile_component.id = tiles.at(starting_tile_pos, initial_position.y, i, 0);
     }
 
     if (rounded) {
@@ -152,11 +175,17 @@ Entity create_moving_platform(vec2 scale, std::vector<Path> movements, vec2 init
     return entity;
 }
 
-Entity create_static_platform(vec2 position, vec2 scale, json &tile_id_array, int stride, bool rounded) {
-    Entity entity = Entity();
+int platform_tile_count(vec2 scale) {
+    return scale.x / TILE_TO_PIXELS; // only allows for 1 tile tall platforms atm
+}
 
-    registry.platforms.emplace(entity);
+int platform_tile_id(vec2 position, vec2 scale, const LevelTiles& tiles, int index) {
+    int starting_tile_pos = position.x - (0.5 * scale.x) + (0.5 * TILE_TO_PIXELS);
+    return tiles.at(starting_tile_pos, position.y, index, 0);
+}
 
+Entity create_platform_tiles(vec2 position, vec2 scale, const LevelTiles& tiles) {
+    Entity entity = Entity();
 
     Motion &motion = registry.motions.emplace(entity);
     motion.position = position;
@@ -164,46 +193,70 @@ Entity create_static_platform(vec2 position, vec2 scale, json &tile_id_array, in
     motion.velocity = {0, 0};
     motion.angle = 0;
 
-    PhysicsObject& physics_object = registry.physicsObjects.emplace(entity);
-    physics_object.apply_gravity = false;
-    physics_object.mass = 0.0f;
-    physics_object.apply_rotation = false;
-    physics_object.friction = 0.25;
-
-    int num_tiles = scale.x / TILE_TO_PIXELS; // only allows for 1 tile tall platforms atm
-    int starting_tile_pos = position.x - (0.5 * scale.x) + (0.5 * TILE_TO_PIXELS);
+    int num_tiles = platform_tile_count(scale);
 
+    const unsigned int first_tile_id = tile_prefab().instantiate(num_tiles);
     for (int i = 0; i < num_tiles; i++) {
-        Entity tile_entity = Entity();
+        Tile &tile_component = registry.tiles.get(first_tile_id + i);
+        tile_component.offset.x = i;
+        tile_component.parent_id = entity.id();
+        tile_component.id = platform_tile_id(position, scale, tiles, i);
+    }
 
-        int tile_arr_index = get_tile_index(starting_tile_pos, position.y, i, 0, stride);
+    return entity;
+}
 
+Entity create_platform_tiles(vec2 position, vec2 scale, const int* tile_ids) {
+    Entity entity = Entity();
 
-        Tile &tile_component = registry.tiles.emplace(tile_entity);
+    Motion &motion = registry.motions.emplace(entity);
+    motion.position = position;
+    motion.scale = scale;
+    motion.velocity = {0, 0};
+    motion.angle = 0;
+
+    int num_tiles = platform_tile_count(scale);
+
+    const unsigned int first_tile_id = tile_prefab().instantiate(num_tiles);
+    for (int i = 0; i < num_tiles; i++) {
+        Tile &tile_component = registry.tiles.get(first_tile_id + i);
         tile_component.offset.x = i;
         tile_component.parent_id = entity.id();
-        tile_component.id = tile_id_array[tile_arr_index];
+        tile_component.id = tile_ids[i];
+    }
 
+    return entity;
+}
 
-        registry.renderRequests.insert(tile_entity, {
-                                           TEXTURE_ASSET_ID::TILE,
-                                           EFFECT_ASSET_ID::TILE,
-                                           GEOMETRY_BUFFER_ID::SPRITE
-                                       });
+Entity create_static_collider(vec2 position, vec2 scale) {
+    Entity entity = Entity();
 
-        registry.layers.insert(tile_entity, {LAYER_ID::MIDGROUND});
-    }
+    EntitySink sink = { entity };
+    static_collider_components(sink, position, scale);
+
+    return entity;
+}
+
+Entity create_static_platform(vec2 position, vec2 scale, const LevelTiles& tiles, bool rounded) {
+    Entity entity = create_platform_tiles(position, scale, tiles);
+
+    registry.platforms.emplace(entity);
+
+    PhysicsObject& physics_object = registry.physicsObjects.emplace(entity);
+    physics_object.apply_gravity = false;
+    physics_object.mass = 0.0f;
+    physics_object.apply_rotation = false;
+    physics_object.friction = 0.25;
 
     if (rounded) {
         PlatformGeometry &platform_geometry = registry.platformGeometries.emplace(entity);
-        platform_geometry.num_tiles = num_tiles;
+        platform_geometry.num_tiles = (int)(scale.x / TILE_TO_PIXELS);
     }
 
-
     return entity;
 }
 
-Entity create_ladder(vec2 position, vec2 scale, int height, json tile_id_array, int stride) {
+Entity create_ladder(vec2 position, vec2 scale, int height, const LevelTiles& tiles) {
     Entity entity = Entity();
     registry.ladders.emplace(entity);
     Motion& motion = registry.motions.emplace(entity);
@@ -216,22 +269,12 @@ Entity create_ladder(vec2 position, vec2 scale, int height, json tile_id_array,
     registry.nonPhysicsColliders.emplace(entity);
 
     int start_tile_y = motion.position.y - (0.5 * ladder_scale.y) + (0.5 * TILE_TO_PIXELS);
+    const unsigned int first_tile_id = tile_prefab().instantiate(height);
     for (int i = 0; i < height; i++) {
-        Entity tile_entity = Entity();
-        int tile_arr_index = get_tile_index(position.x, start_tile_y, 0, i, stride);
-
-        Tile& tile_component = registry.tiles.emplace(tile_entity);
+        Tile& tile_component = registry.tiles.get(first_tile_id + i);
         tile_component.offset.y = i;
         tile_component.parent_id = entity.id();
-        tile_component.id = tile_id_array[tile_arr_index];
-
-        registry.renderRequests.insert(tile_entity, {
-                                           TEXTURE_ASSET_ID::TILE,
-                                           EFFECT_ASSET_ID::TILE,
-                                           GEOMETRY_BUFFER_ID::SPRITE
-                                       });
-
-        registry.layers.insert(tile_entity, {LAYER_ID::MIDGROUND});
+        tile_component.id = tiles.at(position.x, start_tile_y, 0, i);
     }
 
     return entity;
@@ -240,19 +283,8 @@ Entity create_ladder(vec2 position, vec2 scale, int height, json tile_id_array,
 Entity create_level_boundary(vec2 position, vec2 scale) {
     Entity entity = Entity();
 
-    registry.platforms.emplace(entity);
-
-    PhysicsObject& physics_object = registry.physicsObjects.emplace(entity);
-    physics_object.apply_gravity = false;
-    physics_object.apply_rotation = false;
-    physics_object.mass = 0.0f;
-    physics_object.friction = 0.5;
-
-    Motion &motion = registry.motions.emplace(entity);
-    motion.position = position;
-    motion.scale = scale;
-    motion.velocity = {0, 0};
-    motion.angle = 0;
+    EntitySink sink = { entity };
+    level_boundary_components(sink, position, scale);
 
     return entity;
 }
@@ -276,14 +308,8 @@ Entity create_world_boundary(vec2 position, vec2 scale) {
 Entity create_clock_hole(vec2 position, vec2 scale) {
     Entity entity = Entity();
 
-    Motion& motion = registry.motions.emplace(entity);
-    motion.position = position;
-    motion.scale = scale;
-    motion.velocity = {0, 0};
-    motion.angle = 0;
-
-    registry.nonPhysicsColliders.emplace(entity);
-    registry.clockHoles.emplace(entity);
+    EntitySink sink = { entity };
+    clock_hole_components(sink, position, scale);
 
     return entity;
 }
@@ -394,81 +420,74 @@ Entity create_tutorial_text(vec2 position, vec2 size, TEXTURE_ASSET_ID texture_i
 
 Entity create_projectile(vec2 pos, vec2 size, vec2 velocity, bool delayed)
 {
-	auto entity = Entity();
+	Entity entity = EntityPools::acquire(delayed ? ENTITY_POOL_ID::DELAYED_PROJECTILE : ENTITY_POOL_ID::PROJECTILE);
 
-	Projectile& projectile = registry.projectiles.emplace(entity);
+	reuse_component(registry.projectiles, entity);
 
-	Motion& motion = registry.motions.emplace(entity);
+	Motion& motion = reuse_component(registry.motions, entity);
 	motion.angle = 0.f;
 	motion.velocity = velocity;
 	motion.position = pos;
 	motion.scale = size;
 
-    TimeControllable& tc = registry.timeControllables.emplace(entity);
+    TimeControllable& tc = reuse_component(registry.timeControllables, entity);
     tc.can_become_harmless = true;
     tc.can_be_decelerated = true;
 
     assert(registry.gameStates.components.size() <= 1);
     GameState& gameState = registry.gameStates.components[0];
     if (gameState.game_time_control_state != TIME_CONTROL_STATE::DECELERATED) {
-        Harmful& harmful = registry.harmfuls.emplace(entity);
+        reuse_component(registry.harmfuls, entity);
+    } else {
+        registry.harmfuls.remove(entity);
     }
 
-    registry.nonPhysicsColliders.emplace(entity);
+    reuse_component(registry.nonPhysicsColliders, entity);
 
-    registry.renderRequests.insert(
-		entity,
-		{
-			delayed ? TEXTURE_ASSET_ID::BOLT2 : TEXTURE_ASSET_ID::BOLT3,
-			EFFECT_ASSET_ID::HEX,
-			GEOMETRY_BUFFER_ID::OCTA
-		}
-	);
+    reuse_component(registry.renderRequests, entity) = {
+		delayed ? TEXTURE_ASSET_ID::BOLT2 : TEXTURE_ASSET_ID::BOLT3,
+		EFFECT_ASSET_ID::HEX,
+		GEOMETRY_BUFFER_ID::OCTA
+	};
 
-    registry.layers.insert(entity, { LAYER_ID::MIDGROUND });
+    reuse_component(registry.layers, entity) = { LAYER_ID::MIDGROUND };
 
 	return entity;
 }
 
 Entity create_bolt(vec2 pos, vec2 size, vec2 velocity, bool default_gravity, bool harmful)
 {
-	auto entity = Entity();
-	Motion& motion = registry.motions.emplace(entity);
+	Entity entity = EntityPools::acquire(harmful ? ENTITY_POOL_ID::HARMFUL_BOLT : ENTITY_POOL_ID::BOLT);
+	Motion& motion = reuse_component(registry.motions, entity);
 	motion.angle = 0.f;
 	motion.velocity = velocity;
 	motion.position = pos;
 	motion.scale = size;
 
-    PhysicsObject& object = registry.physicsObjects.emplace(entity);
+    PhysicsObject& object = reuse_component(registry.physicsObjects, entity);
     object.mass = 25.0f;
     object.apply_gravity = default_gravity;
     object.apply_rotation = false;
     object.friction = BOLT_FRICTION;
     object.drag_coefficient = 0.01;
 
-    registry.bolts.emplace(entity);
+    reuse_component(registry.bolts, entity);
 
     if (harmful) {
-       TimeControllable& tc = registry.timeControllables.emplace(entity);
+       TimeControllable& tc = reuse_component(registry.timeControllables, entity);
        tc.can_become_harmless = true;
-        registry.harmfuls.emplace(entity);
+        reuse_component(registry.harmfuls, entity);
     }
 
-    registry.colors.insert(
-        entity, 
-        { 1.0f, 1.0f, 1.0f }
-    );
+    reuse_component(registry.colors, entity) = { 1.0f, 1.0f, 1.0f };
 
-    registry.renderRequests.insert(
-        entity,
-        {
-            TEXTURE_ASSET_ID::HEX,
-			EFFECT_ASSET_ID::HEX,
-			GEOMETRY_BUFFER_ID::HEX
-		}
-	);
+    reuse_component(registry.renderRequests, entity) = {
+        TEXTURE_ASSET_ID::HEX,
+		EFFECT_ASSET_ID::HEX,
+		GEOMETRY_BUFFER_ID::HEX
+	};
 
-    registry.layers.insert(entity, { LAYER_ID::MIDGROUND });
+    reuse_component(registry.layers, entity) = { LAYER_ID::MIDGROUND };
 
 	return entity;
 }
@@ -520,21 +539,8 @@ Entity create_first_boss_test() {
 Entity create_spawnpoint(vec2 pos, vec2 size) {
     Entity entity = Entity();
 
-    SpawnPoint& spawnpoint = registry.spawnPoints.emplace(entity);
-    Motion& motion = registry.motions.emplace(entity);
-    motion.position = pos;
-    motion.scale = size;
-
-    registry.renderRequests.insert(
-        entity,
-        {
-            TEXTURE_ASSET_ID::SPAWNPOINT_UNVISITED,
-            EFFECT_ASSET_ID::TEXTURED,
-            GEOMETRY_BUFFER_ID::SPRITE
-        }
-    );
-
-    registry.layers.insert(entity, { LAYER_ID::MIDGROUND });
+    EntitySink sink = { entity };
+    spawnpoint_components(sink, pos, size);
 
     return entity;
 }
@@ -583,34 +589,19 @@ Entity create_cannon_tower(vec2 pos) {
     return entity;
 }
 
-Entity create_spike(vec2 position, vec2 scale, json tile_id_array, int stride) {
-    Entity entity = Entity();
-
-    registry.spikes.emplace(entity);
+Entity create_spike(vec2 position, vec2 scale, const LevelTiles& tiles) {
+    Entity entity = spike_prefab().instantiate();
 
-    Motion& motion = registry.motions.emplace(entity);
+    Motion& motion = registry.motions.get(entity);
     motion.position = position;
     motion.scale = scale;
     motion.velocity = {0, 0};
     motion.angle = 0.f;
 
-
-    registry.nonPhysicsColliders.emplace(entity);
-
-    int tile_arr_index = get_tile_index(position.x, position.y, 0, 0, stride);
-
-    Tile& tile_component = registry.tiles.emplace(entity);
+    Tile& tile_component = registry.tiles.get(entity);
     tile_component.offset.x = 0;
     tile_component.parent_id = entity.id();
-    tile_component.id = tile_id_array[tile_arr_index];
-
-    registry.renderRequests.insert(entity, {
-            TEXTURE_ASSET_ID::TILE,
-            EFFECT_ASSET_ID::TILE,
-            GEOMETRY_BUFFER_ID::SPRITE
-        });
-
-    registry.layers.insert(entity, { LAYER_ID::MIDGROUND });
+    tile_component.id = tiles.at(position.x, position.y);
 
     return entity;
 }
@@ -618,34 +609,33 @@ Entity create_spike(vec2 position, vec2 scale, json tile_id_array, int stride) {
 
 
 
-Entity create_partof(vec2 position, vec2 scale, json tile_id_array, int stride) {
+Entity create_spike_collider(vec2 position, vec2 scale) {
     Entity entity = Entity();
 
-    Motion& motion = registry.motions.emplace(entity);
+    EntitySink sink = { entity };
+    spike_collider_components(sink, position, scale);
+
+    return entity;
+}
+
+Entity create_partof(vec2 position, vec2 scale, int tile_id) {
+    Entity entity = partof_prefab().instantiate();
+
+    Motion& motion = registry.motions.get(entity);
     motion.position = position;
     motion.scale = scale;
     motion.angle = 0.0f;
     motion.velocity = {0.0f, 0.0f};
 
-    int tile_arr_index = get_tile_index(position.x, position.y, 0, 0, stride);
-
-    Tile& tile_component = registry.tiles.emplace(entity);
+    Tile& tile_component = registry.tiles.get(entity);
     tile_component.offset.x = 0;
     tile_component.parent_id = entity.id();
-    tile_component.id = tile_id_array[tile_arr_index];
-
-    registry.renderRequests.insert(entity, {
-            TEXTURE_ASSET_ID::TILE,
-            EFFECT_ASSET_ID::TILE,
-            GEOMETRY_BUFFER_ID::SPRITE
-        });
-
-    registry.layers.insert(entity, { LAYER_ID::MIDGROUND });
+    tile_component.id = tile_id;
 
     return entity;
 }
 
-Entity create_breakable_static_platform(vec2 position, vec2 scale, bool should_break_instantly, float degrade_speed, bool is_time_controllable, json& tile_id_array, int stride) {
+Entity create_breakable_static_platform(vec2 position, vec2 scale, bool should_break_instantly, float degrade_speed, bool is_time_controllable) {
     Entity entity = Entity();
 
     Motion& motion = registry.motions.emplace(entity);
@@ -678,8 +668,8 @@ Entity create_breakable_static_platform(vec2 position, vec2 scale, bool should_b
     return entity;
 }
 
-Entity create_time_controllable_breakable_static_platform(vec2 position, vec2 scale, bool should_break_instantly, float degrade_speed, json& tile_id_array, int stride) {
-    Entity entity = create_breakable_static_platform(position, scale, should_break_instantly, degrade_speed,  true,  tile_id_array, stride);
+Entity create_time_controllable_breakable_static_platform(vec2 position, vec2 scale, bool should_break_instantly, float degrade_speed) {
+    Entity entity = create_breakable_static_platform(position, scale, should_break_instantly, degrade_speed,  true);
 
     TimeControllable& timeControllable = registry.timeControllables.emplace(entity);
     timeControllable.can_be_accelerated = true;
@@ -691,7 +681,7 @@ Entity create_time_controllable_breakable_static_platform(vec2 position, vec2 sc
     return entity;
 }
 
-Entity create_door(vec2 position, bool open, json& tile_id_array, int stride) {
+Entity create_door(vec2 position, bool open, const LevelTiles& tiles) {
     Entity entity = Entity();
 
     Motion& motion = registry.motions.emplace(entity);
@@ -713,31 +703,20 @@ Entity create_door(vec2 position, bool open, json& tile_id_array, int stride) {
         position.y - (0.5 * DOOR_SIZE.y) + (0.5 * TILE_TO_PIXELS)
     };
 
+    unsigned int tile_id = tile_prefab().instantiate(width_in_tiles * height_in_tiles);
     for (int i = 0; i < width_in_tiles; i++) {
         for (int j = 0; j < height_in_tiles; j++) {
-            Entity tile_entity = Entity();
-
-            int tile_arr_index = get_tile_index(first_tile_pos.x, first_tile_pos.y, i, j, stride);
-
-            Tile& tile_component = registry.tiles.emplace(tile_entity);
+            Tile& tile_component = registry.tiles.get(tile_id++);
             tile_component.offset = {i, j};
             tile_component.parent_id = entity.id();
-            tile_component.id = tile_id_array[tile_arr_index];
-
-            registry.renderRequests.insert(tile_entity, {
-                TEXTURE_ASSET_ID::TILE,
-                EFFECT_ASSET_ID::TILE,
-                GEOMETRY_BUFFER_ID::SPRITE
-            });
-
-            registry.layers.insert(tile_entity, { LAYER_ID::MIDGROUND });
+            tile_component.id = tiles.at(first_tile_pos.x, first_tile_pos.y, i, j);
         }
     }
 
     return entity;
 }
 
-Entity create_pipe_head(vec2 position, vec2 scale, std::string direction, json& tile_id_array, int stride, float firing_offset) {
+Entity create_pipe_head(vec2 position, vec2 scale, std::string direction, const LevelTiles& tiles, float firing_offset) {
     Entity entity = Entity();
 
     Motion& motion = registry.motions.emplace(entity);
@@ -760,12 +739,10 @@ Entity create_pipe_head(vec2 position, vec2 scale, std::string direction, json&
     // to influence firing frequency; maybe should not include this
     registry.timeControllables.emplace(entity);
 
-    int tile_arr_index = get_tile_index(position.x, position.y, 0, 0, stride);
-
     Tile& tile = registry.tiles.emplace(entity);
     tile.parent_id = entity.id();
     tile.offset = {0, 0};
-    tile.id = tile_id_array[tile_arr_index];
+    tile.id = tiles.at(position.x, position.y);
 
     registry.renderRequests.insert(entity, {
                 TEXTURE_ASSET_ID::TILE,
@@ -901,7 +878,12 @@ Entity create_pendulum(vec2 pivot_position, float length, float initial_angle, f
 
 Mesh* get_mesh_from_file(std::string filename) {
     Mesh* mesh = new Mesh();
-    Mesh::loadFromOBJFile(filename, mesh->vertices, mesh->vertex_indices, mesh->original_size);
+    if (!MeshCache::load(filename, *mesh)) {
+        fprintf(stderr, "Could not load the mesh %s.\n", filename.c_str());
+        assert(false);
+        delete mesh;
+        return nullptr;
+    }
     return mesh;
 }
 
@@ -914,6 +896,9 @@ Mesh* get_mesh(const std::string &filepath) {
     }
 
     Mesh* raw_mesh = get_mesh_from_file(data_path() + filepath);
+    if (raw_mesh == nullptr) {
+        return nullptr;
+    }
     mesh_cache[filepath] = std::unique_ptr<Mesh>(raw_mesh);
     return mesh_cache[filepath].get();
 }
@@ -983,6 +968,8 @@ Entity create_gear(vec2 position, vec2 size, bool fixed, float angular_velocity,
 
     // lil helper to add the tooth
     auto add_tooth = [&](Mesh* tooth_mesh, float angle_rad, bool flip = false) {
+        // a mesh that failed to load has no vertices to collide with
+        if (tooth_mesh == nullptr) return;
         SubMesh tooth = SubMesh{};
         tooth.original_mesh = tooth_mesh;
         tooth.scale_ratio = {GEAR_TOOTH_WIDTH_RATIO, GEAR_TOOTH_HEIGHT_RATIO};
@@ -1068,6 +1055,7 @@ Entity create_spikeball(vec2 position, vec2 size) {
     float angle_diff =  360.0f / num_spikes;
 
     auto add_spike = [&](Mesh* spike_mesh, float angle_deg, float scale_ratio, bool flip = false) {
+        if (spike_mesh == nullptr) return;
         SubMesh spike = SubMesh{};
         spike.original_mesh = spike_mesh;
         spike.scale_ratio = vec2{SPIKE_WIDTH_RATIO, SPIKE_HEIGHT_RATIO};
@@ -1168,16 +1156,17 @@ Entity create_rolling_thing(vec2 position, vec2 scale) {
 }
 
 Entity create_rolling_platform(vec2 position, vec2 scale, float y_velocity) {
-    Entity entity = Entity();
-    Motion& motion = registry.motions.emplace(entity);
+    Entity entity = EntityPools::acquire(ENTITY_POOL_ID::ROLLING_PLATFORM);
+    Motion& motion = reuse_component(registry.motions, entity);
     motion.position = position;
     motion.scale = scale;
     motion.velocity = {0, y_velocity};
     motion.angle = 0;
 
-    registry.platforms.emplace(entity);
+    reuse_component(registry.platforms, entity);
+    reuse_component(registry.rollingPlatforms, entity);
 
-    PhysicsObject& physics_object = registry.physicsObjects.emplace(entity);
+    PhysicsObject& physics_object = reuse_component(registry.physicsObjects, entity);
     physics_object.apply_gravity = false;
     physics_object.drag_coefficient = 0.0f;
     physics_object.apply_air_resistance = false;
@@ -1185,7 +1174,7 @@ Entity create_rolling_platform(vec2 position, vec2 scale, float y_velocity) {
     physics_object.mass = 0.0f;
     physics_object.ignore_bottom_collision = true;
 
-    TimeControllable& tc = registry.timeControllables.emplace(entity);
+    TimeControllable& tc = reuse_component(registry.timeControllables, entity);
     tc.can_be_accelerated = true;
     tc.can_be_decelerated = true;
 
@@ -1270,12 +1259,6 @@ float getDistance(const Motion& one, const Motion& other) {
     return glm::length(one.position - other.position);
 }
 
-int get_tile_index(int pos_x, int pos_y, int offset_x, int offset_y, int stride) {
-    int tile_coord_y = (pos_y / TILE_TO_PIXELS) + offset_y;
-    int tile_coord_x = (pos_x / TILE_TO_PIXELS) + offset_x;
-    return tile_coord_x + tile_coord_y * stride;
-}
-
 
 Entity create_outro_cutscene() {
     Entity entity = Entity();
@@ -5,13 +5,104 @@
 #include "../../common.hpp"
 #include "../../tinyECS/component_container.hpp"
 #include "tinyECS/components.hpp"
+#include "../../tinyECS/registry.hpp"
 #include "systems/rendering/render_system.hpp"
+#include "systems/parser/level_format.hpp"
 
 
 using namespace nlohmann;
 
 inline std::unordered_map<std::string, std::unique_ptr<Mesh>> mesh_cache;
 
+// The components of the level's plain colliders and markers. Each is added through a sink,
+// sink.add(container) returning the new component: EntitySink emplaces it into the registry right
+// away, LevelBatch keeps it off the registry so batches can be built on worker threads. Either way
+// the create_ functions and level loading make the same set of components.
+struct EntitySink {
+    Entity entity;
+
+    template <typename Component>
+    Component& add(ComponentContainer<Component>& container) {
+        return container.emplace(entity);
+    }
+};
+
+template <typename Sink>
+void static_collider_components(Sink& sink, vec2 position, vec2 scale) {
+    sink.add(registry.platforms);
+
+    Motion& motion = sink.add(registry.motions);
+    motion.position = position;
+    motion.scale = scale;
+    motion.velocity = {0, 0};
+    motion.angle = 0;
+
+    PhysicsObject& physics_object = sink.add(registry.physicsObjects);
+    physics_object.apply_gravity = false;
+    physics_object.mass = 0.0f;
+    physics_object.apply_rotation = false;
+    physics_object.friction = 0.25;
+}
+
+template <typename Sink>
+void level_boundary_components(Sink& sink, vec2 position, vec2 scale) {
+    sink.add(registry.platforms);
+
+    PhysicsObject& physics_object = sink.add(registry.physicsObjects);
+    physics_object.apply_gravity = false;
+    physics_object.apply_rotation = false;
+    physics_object.mass = 0.0f;
+    physics_object.friction = 0.5;
+
+    Motion& motion = sink.add(registry.motions);
+    motion.position = position;
+    motion.scale = scale;
+    motion.velocity = {0, 0};
+    motion.angle = 0;
+}
+
+template <typename Sink>
+void spike_collider_components(Sink& sink, vec2 position, vec2 scale) {
+    sink.add(registry.spikes);
+
+    Motion& motion = sink.add(registry.motions);
+    motion.position = position;
+    motion.scale = scale;
+    motion.velocity = {0, 0};
+    motion.angle = 0.f;
+
+    sink.add(registry.nonPhysicsColliders);
+}
+
+template <typename Sink>
+void clock_hole_components(Sink& sink, vec2 position, vec2 scale) {
+    Motion& motion = sink.add(registry.motions);
+    motion.position = position;
+    motion.scale = scale;
+    motion.velocity = {0, 0};
+    motion.angle = 0;
+
+    sink.add(registry.nonPhysicsColliders);
+    sink.add(registry.clockHoles);
+}
+
+template <typename Sink>
+void spawnpoint_components(Sink& sink, vec2 pos, vec2 size) {
+    sink.add(registry.spawnPoints);
+
+    Motion& motion = sink.add(registry.motions);
+    motion.position = pos;
+    motion.scale = size;
+
+    sink.add(registry.renderRequests) = {
+        TEXTURE_ASSET_ID::SPAWNPOINT_UNVISITED,
+        EFFECT_ASSET_ID::TEXTURED,
+        GEOMETRY_BUFFER_ID::SPRITE
+    };
+
+    sink.add(registry.layers) = { LAYER_ID::MIDGROUND };
+}
+
 // Creation methods
 Entity create_player(vec2 position, vec2 scale);
 Entity create_deceleration_bar(vec2 position);
@@ -21,25 +112,35 @@ Entity create_background(vec2 scene_dimensions, TEXTURE_ASSET_ID texture_id);
 Entity create_parallaxbackground(vec2 scene_dimensions, TEXTURE_ASSET_ID texture_id);
 Entity create_foreground(vec2 scene_dimensions, TEXTURE_ASSET_ID texture_id);
 Entity create_levelground(vec2 scene_dimensions, TEXTURE_ASSET_ID texture_id);
-Entity create_static_platform(vec2 position, vec2 scale, json& tile_id_array, int stride, bool rounded);
+Entity create_static_platform(vec2 position, vec2 scale, const LevelTiles& tiles, bool rounded);
+// a static platform split in two: its tiles, and a tileless box that may cover several platforms
+Entity create_platform_tiles(vec2 position, vec2 scale, const LevelTiles& tiles);
+// the same with the tile ids looked up already, one per platform_tile_count()
+Entity create_platform_tiles(vec2 position, vec2 scale, const int* tile_ids);
+int platform_tile_count(vec2 scale);
+// does not touch the registry, so it may run off the main thread
+int platform_tile_id(vec2 position, vec2 scale, const LevelTiles& tiles, int index);
+Entity create_static_collider(vec2 position, vec2 scale);
 Entity create_rolling_platform(vec2 position, vec2 scale, float y_velocity);
 Entity create_level_boundary(vec2 position, vec2 scale);
 Entity create_world_boundary(vec2 position, vec2 scale);
 Entity create_clock_hole(vec2 position, vec2 scale);
-Entity create_moving_platform(vec2 scale, std::vector<Path> movements, vec2 initial_position, json& tile_id_array, int stride, bool rounded);
+Entity create_moving_platform(vec2 scale, std::vector<Path> movements, vec2 initial_position, const LevelTiles& tiles, bool rounded);
 Entity create_projectile(vec2 pos, vec2 size, vec2 velocity, bool delayed = false);
 Entity create_bolt(vec2 pos, vec2 size, vec2 velocity, bool default_gravity, bool harmful);
 Entity create_first_boss_test();
 Entity create_spawnpoint(vec2 pos, vec2 size);
-Entity create_spike(vec2 position, vec2 scale, json tile_id_array, int stride);
-Entity create_ladder(vec2 position, vec2 scale, int height, json tile_id_array, int stride);
-Entity create_partof(vec2 position, vec2 scale, json tile_id_array, int stride);
-Entity create_breakable_static_platform(vec2 position, vec2 scale, bool should_break_instantly, float degrade_speed, bool is_time_controllable, json& tile_id_array, int stride);
-Entity create_time_controllable_breakable_static_platform(vec2 position, vec2 scale, bool should_break_instantly, float degrade_speed, json& tile_id_array, int stride);
+Entity create_spike(vec2 position, vec2 scale, const LevelTiles& tiles);
+// a tileless spike box that may cover a run of spikes drawn as part-ofs
+Entity create_spike_collider(vec2 position, vec2 scale);
+Entity create_ladder(vec2 position, vec2 scale, int height, const LevelTiles& tiles);
+Entity create_partof(vec2 position, vec2 scale, int tile_id);
+Entity create_breakable_static_platform(vec2 position, vec2 scale, bool should_break_instantly, float degrade_speed, bool is_time_controllable);
+Entity create_time_controllable_breakable_static_platform(vec2 position, vec2 scale, bool should_break_instantly, float degrade_speed);
 Entity create_cannon_tower(vec2 pos);
 Entity create_tutorial_text(vec2 position, vec2 size, TEXTURE_ASSET_ID texture_id);
-Entity create_door(vec2 position, bool open, json& tile_id_array, int stride);
-Entity create_pipe_head(vec2 position, vec2 scale, std::string direction, json& tile_id_array, int stride, float time_offset = 0.0f);
+Entity create_door(vec2 position, bool open, const LevelTiles& tiles);
+Entity create_pipe_head(vec2 position, vec2 scale, std::string direction, const LevelTiles& tiles, float time_offset = 0.0f);
 Entity create_chain(vec2 position, vec2 scale);
 Entity create_pendulum(vec2 pivot_position, float length, float initial_angle, float bob_radius);
 Entity create_gear(vec2 position, vec2 size, bool fixed, float angular_velocity, float inital_angle);
@@ -55,4 +156,3 @@ Entity create_rolling_thing(vec2 position, vec2 scale);
 // Helper methods
 void remove_menu_screen();
 float getDistance(const Motion& one, const Motion& other);
-int get_tile_index(int pos_x, int pos_y, int offset_x, int offset_y, int stride);
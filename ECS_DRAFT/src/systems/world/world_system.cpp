@@ -1,5 +1,6 @@
 // Header
 #include "world_system.hpp"
+#include "entity_pool.hpp"
 
 #include "systems/animation/animation_system.hpp"
 
@@ -112,6 +113,7 @@ void WorldSystem::step(float elapsed_ms_since_last_update) {
 	// TODO: prob don't need to loop any frame, only when transitions are taking place...
 	for (int i = 0; i < registry.timeControllables.size(); i++) {
 		const Entity entity = registry.timeControllables.entities[i];
+		if (!is_active(entity)) continue;
 		
 		TimeControllable& tc = registry.timeControllables.components[i];
 		Motion& motion = registry.motions.get(entity);
@@ -163,10 +165,10 @@ void WorldSystem::restart_game() {
 	// All that have a motion, we could also iterate over all bug, eagles, ... but that would be more cumbersome
 	while (registry.motions.entities.size() > 0)
 		registry.remove_all_components_of(registry.motions.entities.back());
+	EntityPools::clear();
 
 	// Remove all particles
-	while (registry.particles.entities.size() > 0)
-		registry.remove_all_components_of(registry.particles.entities.back());
+	ParticleSystem::clear_particles();
 
 	// debugging for memory/component leaks
 	registry.list_all_components();
@@ -113,6 +113,7 @@ void WorldSystem::generate_deceleration_particle()
 		float size_factor = (0.8f + 0.25f * rand_float());
 		vec2 sampled_position = random_sample_rectangle(registry.motions.get(registry.cameras.entities[0]).position, vec2{ WINDOW_WIDTH_PX, WINDOW_HEIGHT_PX });
 
+		ParticleEffectScope particle_effect(PARTICLE_EFFECT_ID::DECELERATION);
 		ParticleSystem::spawn_particle(vec3{ 0.89f, 0.96f, 1.0f },
 			sampled_position,
 			0.0f, vec2(5.0f)* size_factor, vec2{ 0.0f, -50.0f }, 700.0, 0.7f, { 300.0f, 300.0f }, {0.0, 600.0});
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 #include <set>
@@ -25,9 +26,56 @@ template <typename Component> // A component can be any class
 class ComponentContainer : public ContainerInterface
 {
 private:
-	// The hash map from Entity -> array index.
-	std::unordered_map<unsigned int, unsigned int> map_entity_componentID; // the entity is cast to uint to be hashable.
+	// Entity id -> array index, as a paged sparse array: a lookup is two loads instead of a hash,
+	// and pages are only allocated for id ranges that hold components of this type
+	static const unsigned int PAGE_BITS = 10;
+	static const unsigned int PAGE_SIZE = 1u << PAGE_BITS;
+	static const unsigned int NO_COMPONENT = ~0u;
+
+	struct Page {
+		unsigned int indices[PAGE_SIZE];
+		unsigned int count = 0;
+	};
+	std::vector<std::unique_ptr<Page>> pages;
 	bool registered = false;
+
+	unsigned int index_of(unsigned int id) const {
+		const unsigned int page = id >> PAGE_BITS;
+		if (page >= pages.size() || !pages[page]) {
+			return NO_COMPONENT;
+		}
+		return pages[page]->indices[id & (PAGE_SIZE - 1)];
+	}
+
+	Page& page_of(unsigned int id) {
+		const unsigned int page = id >> PAGE_BITS;
+		if (page >= pages.size()) {
+			pages.resize(page + 1);
+		}
+		if (!pages[page]) {
+			pages[page] = std::make_unique<Page>();
+			std::fill(std::begin(pages[page]->indices), std::end(pages[page]->indices), NO_COMPONENT);
+		}
+		return *pages[page];
+	}
+
+	void set_index(unsigned int id, unsigned int index) {
+		Page& page = page_of(id);
+		unsigned int& slot = page.indices[id & (PAGE_SIZE - 1)];
+		if (slot == NO_COMPONENT) {
+			page.count++;
+		}
+		slot = index;
+	}
+
+	void clear_index(unsigned int id) {
+		const unsigned int page = id >> PAGE_BITS;
+		pages[page]->indices[id & (PAGE_SIZE - 1)] = NO_COMPONENT;
+		if (--pages[page]->count == 0) {
+			pages[page].reset();
+		}
+	}
+
 public:
 	// Container of all components of type 'Component'
 	std::vector<Component> components;
@@ -46,7 +94,7 @@ public:
 		// Usually, every entity should only have one instance of each component type
 		assert(!(check_for_duplicates && has(e)) && "Entity already contained in ECS registry");
 
-		map_entity_componentID[e] = (unsigned int)components.size();
+		set_index(e.id(), (unsigned int)components.size());
 		components.push_back(std::move(c)); // the move enforces move instead of copy constructor
 		entities.push_back(e);
 		return components.back();
@@ -62,26 +110,64 @@ public:
 		return insert(e, Component(std::forward<Args>(args)...), false);
 	};
 
+	// Gives copies of c to the count entities with consecutive ids from first_id (see Entity::create_range)
+	// and returns the first of them; the rest follow it in components
+	Component* insert_range(unsigned int first_id, unsigned int count, const Component& c)
+	{
+		const size_t first_index = components.size();
+		reserve(count);
+		components.insert(components.end(), count, c);
+		for (unsigned int i = 0; i < count; i++) {
+			assert(!has(first_id + i) && "Entity already contained in ECS registry");
+			entities.push_back(Entity(first_id + i));
+			set_index(first_id + i, (unsigned int)(first_index + i));
+		}
+		return count > 0 ? &components[first_index] : nullptr;
+	}
+
+	// Moves values[i] to the entity ids[i], for components built in bulk away from the registry
+	void insert_range(const unsigned int* ids, Component* values, unsigned int count)
+	{
+		reserve(count);
+		for (unsigned int i = 0; i < count; i++) {
+			assert(!has(ids[i]) && "Entity already contained in ECS registry");
+			set_index(ids[i], (unsigned int)components.size());
+			components.push_back(std::move(values[i]));
+			entities.push_back(Entity(ids[i]));
+		}
+	}
+
+	// Makes room for count more components, growing geometrically
+	void reserve(size_t count)
+	{
+		const size_t needed = components.size() + count;
+		if (needed > components.capacity()) {
+			const size_t capacity = std::max(needed, components.capacity() * 2);
+			components.reserve(capacity);
+			entities.reserve(capacity);
+		}
+	}
+
 	// A wrapper to return the component of an entity
 	Component& get(Entity e) {
 		assert(has(e) && "Entity not contained in ECS registry");
-		return components[map_entity_componentID[e]];
+		return components[index_of(e.id())];
 	}
 
 	// overloaded to take in entity id
 	Component& get(unsigned int id) {
 		assert(has(id) && "Entity not contained in ECS registry");
-		return components[map_entity_componentID[id]];
+		return components[index_of(id)];
 	}
 
 	// Check if entity has a component of type 'Component'
 	bool has(Entity entity) {
-		return map_entity_componentID.count(entity) > 0;
+		return index_of(entity.id()) != NO_COMPONENT;
 	}
 
 	// overloaded to take in entity id
 	bool has(unsigned int id) {
-		return map_entity_componentID.count(id) > 0;
+		return index_of(id) != NO_COMPONENT;
 	}
 
 	// Remove an component and pack the container to re-use the empty space
@@ -90,16 +176,16 @@ public:
 		if (has(e))
 		{
 			// Get the current position
-			int cID = map_entity_componentID[e];
+			unsigned int cID = index_of(e.id());
 
 			// Move the last element to position cID using the move operator
 			// Note, components[cID] = components.back() would trigger the copy instead of move operator
 			components[cID] = std::move(components.back());
 			entities[cID] = entities.back(); // the entity is only a single index, copy it.
-			map_entity_componentID[entities.back()] = cID;
+			set_index(entities.back().id(), cID);
 
 			// Erase the old component and free its memory
-			map_entity_componentID.erase(e);
+			clear_index(e.id());
 			components.pop_back();
 			entities.pop_back();
 			// Note, one could mark the id for re-use
@@ -109,7 +195,7 @@ public:
 	// Remove all components of type 'Component'
 	void clear()
 	{
-		map_entity_componentID.clear();
+		pages.clear();
 		components.clear();
 		entities.clear();
 	}
@@ -128,10 +214,10 @@ public:
 		std::sort(entities.begin(), entities.end(), comparisonFunction);
 		// Now re-arrange the components (Note, creates a new vector, which may be slow! Not sure if in-place could be faster: https://stackoverflow.com/questions/63703637/how-to-efficiently-permute-an-array-in-place-using-stdswap)
 		std::vector<Component> components_new; components_new.reserve(components.size());
-		std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(get(e)); }); // note, the get still uses the old hash map (on purpose!)
+		std::transform(entities.begin(), entities.end(), std::back_inserter(components_new), [&](Entity e) { return std::move(get(e)); }); // note, the get still uses the old indices (on purpose!)
 		components = std::move(components_new); // note, we use move operations to not create unneccesary copies of objects, but memory is still allocated for the new vector
-		// Fill the new hashmap
+		// Fill the new indices
 		for (unsigned int i = 0; i < entities.size(); i++)
-			map_entity_componentID[entities[i]] = i;
+			set_index(entities[i].id(), i);
 	}
 };
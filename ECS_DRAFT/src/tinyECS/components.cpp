@@ -5,113 +5,144 @@
 #include "../../ext/stb_image/stb_image.h"
 
 // stlib
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
 Debug debugging;
 float death_timer_counter_ms = 3000;
 
-// Very, VERY simple OBJ loader from https://github.com/opengl-tutorials/ogl tutorial 7
-// (modified to also read vertex color and omit uv and normals)
-bool Mesh::loadFromOBJFile(std::string obj_path, std::vector<ColoredVertex>& out_vertices, std::vector<uint16_t>& out_vertex_indices, vec2& out_size)
+namespace {
+	// Longest OBJ line the loader accepts; the exported meshes stay well below it
+	const size_t OBJ_LINE_LIMIT = 256;
+
+	// Reads one face corner (v, v/t, v//n or v/t/n); only the position and uv indices are kept
+	bool parse_face_corner(const char*& cursor, int& vertex_index, int& uv_index)
+	{
+		char* end;
+		vertex_index = (int)strtol(cursor, &end, 10);
+		if (end == cursor) {
+			return false;
+		}
+		cursor = end;
+		uv_index = 0;
+		if (*cursor == '/') {
+			cursor++;
+			if (*cursor != '/') {
+				uv_index = (int)strtol(cursor, &end, 10);
+				cursor = end;
+			}
+			if (*cursor == '/') {
+				strtol(cursor + 1, &end, 10);
+				cursor = end;
+			}
+		}
+		return true;
+	}
+}
+
+// Simple OBJ loader, started from https://github.com/opengl-tutorials/ogl tutorial 7 (reads vertex color and
+// uv, omits normals). Single pass over the text: each line is copied to a stack buffer and read with
+// strtof/strtol, and faces with more than three corners are split into a fan.
+bool Mesh::loadFromOBJData(const char* data, size_t size, std::vector<ColoredVertex>& out_vertices, std::vector<uint16_t>& out_vertex_indices, vec2& out_size)
 {
-	// disable warnings about fscanf and fopen on Windows
-#ifdef _MSC_VER
-#pragma warning(disable:4996)
-#endif
-
-	printf("Loading OBJ file %s...\n", obj_path.c_str());
-	// Note, normal and UV indices are not loaded/used, but code is commented to do so
-	std::vector<uint16_t> out_uv_indices, out_normal_indices;
 	std::vector<glm::vec2> out_uvs;
-	std::vector<glm::vec3> out_normals;
+	const char* const data_end = data + size;
+	char line[OBJ_LINE_LIMIT];
 
-	FILE* file = fopen(obj_path.c_str(), "r");
-	if (file == NULL) {
-		printf("Impossible to open the file ! Are you in the right path ? See Tutorial 1 for details\n");
-		getchar();
-		return false;
-	}
+	for (const char* line_start = data; line_start < data_end; ) {
+		const char* line_end = (const char*)memchr(line_start, '\n', data_end - line_start);
+		if (line_end == nullptr) {
+			line_end = data_end;
+		}
+		const size_t length = line_end - line_start;
+		const bool fits = length < OBJ_LINE_LIMIT;
+		memcpy(line, line_start, fits ? length : 0);
+		line[fits ? length : 0] = '\0';
+		line_start = line_end + 1;
+
+		const char* cursor = line;
+		while (*cursor == ' ' || *cursor == '\t') {
+			cursor++;
+		}
+		const bool is_vertex = cursor[0] == 'v' && (cursor[1] == ' ' || cursor[1] == '\t');
+		const bool is_uv = cursor[0] == 'v' && cursor[1] == 't' && (cursor[2] == ' ' || cursor[2] == '\t');
+		const bool is_face = cursor[0] == 'f' && (cursor[1] == ' ' || cursor[1] == '\t');
+		if (!fits && (is_vertex || is_uv || is_face)) {
+			printf("OBJ line longer than %d characters\n", (int)OBJ_LINE_LIMIT);
+			return false;
+		}
 
-	while (1) {
-		char lineHeader[128];
-		// read the first word of the line
-		int res = fscanf(file, "%s", lineHeader);
-		if (res == EOF)
-			break; // EOF = End Of File. Quit the loop.
-		
-		if (strcmp(lineHeader, "v") == 0) {
-			ColoredVertex vertex;
-			int matches = fscanf(file, "%f %f %f %f %f %f\n", &vertex.position.x, &vertex.position.y, &vertex.position.z,
-				&vertex.color.x, &vertex.color.y, &vertex.color.z);
-			if (matches == 3)
-				vertex.color = { 1,1,1 };
+		// comments, normals, groups and materials are not used
+		if (is_vertex) {
+			cursor += 1;
+			float values[6] = { 0, 0, 0, 1, 1, 1 };
+			int matches = 0;
+			for (char* end; matches < 6; matches++, cursor = end) {
+				values[matches] = strtof(cursor, &end);
+				if (end == cursor) {
+					break;
+				}
+			}
+			if (matches < 3) {
+				printf("OBJ vertex needs three coordinates\n");
+				return false;
+			}
+			if (matches < 6) {
+				values[3] = values[4] = values[5] = 1;
+			}
+			ColoredVertex vertex = {};
+			vertex.position = { values[0], values[1], values[2] };
+			vertex.color = { values[3], values[4], values[5] };
 			out_vertices.push_back(vertex);
 		}
-		else if (strcmp(lineHeader, "vt") == 0) {
+		else if (is_uv) {
+			char* end;
 			glm::vec2 uv;
-			fscanf(file, "%f %f\n", &uv.x, &uv.y);
+			uv.x = strtof(cursor + 2, &end);
+			uv.y = strtof(end, &end);
 			uv.y = -uv.y; // Invert V coordinate since we will only use DDS texture, which are inverted. Remove if you want to use TGA or BMP loaders.
 			out_uvs.push_back(uv);
 		}
-		else if (strcmp(lineHeader, "vn") == 0) {
-			glm::vec3 normal;
-			fscanf(file, "%f %f %f\n", &normal.x, &normal.y, &normal.z);
-			out_normals.push_back(normal);
-		}
-		else if (strcmp(lineHeader, "f") == 0) {
-			std::string vertex1, vertex2, vertex3;
-			unsigned int vertexIndex[3], normalIndex[3], uvIndex[3];
-
-			int matches = fscanf(file, "%d %d %d\n", &vertexIndex[0], &vertexIndex[1], &vertexIndex[2]);
-			if (matches == 1) // try again
-			{
-				// Note first vertex index is already consumed by the first fscanf call (match ==1) since it aborts on the first error
-				matches = fscanf(file, "//%d %d//%d %d//%d\n", &normalIndex[0], &vertexIndex[1], &normalIndex[1], &vertexIndex[2], &normalIndex[2]);
-				if (matches != 5) // try again
-				{
-					matches = fscanf(file, "%d/%d %d/%d/%d %d/%d/%d\n", &uvIndex[0], &normalIndex[0], &vertexIndex[1], &uvIndex[1], &normalIndex[1], &vertexIndex[2], &uvIndex[2], &normalIndex[2]);
-					if (matches != 8)
-					{
-						printf("File can't be read by our simple parser :-( Try exporting with other options\n");
-						fclose(file);
-						return false;
-					}
+		else if (is_face) {
+			cursor += 1;
+			int first = 0, previous = 0, corners = 0;
+			int corner_vertex, corner_uv;
+			while (parse_face_corner(cursor, corner_vertex, corner_uv)) {
+				// -1 since .obj starts counting at 1 and OpenGL starts at 0
+				const int vertex_index = corner_vertex - 1;
+				const int uv_index = corner_uv - 1;
+				if (vertex_index < 0 || vertex_index >= (int)out_vertices.size()) {
+					printf("OBJ face refers to a missing vertex\n");
+					return false;
+				}
+				if (uv_index >= 0 && uv_index < (int)out_uvs.size()) {
+					out_vertices[vertex_index].uv = out_uvs[uv_index];
 				}
-			}
-
-
-			if (out_uvs.size() > 0) {
-				for (int i = 0; i < 3; i++) {
-					int vIdx = vertexIndex[i] - 1;
-					int uvIdx = uvIndex[i] - 1;
 
-					if (vIdx >= 0 && uvIdx >= 0) {
-						out_vertices[vIdx].uv = out_uvs[uvIdx]; // Assign UV to the correct vertex
-					}
+				if (corners >= 2) {
+					out_vertex_indices.push_back((uint16_t)first);
+					out_vertex_indices.push_back((uint16_t)previous);
+					out_vertex_indices.push_back((uint16_t)vertex_index);
 				}
+				if (corners == 0) {
+					first = vertex_index;
+				}
+				previous = vertex_index;
+				corners++;
+			}
+			if (corners < 3) {
+				printf("File can't be read by our simple parser :-( Try exporting with other options\n");
+				return false;
 			}
-
-
-			// -1 since .obj starts counting at 1 and OpenGL starts at 0
-			out_vertex_indices.push_back((uint16_t)vertexIndex[0] - 1);
-			out_vertex_indices.push_back((uint16_t)vertexIndex[1] - 1);
-			out_vertex_indices.push_back((uint16_t)vertexIndex[2] - 1);
-			out_uv_indices.push_back(uvIndex[0] - 1);
-			out_uv_indices.push_back(uvIndex[1] - 1);
-			out_uv_indices.push_back(uvIndex[2] - 1);
-			out_normal_indices.push_back((uint16_t)normalIndex[0] - 1);
-			out_normal_indices.push_back((uint16_t)normalIndex[1] - 1);
-			out_normal_indices.push_back((uint16_t)normalIndex[2] - 1);
-		}
-		else {
-			// Probably a comment, eat up the rest of the line
-			char stupidBuffer[1000];
-			fgets(stupidBuffer, 1000, file);
 		}
+	}
 
+	if (out_vertices.empty()) {
+		printf("OBJ file has no vertices\n");
+		return false;
 	}
-	fclose(file);
 
 	if (out_vertices[0].position.y == 0)
 	{
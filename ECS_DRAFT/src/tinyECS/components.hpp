@@ -1,5 +1,6 @@
 #pragma once
 #include "common.hpp"
+#include <array>
 #include <vector>
 #include <chrono>
 
@@ -246,6 +247,7 @@ struct ObstacleSpawner {
 	vec2 end_position;
 	vec2 size;
 	unsigned int obstacle_id = 0;
+	unsigned int parked_obstacle_id = 0;	// previous obstacle, deactivated for reuse
 	std::string obstacle_type;
 
 	float time_left_ms = 10000.0f;
@@ -365,7 +367,8 @@ struct TexturedVertex
 // Mesh datastructure for storing vertex and index buffers
 struct Mesh
 {
-	static bool loadFromOBJFile(std::string obj_path, std::vector<ColoredVertex>& out_vertices, std::vector<uint16_t>& out_vertex_indices, vec2& out_size);
+	// Parses OBJ text already in memory, such as a mapped file
+	static bool loadFromOBJData(const char* data, size_t size, std::vector<ColoredVertex>& out_vertices, std::vector<uint16_t>& out_vertex_indices, vec2& out_size);
 	vec2 original_size = {1,1};
 	std::vector<ColoredVertex> vertices;
 	std::vector<uint16_t> vertex_indices;
@@ -471,6 +474,30 @@ struct Screw {
 	float timer = SCREW_LIFE_MS;
 };
 
+// Kinds of short-lived entities that are recycled instead of rebuilt
+enum class ENTITY_POOL_ID {
+	SCREW = 0,
+	CANNON_BOLT = SCREW + 1,
+	PROJECTILE = CANNON_BOLT + 1,
+	DELAYED_PROJECTILE = PROJECTILE + 1,
+	BOLT = DELAYED_PROJECTILE + 1,
+	HARMFUL_BOLT = BOLT + 1,
+	ROLLING_PLATFORM = HARMFUL_BOLT + 1,
+	ENTITY_POOL_COUNT = ROLLING_PLATFORM + 1
+};
+
+const int entity_pool_count = (int)ENTITY_POOL_ID::ENTITY_POOL_COUNT;
+
+// A struct indicating which pool an entity goes back to when it is destroyed
+struct Pooled {
+	ENTITY_POOL_ID pool;
+	unsigned int owner = 0;	// entity that spawned it, if it goes away with it
+};
+
+// A struct indicating that an entity is parked: physics, collisions and rendering skip it
+struct Inactive {
+};
+
 // A struct indicating that an entity is breakable
 struct Breakable
 {
@@ -509,12 +536,33 @@ struct SnoozeButton
 };
 
 struct RollingPlatform {
-	int frames_left;
+
 };
 
 struct RollingThing {
 	int current_frame;
-	std::vector<unsigned int> platforms;
+	// frames stepped through so far, the clock platform expiry is measured in
+	int frames_stepped = 0;
+
+	// live platforms, oldest first; they all last ROLLING_PLATFORM_FRAMES_ALIVE frames, so they expire
+	// from the front of the ring
+	struct LivePlatform {
+		unsigned int platform;
+		int expires_at;
+	};
+	std::array<LivePlatform, ROLLING_PLATFORM_RING_SIZE> platforms;
+	int first_platform = 0;
+	int platform_count = 0;
+};
+
+// Platforms the rolling things drop on each frame of their sequence, flattened at load from
+// data/rolling_thing_platforms.json: the x offsets of frame f are spawn_x[frame_start[f]] up to
+// spawn_x[frame_start[f + 1]]
+struct RollingThingTimeline {
+	std::vector<uint32_t> frame_start;
+	std::vector<float> spawn_x;
+
+	uint32_t frame_count() const { return frame_start.empty() ? 0 : (uint32_t)frame_start.size() - 1; }
 };
 
 // struct BossAttack
@@ -869,7 +917,9 @@ enum class FRAME_BUFFER_ID {
 enum class BLUR_MODE {
 	TWO_D = 0,
 	HORIZONTAL = TWO_D + 1,
-	VERTICAL = HORIZONTAL + 1
+	VERTICAL = HORIZONTAL + 1,
+	KAWASE_DOWN = VERTICAL + 1,
+	KAWASE_UP = KAWASE_DOWN + 1
 };
 
 struct Layer {
@@ -924,29 +974,24 @@ enum class PARTICLE_ID {
 
 const int particle_type_count = (int)PARTICLE_ID::PARTICLE_TYPE_COUNT;
 
-struct Particle {
-	PARTICLE_ID particle_id;
-
-	// Motion properties are isolated from Physics system to avoid sub-stepping particles
-	vec2 position;
-	float angle;
-	vec2 scale;
-	vec2 velocity;
-	float ang_velocity = 0.0;
-
-	float life;
-	float timer = 0.0;
-	float alpha = 1.0;
-	vec2 fade_in_out = { 0.0, 0.0 };
-	vec2 shrink_in_out = { 0.0, 0.0 };
-
-	// Wind -> constant addition to velocity
-	// Gravity -> contant acceleration
-	// Turbulence -> randomized acceleration
-	float wind_influence = 0.0;
-	float gravity_influence = 0.0;
-	float turbulence_influence = 0.0;
-};
+// Gameplay effect a particle was spawned for; drives spawn priority, LOD and telemetry
+enum class PARTICLE_EFFECT_ID {
+	AMBIENT = 0,
+	PLAYER_TRAIL = AMBIENT + 1,
+	PLAYER_FEEDBACK = PLAYER_TRAIL + 1,
+	DECELERATION = PLAYER_FEEDBACK + 1,
+	SPAWNPOINT = DECELERATION + 1,
+	IMPACT = SPAWNPOINT + 1,
+	CANNON_FIRE = IMPACT + 1,
+	HAZARD_WARNING = CANNON_FIRE + 1,
+	CRACKS = HAZARD_WARNING + 1,
+	BOSS_AURA = CRACKS + 1,
+	BOSS_TELEGRAPH = BOSS_AURA + 1,
+	BOSS_DAMAGE = BOSS_TELEGRAPH + 1,
+	PARTICLE_EFFECT_COUNT = BOSS_DAMAGE + 1
+};
+
+const int particle_effect_count = (int)PARTICLE_EFFECT_ID::PARTICLE_EFFECT_COUNT;
 
 struct ParticleSystemState {
 	vec2 wind_field = { 0.0, 0.0 };
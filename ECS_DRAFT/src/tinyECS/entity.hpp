@@ -19,6 +19,14 @@ public:
         m_id = id;
     }
 
+    // Reserves count consecutive ids and returns the first, for bulk instantiation
+    static unsigned int create_range(unsigned int count)
+    {
+        const unsigned int first_id = id_count;
+        id_count += count;
+        return first_id;
+    }
+
     // Entity(Entity& e)
     // {
     //     m_id = e.m_id;
@@ -61,14 +61,13 @@ public:
 	ComponentContainer<SnoozeButton> snoozeButtons;
 	ComponentContainer<Door> doors;
 	ComponentContainer<Pipe> pipes;
-	ComponentContainer<Particle> particles;
 	ComponentContainer<ParticleSystemState> particleSystemStates;
 	ComponentContainer<ObstacleSpawner>	obstacleSpawners;
 	ComponentContainer<Screw> screws;
 	ComponentContainer<RollingThing> rollingThings;
 	ComponentContainer<RollingPlatform> rollingPlatforms;
 
-	std::unordered_map<std::string, std::vector<int>> rolling_thing_data;
+	RollingThingTimeline rolling_thing_timeline;
 	ComponentContainer<DecelerationBar> decelerationBars;
 	ComponentContainer<HaloRequest> haloRequests;
 	ComponentContainer<LoadingScreen> loadingScreens;
@@ -77,6 +76,8 @@ public:
 	ComponentContainer<BossHealthBar> bossHealthBars;
 	ComponentContainer<CutScene> cutScenes;
 	ComponentContainer<ClockHole> clockHoles;
+	ComponentContainer<Pooled> pooleds;
+	ComponentContainer<Inactive> inactives;
 
 	// constructor that adds all containers for looping over them
 	ECSRegistry()
@@ -130,7 +131,6 @@ public:
 		registry_list.push_back(&snoozeButtons);
 		registry_list.push_back(&doors);
 		registry_list.push_back(&pipes);
-		registry_list.push_back(&particles);
 		registry_list.push_back(&particleSystemStates);
 		registry_list.push_back(&obstacleSpawners);
 		registry_list.push_back(&screws);
@@ -144,6 +144,8 @@ public:
 		registry_list.push_back(&bossHealthBars);
 		registry_list.push_back(&cutScenes);
 		registry_list.push_back(&clockHoles);
+		registry_list.push_back(&pooleds);
+		registry_list.push_back(&inactives);
 	}
 
 	void clear_all_components() {
@@ -0,0 +1,84 @@
+#include "worker_pool.hpp"
+
+void WorkerPool::start(int thread_count)
+{
+	stop();
+	stopping = false;
+	for (int i = 1; i < thread_count; i++) {
+		workers.emplace_back(&WorkerPool::workerLoop, this);
+	}
+}
+
+void WorkerPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	work_ready.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+}
+
+void WorkerPool::run(int job_count, const std::function<void(int)>& job)
+{
+	if (job_count <= 0) {
+		return;
+	}
+
+	if (workers.empty() || job_count == 1) {
+		for (int i = 0; i < job_count; i++) {
+			job(i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		current_job = &job;
+		this->job_count = job_count;
+		next_job = 0;
+		busy_workers = (int)workers.size();
+		generation++;
+	}
+	work_ready.notify_all();
+
+	runJobs();
+
+	// job must outlive every worker that may still be looking at it
+	std::unique_lock<std::mutex> lock(mutex);
+	work_done.wait(lock, [this]() { return busy_workers == 0; });
+	current_job = nullptr;
+}
+
+void WorkerPool::workerLoop()
+{
+	unsigned int seen_generation = 0;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			work_ready.wait(lock, [&]() { return stopping || generation != seen_generation; });
+			if (stopping) {
+				return;
+			}
+			seen_generation = generation;
+		}
+
+		runJobs();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			busy_workers--;
+		}
+		work_done.notify_one();
+	}
+}
+
+void WorkerPool::runJobs()
+{
+	for (int i = next_job++; i < job_count; i = next_job++) {
+		(*current_job)(i);
+	}
+}
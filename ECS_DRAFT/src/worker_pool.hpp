@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent threads for fork-join work inside a frame. run() hands out job indices
+// [0, job_count) to the workers and the calling thread, and returns once all of them are done;
+// which thread runs a job is unspecified, so jobs must only write to their own outputs.
+class WorkerPool {
+public:
+	WorkerPool() = default;
+	~WorkerPool() { stop(); }
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	// thread_count includes the caller of run(); 1 runs every job inline
+	void start(int thread_count);
+	void stop();
+
+	void run(int job_count, const std::function<void(int)>& job);
+
+	int threadCount() const { return (int)workers.size() + 1; }
+
+private:
+	void workerLoop();
+	void runJobs();
+
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable work_ready;
+	std::condition_variable work_done;
+	unsigned int generation = 0;	// bumped per run() so sleeping workers notice new work
+	int busy_workers = 0;
+	bool stopping = false;
+
+	const std::function<void(int)>* current_job = nullptr;
+	int job_count = 0;
+	std::atomic<int> next_job{ 0 };
+};